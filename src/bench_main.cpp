@@ -0,0 +1,460 @@
+// bench_main.cpp
+//
+// mut_bench: micro and macro benchmarks for the editor core's hot paths.
+//
+//   mut_bench [--out results.json] [--file source.cpp] [--lines N] [--seed S]
+//             [--scale F] [--filter NAME]
+//
+// The input is a synthetic C++ file generated from a fixed seed (or --file),
+// so runs on different machines and days measure the same work.  Results
+// go to stdout (or --out) as JSON for trend tracking; a readable table is
+// printed to stderr.  --scale multiplies every iteration count.
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "editor/clang_indexer.h"
+#include "editor/syntax_highlighter.h"
+#include "editor/text_editor.h"
+#include "platform/trace.h"
+
+namespace fs = std::filesystem;
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+/*──────────────────────── input ────────────────────────*/
+
+// xorshift64*: the same sequence on every standard library, unlike the
+// <random> distributions.
+struct Rng {
+    std::uint64_t state;
+    std::uint64_t next()
+    {
+        state ^= state >> 12;
+        state ^= state << 25;
+        state ^= state >> 27;
+        return state * 0x2545F4914F6CDD1DULL;
+    }
+    int below(int n) { return static_cast<int>(next() % static_cast<std::uint64_t>(n)); }
+};
+
+// Roughly `lines` lines of plausible C++: includes, macros, namespaces,
+// classes with members, templates, functions with loops, strings, numbers
+// and comments, so every highlighter path is exercised.
+std::string generateSource(std::size_t lines, std::uint64_t seed)
+{
+    static const char* const kTypes[] = { "int", "float", "double", "std::string", "std::vector<int>", "size_t", "bool" };
+    static const char* const kWords[] = { "alpha", "beta", "gamma", "delta", "count", "index", "buffer", "node", "value", "cache" };
+    Rng rng{ seed ? seed : 1 };
+    auto word = [&] { return std::string(kWords[rng.below(10)]) + std::to_string(rng.below(100)); };
+    auto type = [&] { return std::string(kTypes[rng.below(7)]); };
+
+    std::string out = "#include <string>\n#include <vector>\n#include \"local_header.h\"\n\n#define MAX_ITEMS 1024\n#define SQUARE(x) ((x) * (x))\n\n";
+    std::size_t emitted = 7;
+    int unit = 0;
+    while (emitted < lines) {
+        std::ostringstream s;
+        const std::string cls = "Widget" + std::to_string(unit++);
+        s << "namespace mod" << unit % 17 << " {\n\n"
+          << "// " << cls << " keeps a few " << word() << " values around.\n"
+          << "template <typename T>\n"
+          << "class " << cls << " {\n"
+          << "public:\n";
+        const int members = 2 + rng.below(4);
+        for (int m = 0; m < members; ++m)
+            s << "    " << type() << " " << word() << "_ = " << rng.below(1000) << ";\n";
+        s << "\n    " << type() << " compute(const T& input, int limit) const\n    {\n"
+          << "        /* accumulate over the range */\n"
+          << "        double total = 0.0;\n"
+          << "        for (int i = 0; i < limit && i < MAX_ITEMS; ++i) {\n";
+        const int body = 3 + rng.below(8);
+        for (int b = 0; b < body; ++b) {
+            switch (rng.below(4)) {
+            case 0: s << "            total += SQUARE(i) * " << rng.below(100) << ".5f;\n"; break;
+            case 1: s << "            if (input." << word() << "() > 0x" << std::hex << rng.below(4096) << std::dec << ") continue;\n"; break;
+            case 2: s << "            const char* msg = \"" << word() << " %d\\n\";\n"; break;
+            default: s << "            " << word() << "(i, '" << static_cast<char>('a' + rng.below(26)) << "'); // " << word() << "\n"; break;
+            }
+        }
+        s << "        }\n        return static_cast<int>(total);\n    }\n};\n\n"
+          << "} // namespace mod" << unit % 17 << "\n\n";
+        const std::string chunk = s.str();
+        out += chunk;
+        emitted += static_cast<std::size_t>(std::count(chunk.begin(), chunk.end(), '\n'));
+    }
+    return out;
+}
+
+TSPoint pointAt(std::string_view text, std::size_t byte)
+{
+    TSPoint p{ 0, 0 };
+    std::size_t lineStart = 0;
+    for (std::size_t i = 0; i < byte; ++i)
+        if (text[i] == '\n') { ++p.row; lineStart = i + 1; }
+    p.column = static_cast<uint32_t>(byte - lineStart);
+    return p;
+}
+
+/*──────────────────────── harness ────────────────────────*/
+
+struct Result {
+    std::string                name;
+    const char*                kind = "micro";
+    std::vector<std::uint64_t> samples{}; // ns per iteration
+    std::uint64_t              bytes = 0; // processed per iteration, for throughput
+    std::string                skipped{}; // reason, if not run
+};
+
+std::uint64_t nsSince(Clock::time_point start)
+{
+    return static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - start).count());
+}
+
+// Pump the editor like the frame loop would until no job is in flight, so
+// background highlight / semantic work never overlaps a timed region.
+void settle(TextEditor& editor)
+{
+    editor.Update();
+    while (editor.HasPendingWork()) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        editor.Update();
+    }
+}
+
+std::uint64_t percentile(std::vector<std::uint64_t> v, double p)
+{
+    std::sort(v.begin(), v.end());
+    const std::size_t idx = static_cast<std::size_t>(std::ceil(p * v.size())) - 1;
+    return v[std::min(idx, v.size() - 1)];
+}
+
+void appendJsonString(std::string& out, std::string_view s)
+{
+    out += '"';
+    for (char c : s) {
+        if (c == '"' || c == '\\') out += '\\';
+        if (static_cast<unsigned char>(c) < 0x20) { out += ' '; continue; }
+        out += c;
+    }
+    out += '"';
+}
+
+const char* compilerName()
+{
+#if defined(__clang__)
+    return "clang " __clang_version__;
+#elif defined(__GNUC__)
+    return "gcc " __VERSION__;
+#elif defined(_MSC_VER)
+    return "msvc";
+#else
+    return "unknown";
+#endif
+}
+
+std::string toJson(const std::vector<Result>& results, std::uint64_t seed, std::size_t lines, std::size_t bytes, const std::string& file)
+{
+    std::string out = "{\n  \"version\": 1,\n  \"build\": {\"compiler\": ";
+    appendJsonString(out, compilerName());
+#ifdef MUT_NO_LIBCLANG
+    out += ", \"libclang\": false";
+#else
+    out += ", \"libclang\": true";
+#endif
+#ifdef NDEBUG
+    out += ", \"optimized\": true";
+#else
+    out += ", \"optimized\": false";
+#endif
+    out += "},\n  \"input\": {\"source\": ";
+    appendJsonString(out, file.empty() ? "synthetic" : file);
+    out += ", \"seed\": " + std::to_string(seed) + ", \"lines\": " + std::to_string(lines)
+        + ", \"bytes\": " + std::to_string(bytes) + "},\n  \"benchmarks\": [";
+
+    for (std::size_t i = 0; i < results.size(); ++i) {
+        const Result& r = results[i];
+        out += i ? ",\n    {" : "\n    {";
+        out += "\"name\": ";
+        appendJsonString(out, r.name);
+        out += ", \"kind\": ";
+        appendJsonString(out, r.kind);
+        if (!r.skipped.empty() || r.samples.empty()) {
+            out += ", \"skipped\": ";
+            appendJsonString(out, r.skipped.empty() ? "no samples" : r.skipped);
+            out += "}";
+            continue;
+        }
+        std::uint64_t sum = 0;
+        for (auto s : r.samples) sum += s;
+        char buf[256];
+        std::snprintf(buf, sizeof buf,
+            ", \"unit\": \"ns\", \"iterations\": %zu, \"min\": %llu, \"median\": %llu, \"mean\": %llu, \"p90\": %llu, \"max\": %llu",
+            r.samples.size(),
+            static_cast<unsigned long long>(*std::min_element(r.samples.begin(), r.samples.end())),
+            static_cast<unsigned long long>(percentile(r.samples, 0.5)),
+            static_cast<unsigned long long>(sum / r.samples.size()),
+            static_cast<unsigned long long>(percentile(r.samples, 0.9)),
+            static_cast<unsigned long long>(*std::max_element(r.samples.begin(), r.samples.end())));
+        out += buf;
+        if (r.bytes) out += ", \"bytes\": " + std::to_string(r.bytes);
+        out += "}";
+    }
+    out += "\n  ]\n}\n";
+    return out;
+}
+
+void printTable(const std::vector<Result>& results)
+{
+    std::fprintf(stderr, "%-28s %6s %12s %12s %12s\n", "benchmark", "iters", "min ms", "median ms", "p90 ms");
+    for (const Result& r : results) {
+        if (!r.skipped.empty() || r.samples.empty()) {
+            std::fprintf(stderr, "%-28s skipped: %s\n", r.name.c_str(), r.skipped.c_str());
+            continue;
+        }
+        std::fprintf(stderr, "%-28s %6zu %12.3f %12.3f %12.3f\n", r.name.c_str(), r.samples.size(),
+            *std::min_element(r.samples.begin(), r.samples.end()) / 1e6,
+            percentile(r.samples, 0.5) / 1e6, percentile(r.samples, 0.9) / 1e6);
+    }
+}
+
+int usage()
+{
+    std::fprintf(stderr, "usage: mut_bench [--out results.json] [--file source.cpp] [--lines N] [--seed S] [--scale F] [--filter NAME]\n");
+    return 2;
+}
+
+} // namespace
+
+int main(int argc, char** argv)
+{
+    std::string outPath, filePath, filter;
+    std::size_t lines = 20000;
+    std::uint64_t seed = 0x6D7574;   // "mut"
+    double scale = 1.0;
+    for (int i = 1; i < argc; ++i) {
+        const bool hasValue = i + 1 < argc;
+        if (!std::strcmp(argv[i], "--out") && hasValue)         outPath = argv[++i];
+        else if (!std::strcmp(argv[i], "--file") && hasValue)   filePath = argv[++i];
+        else if (!std::strcmp(argv[i], "--lines") && hasValue)  lines = std::strtoull(argv[++i], nullptr, 10);
+        else if (!std::strcmp(argv[i], "--seed") && hasValue)   seed = std::strtoull(argv[++i], nullptr, 0);
+        else if (!std::strcmp(argv[i], "--scale") && hasValue)  scale = std::max(0.01, std::atof(argv[++i]));
+        else if (!std::strcmp(argv[i], "--filter") && hasValue) filter = argv[++i];
+        else return usage();
+    }
+    auto iters = [&](int n) { return std::max(1, static_cast<int>(std::lround(n * scale))); };
+    auto wanted = [&](const char* name) { return filter.empty() || std::strstr(name, filter.c_str()); };
+
+    // Tracing would add its own cost to every measured path.
+    trace::setLevel(trace::Level::Off);
+
+    // The editor opens files from disk, so the input always lives in one.
+    std::string source;
+    fs::path    sourcePath;
+    bool        ownsFile = false;
+    if (!filePath.empty()) {
+        std::ifstream in(filePath, std::ios::binary);
+        if (!in) {
+            std::fprintf(stderr, "[Bench] Cannot read '%s'\n", filePath.c_str());
+            return 1;
+        }
+        source.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+        sourcePath = filePath;
+    }
+    else {
+        source = generateSource(lines, seed);
+        sourcePath = fs::temp_directory_path() / ("mut_bench_" + std::to_string(seed) + ".cpp");
+        std::ofstream(sourcePath, std::ios::binary) << source;
+        ownsFile = true;
+    }
+    const std::size_t lineCount = static_cast<std::size_t>(std::count(source.begin(), source.end(), '\n')) + 1;
+    std::fprintf(stderr, "[Bench] input: %s, %zu lines, %zu bytes\n", sourcePath.string().c_str(), lineCount, source.size());
+
+    std::vector<Result> results;
+    bool failed = false;   // a correctness check went wrong
+    const bool cpp = sourcePath.extension() != ".c";
+
+    // 1) Full highlight of the whole file, fresh tree each time.
+    if (wanted("highlight_full")) {
+        Result r{ "highlight_full", "macro" };
+        r.bytes = source.size();
+        SyntaxHighlighter hl(cpp ? "cpp" : "c");
+        hl.Highlight(source);   // warm-up: language, queries, allocator
+        for (int i = 0; i < iters(5); ++i) {
+            auto t = Clock::now();
+            auto tokens = hl.Highlight(source);
+            r.samples.push_back(nsSince(t));
+        }
+        results.push_back(std::move(r));
+    }
+
+    // 2) One typed character, re-highlighted incrementally against the
+    //    previous tree (what every keystroke costs the highlighter).
+    if (wanted("highlight_keystroke")) {
+        Result r{ "highlight_keystroke", "micro" };
+        SyntaxHighlighter hl(cpp ? "cpp" : "c");
+        SyntaxHighlighter::ParseState state;
+        std::string text = source;
+        hl.HighlightIncremental(state, text, {});
+        Rng rng{ seed ^ 0x5eed };
+        for (int i = 0; i < iters(200); ++i) {
+            // a position inside some line, never inside the final newline run
+            std::size_t at = static_cast<std::size_t>(rng.next() % text.size());
+            while (at > 0 && text[at - 1] == '\n') --at;
+            const TSPoint start = pointAt(text, at);
+            text.insert(at, 1, 'x');
+            TextEdit edit{ at, at, at + 1, start, start, { start.row, start.column + 1 } };
+
+            auto t = Clock::now();
+            auto tokens = hl.HighlightIncremental(state, text, { edit });
+            r.samples.push_back(nsSince(t));
+        }
+        results.push_back(std::move(r));
+    }
+
+    // 3..5) Editor-level paths on a real TextEditor.
+    if (wanted("set_content_diff") || wanted("paste_10k_lines") || wanted("undo_large_edit")) {
+        SyntaxHighlighter hl(cpp ? "cpp" : "c");
+        ClangIndexer      indexer;
+        TextEditor        editor(sourcePath.string(), hl, indexer);
+        settle(editor);
+
+        if (wanted("set_content_diff")) {
+            // One line changed in the middle: exercises SetContent's common
+            // prefix / suffix diff and cache reuse.
+            Result r{ "set_content_diff", "micro" };
+            std::string edited = source;
+            const std::size_t mid = edited.find('\n', edited.size() / 2);
+            edited.insert(mid == std::string::npos ? edited.size() : mid, " // edited");
+            for (int i = 0; i < iters(20); ++i) {
+                const std::string& next = (i % 2 == 0) ? edited : source;
+                auto t = Clock::now();
+                editor.SetContent(next);
+                r.samples.push_back(nsSince(t));
+                settle(editor);
+            }
+            results.push_back(std::move(r));
+        }
+
+        if (wanted("paste_10k_lines") || wanted("undo_large_edit")) {
+            std::string paste;
+            Rng rng{ seed ^ 0x9a57e };
+            for (int i = 0; i < 10000; ++i)
+                paste += "    value" + std::to_string(rng.below(100000)) + " += compute(" + std::to_string(i) + ");\n";
+
+            Result pasteResult{ "paste_10k_lines", "macro" };
+            Result undoResult{ "undo_large_edit", "macro" };
+            pasteResult.bytes = paste.size();
+            for (int i = 0; i < iters(5); ++i) {
+                editor.MoveCursorTo(static_cast<int>(editor.LineCount() / 2), 0);
+                auto t = Clock::now();
+                editor.PasteText(paste);
+                pasteResult.samples.push_back(nsSince(t));
+                settle(editor);
+
+                t = Clock::now();
+                editor.Undo();
+                undoResult.samples.push_back(nsSince(t));
+                settle(editor);
+            }
+            if (wanted("paste_10k_lines")) results.push_back(std::move(pasteResult));
+            if (wanted("undo_large_edit")) results.push_back(std::move(undoResult));
+        }
+    }
+
+    // Regression check, timed as a side effect: an undo (an untracked edit,
+    // often answered from the token cache) followed by typing must colour
+    // exactly like a fresh parse of the same text.
+    if (wanted("type_after_undo")) {
+        Result r{ "type_after_undo", "micro" };
+        SyntaxHighlighter hl(cpp ? "cpp" : "c");
+        ClangIndexer      indexer;
+        TextEditor        editor(sourcePath.string(), hl, indexer);
+        settle(editor);
+        Rng rng{ seed ^ 0x0dd };
+        for (int i = 0; i < iters(10) && !failed; ++i) {
+            editor.MoveCursorTo(rng.below(static_cast<int>(editor.LineCount())), 0);
+            editor.TypeText("x");
+            settle(editor);
+            editor.Undo();   // parses afresh and caches the tokens of this text
+            settle(editor);
+            editor.Redo();
+            settle(editor);
+            editor.Undo();   // a token-cache hit
+            settle(editor);
+
+            editor.MoveCursorTo(rng.below(static_cast<int>(editor.LineCount())), 0);
+            auto t = Clock::now();
+            editor.TypeText("/* typed */ ");
+            settle(editor);
+            r.samples.push_back(nsSince(t));
+
+            const auto got = editor.Tokens();
+            const auto want = hl.Highlight(editor.GetContent());
+            const bool same = got.size() == want.size() && std::equal(got.begin(), got.end(), want.begin(),
+                [](const SyntaxToken& a, const SyntaxToken& b) {
+                    return a.line == b.line && a.column == b.column && a.length == b.length && a.type == b.type; });
+            if (!same) {
+                std::fprintf(stderr, "[Bench] type_after_undo: %zu tokens after undo + typing, a fresh parse has %zu\n",
+                    got.size(), want.size());
+                failed = true;
+            }
+        }
+        results.push_back(std::move(r));
+    }
+
+    // 6) libclang indexing without (cold) and with (warm) a cached TU.
+    if (wanted("index_cold") || wanted("index_warm")) {
+        Result cold{ "index_cold", "macro" };
+        Result warm{ "index_warm", "macro" };
+#ifdef MUT_NO_LIBCLANG
+        cold.skipped = warm.skipped = "built without libclang";
+#else
+        ClangIndexer indexer;
+        for (int i = 0; i < iters(3); ++i) {
+            ClangIndexer::Cleanup();
+            auto t = Clock::now();
+            indexer.Index(sourcePath.string(), source);
+            cold.samples.push_back(nsSince(t));
+
+            t = Clock::now();
+            indexer.Index(sourcePath.string(), source);
+            warm.samples.push_back(nsSince(t));
+        }
+        ClangIndexer::Cleanup();
+#endif
+        if (wanted("index_cold")) results.push_back(std::move(cold));
+        if (wanted("index_warm")) results.push_back(std::move(warm));
+    }
+
+    if (ownsFile) {
+        std::error_code ec;
+        fs::remove(sourcePath, ec);
+    }
+
+    printTable(results);
+    const std::string json = toJson(results, filePath.empty() ? seed : 0, lineCount, source.size(), filePath);
+    if (outPath.empty()) {
+        std::fwrite(json.data(), 1, json.size(), stdout);
+        return failed ? 1 : 0;
+    }
+    std::ofstream out(outPath, std::ios::binary);
+    if (!(out << json)) {
+        std::fprintf(stderr, "[Bench] Cannot write '%s'\n", outPath.c_str());
+        return 1;
+    }
+    return failed ? 1 : 0;
+}
@@ -1,5 +1,7 @@
 #include "clang_indexer.h"
+#ifndef MUT_NO_LIBCLANG
 #include <clang-c/Index.h>
+#endif
 #include <iostream>
 #include <vector>
 #include <string>
@@ -7,22 +9,10 @@
 #include <functional>
 #include <mutex>
 #include <chrono>
-#include <cstdarg>
-
-#define DEBUG_CLANGINDEXER
-#ifdef DEBUG_CLANGINDEXER
-#include <cstdio>
-
-// ANSI color codes
-#define ANSI_COLOR_RED     "\x1b[31m"
-#define ANSI_COLOR_GREEN   "\x1b[32m"
-#define ANSI_COLOR_YELLOW  "\x1b[33m"
-#define ANSI_COLOR_BLUE    "\x1b[34m"
-#define ANSI_COLOR_MAGENTA "\x1b[35m"
-#define ANSI_COLOR_CYAN    "\x1b[36m"
-#define ANSI_COLOR_RESET   "\x1b[0m"
-#define ANSI_COLOR_BOLD    "\x1b[1m"
 
+#include "platform/trace.h"
+
+// Debug modules, recorded as trace categories (see platform/trace.h).
 enum class DebugModule {
     INDEXER,
     CACHE,
@@ -31,7 +21,7 @@ enum class DebugModule {
     CLEANUP
 };
 
-static const char* GetModuleName(DebugModule mod) {
+static constexpr const char* GetModuleName(DebugModule mod) {
     switch (mod) {
     case DebugModule::INDEXER: return "INDEXER";
     case DebugModule::CACHE:   return "CACHE";
@@ -42,74 +32,102 @@ static const char* GetModuleName(DebugModule mod) {
     }
 }
 
-static const char* GetModuleColor(DebugModule mod) {
-    switch (mod) {
-    case DebugModule::INDEXER: return ANSI_COLOR_BLUE;
-    case DebugModule::CACHE:   return ANSI_COLOR_MAGENTA;
-    case DebugModule::PARSE:   return ANSI_COLOR_GREEN;
-    case DebugModule::AST:     return ANSI_COLOR_CYAN;
-    case DebugModule::CLEANUP: return ANSI_COLOR_YELLOW;
-    default:                   return ANSI_COLOR_RESET;
+// The AST visitor logs once per symbol: Verbose only.
+static constexpr trace::Level GetModuleLevel(DebugModule mod) {
+    return mod == DebugModule::AST ? trace::Level::Verbose : trace::Level::Debug;
+}
+
+#define DBG_CINDEX(mod, action, fmt, ...) \
+    MUT_TRACE(GetModuleLevel(mod), GetModuleName(mod), action, fmt, ##__VA_ARGS__)
+
+// clang_indexer.cpp
+
+const char* SymbolKindName(SymbolKind kind) {
+    switch (kind) {
+    case SymbolKind::Namespace:   return "namespace";
+    case SymbolKind::Class:       return "class";
+    case SymbolKind::Struct:      return "struct";
+    case SymbolKind::Union:       return "union";
+    case SymbolKind::Enum:        return "enum";
+    case SymbolKind::Enumerator:  return "enumerator";
+    case SymbolKind::Typedef:     return "typedef";
+    case SymbolKind::Function:    return "function";
+    case SymbolKind::Method:      return "method";
+    case SymbolKind::Constructor: return "constructor";
+    case SymbolKind::Destructor:  return "destructor";
+    case SymbolKind::Field:       return "field";
+    case SymbolKind::Variable:    return "variable";
+    default:                      return "other";
     }
 }
 
-static void DebugPrint(DebugModule mod, const char* action, const char* fmt, ...) {
-    // timestamp
-    auto now = std::chrono::system_clock::now();
-    auto ms = std::chrono::duration_cast<std::chrono::milliseconds>(now.time_since_epoch()) % 1000;
-    auto t = std::chrono::system_clock::to_time_t(now);
-    struct tm* lt = localtime(&t);
-    fprintf(stderr, "[%02d:%02d:%02d.%03d] ", lt->tm_hour, lt->tm_min, lt->tm_sec, (int)ms.count());
+#ifdef MUT_NO_LIBCLANG
+
+// Built without libclang: no symbols, so the editor keeps tree-sitter
+// colouring only and the outline / workspace symbols stay empty.
+SymbolList ClangIndexer::Index(const std::string& filepath, std::string_view code, IndexDepth) {
+    DBG_CINDEX(DebugModule::INDEXER, "Index", "libclang disabled, skipping '%s' (%zu bytes)", filepath.c_str(), code.size());
+    return {};
+}
 
-    // module
-    fprintf(stderr, "%s%s[%-9s]%s ", ANSI_COLOR_BOLD, GetModuleColor(mod), GetModuleName(mod), ANSI_COLOR_RESET);
+void ClangIndexer::Cleanup() {}
 
-    // action
-    fprintf(stderr, "%s%-12s%s ", ANSI_COLOR_BOLD, action, ANSI_COLOR_RESET);
+bool ClangIndexer::Parse(const std::string&, std::string_view) { return false; }
 
-    // message
-    va_list args;
-    va_start(args, fmt);
-    vfprintf(stderr, fmt, args);
-    va_end(args);
-    fprintf(stderr, "\n");
+SemanticLines ClangIndexer::Annotate(const std::string&, std::string_view, int first_line, int last_line) {
+    return SemanticLines(last_line >= first_line ? last_line - first_line + 1 : 0);
 }
 
-#define DBG_CINDEX(mod, action, fmt, ...) \
-    do { DebugPrint(mod, action, fmt, ##__VA_ARGS__); } while(0)
+size_t ClangIndexer::TranslationUnitBytes(const std::string&) { return 0; }
+
+bool ClangIndexer::Release(const std::string&) { return true; }
+
 #else
-#define DBG_CINDEX(mod, action, fmt, ...) ((void)0)
-#endif
 
-// clang_indexer.cpp
+// The globals below are never destroyed: editors owned by statics of other
+// translation units (gui_layer.cpp) still call Cleanup() and wait on jobs
+// that use them during static destruction, in an order we do not control.
 
 // Global index cache
 static CXIndex g_clang_index = nullptr;
-static std::mutex g_index_mutex;
+static std::mutex& g_index_mutex = *new std::mutex;
 
-static std::unordered_map<std::size_t, CXTranslationUnit> g_tu_cache_;
-static std::mutex                            g_tu_mutex_;
+// One TU per file, reparsed with the new buffer on every Index() / Parse() call.
+static auto&       g_tu_cache_ = *new std::unordered_map<std::string, CXTranslationUnit>;
+static std::mutex& g_tu_mutex_ = *new std::mutex;
 
-std::vector<Symbol> ClangIndexer::Index(const std::string& filepath,
-    const std::string& code) {
-    std::vector<Symbol> symbols;
-    DBG_CINDEX(DebugModule::INDEXER, "Index", "Indexing '%s' (%zu bytes)", filepath.c_str(), code.size());
+// Resource usage of every cached TU, recorded by the job that (re)parsed
+// it.  g_tu_mutex_ is held through whole parses, so readers on the UI
+// thread (the memory panel, hibernation) take only this short lock.
+static auto&       g_tu_bytes_ = *new std::unordered_map<std::string, size_t>;
+static std::mutex& g_tu_bytes_mutex_ = *new std::mutex;
 
-    // Acquire or create index
-    CXIndex index;
-    {
-        std::lock_guard<std::mutex> lock(g_index_mutex);
-        if (!g_clang_index) {
-            DBG_CINDEX(DebugModule::INDEXER, "CreateIndex", "Creating new CXIndex");
-            g_clang_index = clang_createIndex(0, 0);
-        }
-        else {
-            DBG_CINDEX(DebugModule::INDEXER, "ReuseIndex", "Using existing CXIndex");
-        }
-        index = g_clang_index;
+static void RecordTranslationUnitBytes(const std::string& filepath, CXTranslationUnit tu) {
+    size_t bytes = 0;
+    if (tu) {
+        CXTUResourceUsage usage = clang_getCXTUResourceUsage(tu);
+        for (unsigned i = 0; i < usage.numEntries; ++i)
+            bytes += usage.entries[i].amount;
+        clang_disposeCXTUResourceUsage(usage);
     }
+    std::lock_guard<std::mutex> lock(g_tu_bytes_mutex_);
+    if (tu) g_tu_bytes_[filepath] = bytes;
+    else    g_tu_bytes_.erase(filepath);
+}
+
+static CXIndex AcquireIndex() {
+    std::lock_guard<std::mutex> lock(g_index_mutex);
+    if (!g_clang_index) {
+        DBG_CINDEX(DebugModule::INDEXER, "CreateIndex", "Creating new CXIndex");
+        g_clang_index = clang_createIndex(0, 0);
+    }
+    else {
+        DBG_CINDEX(DebugModule::INDEXER, "ReuseIndex", "Using existing CXIndex");
+    }
+    return g_clang_index;
+}
 
-    // Build arguments
+static std::vector<const char*> BuildArgs(const std::string& filepath) {
     DBG_CINDEX(DebugModule::PARSE, "BuildArgs", "Building command-line arguments");
     std::vector<const char*> args;
     std::string ext = filepath.substr(filepath.find_last_of('.') + 1);
@@ -119,74 +137,311 @@ std::vector<Symbol> ClangIndexer::Index(const std::string& filepath,
     // ... include paths ...
     args.push_back("-IC:/Program Files/LLVM/lib/clang/17.0.0/include");
     // more -I flags omitted for brevity
+    return args;
+}
+
+// Parse or reparse the TU of `filepath` against `code`.  Caller holds
+// g_tu_mutex_ for as long as it uses the returned TU.
+static CXTranslationUnit AcquireTranslationUnit(const std::string& filepath, std::string_view code) {
+    CXIndex index = AcquireIndex();
+    std::vector<const char*> args = BuildArgs(filepath);
 
     // Prepare unsaved file
-    CXUnsavedFile unsaved{ filepath.c_str(), code.c_str(), code.size() };
+    CXUnsavedFile unsaved{ filepath.c_str(), code.data(), static_cast<unsigned long>(code.size()) };
     DBG_CINDEX(DebugModule::PARSE, "UnsavedFile", "Filename='%s', Length=%zu", unsaved.Filename, unsaved.Length);
 
-    // Parse or reparse TU
-    size_t key = std::hash<std::string>{}(filepath + "\n" + code);
     CXTranslationUnit tu = nullptr;
-    {
-        std::lock_guard<std::mutex> lock(g_tu_mutex_);
-        auto it = g_tu_cache_.find(key);
-        if (it != g_tu_cache_.end()) {
-            tu = it->second;
-            DBG_CINDEX(DebugModule::CACHE, "CacheHit", "TU cache hit for key %zx", key);
-            unsigned opts = clang_defaultEditingTranslationUnitOptions();
-            if (clang_reparseTranslationUnit(tu, 1, &unsaved, opts) != 0) {
-                DBG_CINDEX(DebugModule::CACHE, "ReparseFail", "Reparse failed, disposing TU");
-                clang_disposeTranslationUnit(tu);
-                g_tu_cache_.erase(it);
-                tu = nullptr;
-            }
-            else {
-                DBG_CINDEX(DebugModule::CACHE, "ReparsedTU", "Reparsed TU successfully");
-            }
+    auto it = g_tu_cache_.find(filepath);
+    if (it != g_tu_cache_.end()) {
+        tu = it->second;
+        DBG_CINDEX(DebugModule::CACHE, "CacheHit", "TU cache hit for '%s'", filepath.c_str());
+        unsigned opts = clang_defaultEditingTranslationUnitOptions();
+        if (clang_reparseTranslationUnit(tu, 1, &unsaved, opts) != 0) {
+            DBG_CINDEX(DebugModule::CACHE, "ReparseFail", "Reparse failed, disposing TU");
+            clang_disposeTranslationUnit(tu);
+            g_tu_cache_.erase(it);
+            tu = nullptr;
+        }
+        else {
+            DBG_CINDEX(DebugModule::CACHE, "ReparsedTU", "Reparsed TU successfully");
+            RecordTranslationUnitBytes(filepath, tu);
         }
+    }
+    if (!tu) {
+        DBG_CINDEX(DebugModule::PARSE, "ParseTU", "Parsing new TU");
+        tu = clang_parseTranslationUnit(
+            index,
+            filepath.c_str(),
+            args.data(), static_cast<int>(args.size()),
+            &unsaved, 1,
+            CXTranslationUnit_DetailedPreprocessingRecord
+        );
         if (!tu) {
-            DBG_CINDEX(DebugModule::PARSE, "ParseTU", "Parsing new TU");
-            tu = clang_parseTranslationUnit(
-                index,
-                filepath.c_str(),
-                args.data(), static_cast<int>(args.size()),
-                &unsaved, 1,
-                CXTranslationUnit_DetailedPreprocessingRecord
-            );
-            if (!tu) {
-                DBG_CINDEX(DebugModule::PARSE, "ParseFail", "Failed to parse TU for %s", filepath.c_str());
-                return symbols;
-            }
-            g_tu_cache_[key] = tu;
-            DBG_CINDEX(DebugModule::CACHE, "CacheInsert", "Inserted TU into cache, size=%zu", g_tu_cache_.size());
+            DBG_CINDEX(DebugModule::PARSE, "ParseFail", "Failed to parse TU for %s", filepath.c_str());
+            RecordTranslationUnitBytes(filepath, nullptr);
+            return nullptr;
         }
+        g_tu_cache_[filepath] = tu;
+        RecordTranslationUnitBytes(filepath, tu);
+        DBG_CINDEX(DebugModule::CACHE, "CacheInsert", "Inserted TU into cache, size=%zu", g_tu_cache_.size());
+    }
+    return tu;
+}
+
+/*──────────────────────────────────────────────────────────*/
+/*                       declarations                       */
+
+namespace {
+    // State threaded through the indexer callbacks of one Index() call.
+    struct IndexContext {
+        SymbolList*                   out;
+        std::vector<std::string_view> containers;   // qualified name per client container id - 1
+        std::string                   scratch;
+    };
+}
+
+static SymbolKind ToSymbolKind(CXIdxEntityKind kind) {
+    switch (kind) {
+    case CXIdxEntity_CXXNamespace:          return SymbolKind::Namespace;
+    case CXIdxEntity_CXXClass:              return SymbolKind::Class;
+    case CXIdxEntity_Struct:                return SymbolKind::Struct;
+    case CXIdxEntity_Union:                 return SymbolKind::Union;
+    case CXIdxEntity_Enum:                  return SymbolKind::Enum;
+    case CXIdxEntity_EnumConstant:          return SymbolKind::Enumerator;
+    case CXIdxEntity_Typedef:
+    case CXIdxEntity_CXXTypeAlias:          return SymbolKind::Typedef;
+    case CXIdxEntity_Function:              return SymbolKind::Function;
+    case CXIdxEntity_CXXStaticMethod:
+    case CXIdxEntity_CXXInstanceMethod:
+    case CXIdxEntity_CXXConversionFunction: return SymbolKind::Method;
+    case CXIdxEntity_CXXConstructor:        return SymbolKind::Constructor;
+    case CXIdxEntity_CXXDestructor:         return SymbolKind::Destructor;
+    case CXIdxEntity_Field:                 return SymbolKind::Field;
+    case CXIdxEntity_Variable:
+    case CXIdxEntity_CXXStaticVariable:     return SymbolKind::Variable;
+    default:                                return SymbolKind::Other;
+    }
+}
+
+// Qualified name of a scope that was not indexed as a container (declared
+// in a header), e.g. for `void Foo::bar() {}` with Foo from an include.
+static void AppendScope(CXCursor c, std::string& out) {
+    const CXCursorKind kind = clang_getCursorKind(c);
+    if (clang_Cursor_isNull(c) || kind == CXCursor_TranslationUnit || clang_isInvalid(kind))
+        return;
+    AppendScope(clang_getCursorSemanticParent(c), out);
+    CXString spelling = clang_getCursorSpelling(c);
+    if (const char* name = clang_getCString(spelling); name && *name) {
+        if (!out.empty()) out += "::";
+        out += name;
     }
+    clang_disposeString(spelling);
+}
+
+static void OnDeclaration(CXClientData client_data, const CXIdxDeclInfo* info) {
+    auto& ctx = *static_cast<IndexContext*>(client_data);
+    const CXIdxEntityInfo* entity = info->entityInfo;
+    if (!entity || info->isImplicit)
+        return;
+    if (!clang_Location_isFromMainFile(clang_indexLoc_getCXSourceLocation(info->loc)))
+        return;
+
+    // Enclosing scope: the container's qualified name when it was indexed
+    // from this file, otherwise walk the semantic parents.
+    ctx.scratch.clear();
+    if (info->semanticContainer) {
+        const auto id = reinterpret_cast<uintptr_t>(clang_index_getClientContainer(info->semanticContainer));
+        if (id != 0)
+            ctx.scratch = ctx.containers[id - 1];
+        else
+            AppendScope(info->semanticContainer->cursor, ctx.scratch);
+    }
+    const bool anonymous = !entity->name || !*entity->name;
+    if (!anonymous) {
+        if (!ctx.scratch.empty()) ctx.scratch += "::";
+        ctx.scratch += entity->name;
+    }
+    const std::string_view name = ctx.out->Intern(ctx.scratch);
 
-    // Walk the AST
-    DBG_CINDEX(DebugModule::AST, "VisitRoot", "Walking AST");
-    CXCursor root = clang_getTranslationUnitCursor(tu);
-    clang_visitChildren(root,
-        [](CXCursor c, CXCursor, CXClientData client_data) {
-            auto& out = *reinterpret_cast<std::vector<Symbol>*>(client_data);
-            CXSourceLocation loc = clang_getCursorLocation(c);
-            if (!clang_Location_isFromMainFile(loc))
-                return CXChildVisit_Continue;
-            CXCursorKind kind = clang_getCursorKind(c);
-            CXString spelling = clang_getCursorSpelling(c);
-            CXString kindStr = clang_getCursorKindSpelling(kind);
-            unsigned line, col;
-            clang_getSpellingLocation(loc, nullptr, &line, &col, nullptr);
-            out.push_back({ clang_getCString(spelling), static_cast<int>(line), static_cast<int>(col), clang_getCString(kindStr) });
-            clang_disposeString(kindStr);
-            clang_disposeString(spelling);
-            DBG_CINDEX(DebugModule::AST, "Symbol", "%s at %d:%d", clang_getCString(spelling), line, col);
-            return CXChildVisit_Recurse;
-        }, &symbols);
-    DBG_CINDEX(DebugModule::AST, "VisitDone", "Collected %zu symbols", symbols.size());
+    // Anonymous scopes are transparent: their members take the outer name.
+    if (info->declAsContainer) {
+        ctx.containers.push_back(name);
+        clang_index_setClientContainer(info->declAsContainer,
+            reinterpret_cast<CXIdxClientContainer>(static_cast<uintptr_t>(ctx.containers.size())));
+    }
+    if (anonymous)
+        return;
 
+    unsigned line, column;
+    clang_indexLoc_getFileLocation(info->loc, nullptr, nullptr, &line, &column, nullptr);
+    ctx.out->symbols.push_back({ name, ctx.out->Intern(entity->USR ? entity->USR : ""),
+        static_cast<int>(line), static_cast<int>(column), ToSymbolKind(entity->kind), info->isDefinition != 0 });
+    DBG_CINDEX(DebugModule::AST, "Symbol", "%.*s at %u:%u", static_cast<int>(name.size()), name.data(), line, column);
+}
+
+SymbolList ClangIndexer::Index(const std::string& filepath,
+    std::string_view code, IndexDepth depth) {
+    MUT_TRACE_SCOPE(trace::Level::Info, "INDEXER", "Index");
+    SymbolList symbols;
+    DBG_CINDEX(DebugModule::INDEXER, "Index", "Indexing '%s' (%zu bytes, %s)", filepath.c_str(), code.size(),
+        depth == IndexDepth::Outline ? "outline" : "declarations");
+
+    IndexContext ctx{ &symbols, {}, {} };
+    IndexerCallbacks callbacks{};
+    callbacks.indexDeclaration = OnDeclaration;
+    CXIndexAction action = clang_IndexAction_create(AcquireIndex());
+
+    if (depth == IndexDepth::Outline) {
+        // A throwaway parse that never enters a function body; the cached
+        // TU (which semantic highlighting needs in full) is left alone.
+        // Parsed separately rather than through clang_indexSourceFile, whose
+        // TUs libclang 18 cannot dispose cleanly.
+        std::vector<const char*> args = BuildArgs(filepath);
+        CXUnsavedFile unsaved{ filepath.c_str(), code.data(), static_cast<unsigned long>(code.size()) };
+        CXTranslationUnit outline_tu = clang_parseTranslationUnit(AcquireIndex(), filepath.c_str(),
+            args.data(), static_cast<int>(args.size()), &unsaved, 1,
+            CXTranslationUnit_SkipFunctionBodies | CXTranslationUnit_KeepGoing);
+        if (outline_tu) {
+            clang_indexTranslationUnit(action, &ctx, &callbacks, sizeof(callbacks), CXIndexOpt_SuppressWarnings, outline_tu);
+            clang_disposeTranslationUnit(outline_tu);
+        }
+        else {
+            DBG_CINDEX(DebugModule::PARSE, "ParseFail", "Failed to parse outline TU for %s", filepath.c_str());
+        }
+    }
+    else {
+        // The lock is held through indexing so a concurrent Parse() of the
+        // same file cannot reparse under it.
+        std::lock_guard<std::mutex> tu_lock(g_tu_mutex_);
+        if (CXTranslationUnit tu = AcquireTranslationUnit(filepath, code))
+            clang_indexTranslationUnit(action, &ctx, &callbacks, sizeof(callbacks),
+                CXIndexOpt_IndexFunctionLocalSymbols, tu);
+    }
+    clang_IndexAction_dispose(action);
+
+    DBG_CINDEX(DebugModule::AST, "IndexDone", "Collected %zu declarations", symbols.symbols.size());
     return symbols;
 }
 
+bool ClangIndexer::Parse(const std::string& filepath, std::string_view code) {
+    MUT_TRACE_SCOPE(trace::Level::Info, "INDEXER", "Parse");
+    std::lock_guard<std::mutex> lock(g_tu_mutex_);
+    return AcquireTranslationUnit(filepath, code) != nullptr;
+}
+
+/*──────────────────────────────────────────────────────────*/
+/*                     semantic tokens                      */
+
+// Classify what an identifier's annotated cursor refers to.  References
+// and expressions resolve to their declaration, so a call to `f` colours
+// like the declaration of `f`.
+static SemanticKind ClassifyCursor(CXCursor c) {
+    CXCursorKind kind = clang_getCursorKind(c);
+    const bool member_access = kind == CXCursor_MemberRefExpr || kind == CXCursor_MemberRef;
+    if (clang_isReference(kind) || clang_isExpression(kind)) {
+        c = clang_getCursorReferenced(c);
+        if (clang_Cursor_isNull(c))
+            return SemanticKind::None;
+        kind = clang_getCursorKind(c);
+    }
+    switch (kind) {
+    case CXCursor_FunctionDecl:
+    case CXCursor_FunctionTemplate:
+    case CXCursor_CXXMethod:
+    case CXCursor_Constructor:
+    case CXCursor_Destructor:
+    case CXCursor_ConversionFunction: return SemanticKind::Function;
+    case CXCursor_VarDecl:            return SemanticKind::Variable;
+    case CXCursor_ParmDecl:           return SemanticKind::Parameter;
+    case CXCursor_FieldDecl:          return member_access ? SemanticKind::Member : SemanticKind::Field;
+    default:                          return SemanticKind::None;
+    }
+}
+
+// Byte offset of the start of 0-based `line`, or code.size() past the end.
+static size_t LineOffset(std::string_view code, int line) {
+    size_t pos = 0;
+    for (int i = 0; i < line; ++i) {
+        pos = code.find('\n', pos);
+        if (pos == std::string_view::npos) return code.size();
+        ++pos;
+    }
+    return pos;
+}
+
+SemanticLines ClangIndexer::Annotate(const std::string& filepath, std::string_view code,
+    int first_line, int last_line) {
+    MUT_TRACE_SCOPE(trace::Level::Info, "INDEXER", "Annotate");
+    SemanticLines lines(last_line >= first_line ? last_line - first_line + 1 : 0);
+    const size_t begin = LineOffset(code, first_line);
+    const size_t end = LineOffset(code, last_line + 1);
+    if (lines.empty() || begin >= end)
+        return lines;
+
+    std::lock_guard<std::mutex> lock(g_tu_mutex_);
+    auto it = g_tu_cache_.find(filepath);
+    if (it == g_tu_cache_.end())
+        return lines;
+    CXTranslationUnit tu = it->second;
+    CXFile file = clang_getFile(tu, filepath.c_str());
+    if (!file)
+        return lines;
+
+    CXSourceRange range = clang_getRange(
+        clang_getLocationForOffset(tu, file, static_cast<unsigned>(begin)),
+        clang_getLocationForOffset(tu, file, static_cast<unsigned>(end)));
+    CXToken* tokens = nullptr;
+    unsigned count = 0;
+    clang_tokenize(tu, range, &tokens, &count);
+    std::vector<CXCursor> cursors(count);
+    clang_annotateTokens(tu, tokens, count, cursors.data());
+
+    size_t annotated = 0;
+    for (unsigned i = 0; i < count; ++i) {
+        if (clang_getTokenKind(tokens[i]) != CXToken_Identifier)
+            continue;
+        const SemanticKind kind = ClassifyCursor(cursors[i]);
+        if (kind == SemanticKind::None)
+            continue;
+
+        CXSourceRange extent = clang_getTokenExtent(tu, tokens[i]);
+        unsigned line, col, start_offset, end_offset;
+        clang_getSpellingLocation(clang_getRangeStart(extent), nullptr, &line, &col, &start_offset);
+        clang_getSpellingLocation(clang_getRangeEnd(extent), nullptr, nullptr, nullptr, &end_offset);
+        const int idx = static_cast<int>(line) - 1 - first_line;
+        if (idx < 0 || idx >= static_cast<int>(lines.size()))
+            continue;
+        lines[idx].push_back({ static_cast<int>(col) - 1, static_cast<int>(end_offset - start_offset), kind });
+        ++annotated;
+    }
+    clang_disposeTokens(tu, tokens, count);
+
+    DBG_CINDEX(DebugModule::INDEXER, "Annotate", "Lines %d-%d: %u tokens, %zu annotated",
+        first_line, last_line, count, annotated);
+    return lines;
+}
+
+size_t ClangIndexer::TranslationUnitBytes(const std::string& filepath) {
+    std::lock_guard<std::mutex> lock(g_tu_bytes_mutex_);
+    auto it = g_tu_bytes_.find(filepath);
+    return it == g_tu_bytes_.end() ? 0 : it->second;
+}
+
+bool ClangIndexer::Release(const std::string& filepath) {
+    std::unique_lock<std::mutex> lock(g_tu_mutex_, std::try_to_lock);
+    if (!lock.owns_lock()) {
+        DBG_CINDEX(DebugModule::CACHE, "Release", "TU cache busy, '%s' released later", filepath.c_str());
+        return false;
+    }
+    auto it = g_tu_cache_.find(filepath);
+    if (it == g_tu_cache_.end()) return true;
+    clang_disposeTranslationUnit(it->second);
+    g_tu_cache_.erase(it);
+    RecordTranslationUnitBytes(filepath, nullptr);
+    DBG_CINDEX(DebugModule::CACHE, "Release", "Released TU for '%s', size=%zu", filepath.c_str(), g_tu_cache_.size());
+    return true;
+}
+
 void ClangIndexer::Cleanup() {
     DBG_CINDEX(DebugModule::CLEANUP, "CleanupStart", "Disposing all cached TUs and CXIndex");
     {
@@ -196,6 +451,10 @@ void ClangIndexer::Cleanup() {
         }
         g_tu_cache_.clear();
     }
+    {
+        std::lock_guard<std::mutex> lock(g_tu_bytes_mutex_);
+        g_tu_bytes_.clear();
+    }
     {
         std::lock_guard<std::mutex> lock(g_index_mutex);
         if (g_clang_index) {
@@ -206,3 +465,5 @@ void ClangIndexer::Cleanup() {
     }
     DBG_CINDEX(DebugModule::CLEANUP, "CleanupDone", "Cleanup complete");
 }
+
+#endif // MUT_NO_LIBCLANG
@@ -1,16 +1,105 @@
 #pragma once
+#include <cstdint>
+#include <memory>
 #include <string>
+#include <string_view>
 #include <vector>
 
+#include "string_pool.h"
+
+// Kind of a declaration, from libclang's CXIdxEntityKind (or the
+// tree-sitter tags query, SyntaxHighlighter::Outline).
+enum class SymbolKind : uint8_t {
+    Other,
+    Namespace,
+    Class,
+    Struct,
+    Union,
+    Enum,
+    Enumerator,
+    Typedef,
+    Function,
+    Method,
+    Constructor,
+    Destructor,
+    Field,
+    Variable,
+};
+
+// Lower-case display name ("class", "method", ...).
+const char* SymbolKindName(SymbolKind kind);
+
+// A declaration or definition.  The strings are views into the pool of
+// the SymbolList that produced it and are valid as long as that list is.
 struct Symbol {
-    std::string name;
-    int line;
+    std::string_view name;    // qualified: "ns::Type::member"
+    std::string_view usr;     // clang USR, stable across files; empty if unknown
+    int line;                 // 1-based
+    int column;               // 1-based
+    SymbolKind kind;
+    bool is_definition;
+};
+
+// The symbols of one file and the pool their strings are interned in.
+// Each result owns its pool, so a file's names are freed with the list
+// that replaces or releases it; consumers copy what they keep.
+struct SymbolList {
+    std::vector<Symbol>         symbols;
+    std::shared_ptr<StringPool> strings = std::make_shared<StringPool>();
+
+    std::string_view Intern(std::string_view s) { return strings->Get(strings->Intern(s)); }
+};
+
+// How much of a file Index() reports.
+enum class IndexDepth : uint8_t {
+    Outline,        // declarations outside function bodies; bodies are not parsed
+    Declarations,   // also locals and parameters, from the cached TU
+};
+
+// What an identifier refers to, as resolved by clang_annotateTokens.
+enum class SemanticKind : uint8_t {
+    None,
+    Function,    // functions, methods, constructors and calls to them
+    Variable,
+    Parameter,
+    Field,       // field declarations
+    Member,      // field accesses through `.` / `->`
+};
+
+// One annotated identifier: byte column (0-based) and length on its line.
+struct SemanticToken {
     int column;
-    std::string kind;
+    int length;
+    SemanticKind kind;
 };
 
+// Per-line arrays of semantic tokens, each sorted by column.
+using SemanticLines = std::vector<std::vector<SemanticToken>>;
+
 class ClangIndexer {
 public:
-    std::vector<Symbol> Index(const std::string& filepath, const std::string& code);
+    // Declarations and definitions of the main file, in source order.  Built
+    // from libclang's indexer callbacks, so expressions and references are
+    // never visited.  Outline parses on its own with function bodies
+    // skipped; Declarations (re)parses the cached TU.
+    SymbolList Index(const std::string& filepath, std::string_view code,
+        IndexDepth depth = IndexDepth::Declarations);
     static void Cleanup();  // Add static cleanup method
+
+    // Parse (or reparse) the cached TU of `filepath` against `code` without
+    // walking it; false when libclang could not produce a TU.
+    bool Parse(const std::string& filepath, std::string_view code);
+    // Semantic tokens of lines [first_line, last_line] (0-based) of the TU
+    // last parsed from `code`, one array per line.  Only that range is
+    // tokenized, so the visible lines can be annotated before the rest.
+    SemanticLines Annotate(const std::string& filepath, std::string_view code,
+        int first_line, int last_line);
+
+    // Bytes held by the cached translation unit of `filepath` (libclang's
+    // own resource accounting, as of its last parse), 0 when none is
+    // cached.  Never waits for a parse in progress.
+    static size_t TranslationUnitBytes(const std::string& filepath);
+    // Dispose the cached TU of `filepath`; the next Index() parses afresh.
+    // Never waits: false when a parse holds the cache, to be retried.
+    static bool Release(const std::string& filepath);
 };
\ No newline at end of file
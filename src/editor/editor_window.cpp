@@ -1,7 +1,7 @@
 ﻿#include "editor_window.h"
 
+#include <algorithm>
 #include <filesystem>
-#include <fstream>
 #include "imgui.h"
 #include "gui/symbols_panel.h"
 
@@ -14,6 +14,12 @@ EditorWindow::EditorWindow() = default;
 
 EditorWindow::~EditorWindow()
 {
+    // Outlines still being indexed use indexer_ and the global libclang state.
+    for (auto& tab : tabs_)
+        if (tab.clang_symbols.valid()) tab.clang_symbols.wait();
+    for (auto& pending : retired_symbols_)
+        pending.wait();
+
     // Global teardown for any libclang state.
     ClangIndexer::Cleanup();
 }
@@ -43,6 +49,7 @@ void EditorWindow::OpenFile(const std::string& path)
     /*—— 1) select existing tab, if any ————————————*/
     if (auto it = path_to_tab_.find(path); it != path_to_tab_.end()) {
         current_tab_ = it->second;
+        select_tab_ = current_tab_;
         return;
     }
 
@@ -58,17 +65,27 @@ void EditorWindow::OpenFile(const std::string& path)
     tabs_.push_back({ path, std::move(editor) });
     path_to_tab_[path] = tabs_.size() - 1;
     current_tab_ = tabs_.size() - 1;
+    select_tab_ = current_tab_;
 
     /*—— 3) index the file & update the Symbols panel ——*/
+    /*– the tags query over the highlighter's tree fills the panel as soon
+        as the first parse lands; libclang indexes the mapped snapshot in
+        the background and replaces it.  Large files are never handed to
+        libclang; the outline needs no function bodies, so they are
+        skipped –*/
+    EditorTab& tab = tabs_.back();
+    if (!tab.editor->IsLargeFile()) {
+        tab.outline_pending = true;
+        tab.clang_symbols = std::async(std::launch::async,
+            [this, path, snapshot = tab.editor->Snapshot()] {
+                return indexer_.Index(path, snapshot->Text(), IndexDepth::Outline);
+            });
+    }
+    symbol_index_.UpdateFile(path, {});
+
     if (symbols_panel_)
     {
-        /*– gather source code –*/
-        std::ifstream ifs(path, std::ios::binary);
-        std::string   code((std::istreambuf_iterator<char>(ifs)), {});
-
-        /*– feed panel –*/
-        auto symbols = indexer_.Index(path, code);
-        symbols_panel_->setSymbols(symbols);
+        symbols_panel_->setSymbols({});
 
         /*– hook double-click navigation *once* –*/
         symbols_panel_->setActivateCallback(
@@ -80,10 +97,126 @@ void EditorWindow::OpenFile(const std::string& path)
     }
 }
 
+void EditorWindow::OpenFileAt(const std::string& path, int line, int column)
+{
+    OpenFile(path);
+    if (tabs_.empty()) return;
+    /* caret helpers expect 0-based indices */
+    tabs_[current_tab_].editor->MoveCursorTo(line - 1, column - 1);
+}
+
+/*----------------------------------------------------------*/
+/*                         outline                          */
+void EditorWindow::PollSymbols()
+{
+    std::erase_if(retired_symbols_, [](const auto& pending) {
+        return pending.wait_for(std::chrono::seconds(0)) == std::future_status::ready; });
+
+    for (std::size_t i = 0; i < tabs_.size(); ++i) {
+        EditorTab& tab = tabs_[i];
+
+        /*– libclang is authoritative; an empty result (parse failure,
+            no libclang) leaves the tree-sitter outline standing –*/
+        if (tab.clang_symbols.valid()
+            && tab.clang_symbols.wait_for(std::chrono::seconds(0)) == std::future_status::ready) {
+            SymbolList symbols = tab.clang_symbols.get();
+            if (!symbols.symbols.empty()) {
+                tab.outline_pending = false;
+                PublishSymbols(i, symbols.symbols);
+            }
+        }
+
+        if (tab.outline_pending)
+            if (auto outline = tab.editor->TakeOutline()) {
+                tab.outline_pending = false;
+                PublishSymbols(i, outline->symbols);
+            }
+    }
+}
+
+void EditorWindow::PublishSymbols(std::size_t tab, const std::vector<Symbol>& symbols)
+{
+    symbol_index_.UpdateFile(tabs_[tab].path, symbols);
+    if (symbols_panel_ && tab == current_tab_)
+        symbols_panel_->setSymbols(symbols);
+}
+
+TextEditor::BackgroundWork EditorWindow::BackgroundQueue() const
+{
+    TextEditor::BackgroundWork total;
+    for (const auto& tab : tabs_) {
+        const auto work = tab.editor->BackgroundQueue();
+        total.highlight_running += work.highlight_running;
+        total.highlight_queued += work.highlight_queued;
+        total.semantic_running += work.semantic_running;
+        total.semantic_queued += work.semantic_queued;
+    }
+    return total;
+}
+
+std::vector<EditorWindow::DocumentMemory> EditorWindow::MemoryReport()
+{
+    std::vector<DocumentMemory> report;
+    report.reserve(tabs_.size());
+    for (auto& tab : tabs_)
+        report.push_back({ tab.path, tab.editor->MemoryFootprint(), tab.editor->IsHibernated() });
+    return report;
+}
+
+/*----------------------------------------------------------*/
+/*                       hibernation                        */
+void EditorWindow::SetHibernation(std::chrono::seconds idle, std::size_t memory_budget)
+{
+    hibernate_after_ = idle;
+    memory_budget_ = memory_budget;
+}
+
+void EditorWindow::HibernateInactiveTabs()
+{
+    const auto now = std::chrono::steady_clock::now();
+
+    /*—— 0) only the selected tab is drawn: collect the jobs of the
+           others here, or a tab left while busy stays busy for good ——*/
+    for (std::size_t i = 0; i < tabs_.size(); ++i)
+        if (i != current_tab_)
+            tabs_[i].editor->CollectBackgroundWork();
+
+    /*—— 1) idle timeout ————————————————————————*/
+    for (std::size_t i = 0; i < tabs_.size(); ++i)
+        if (i != current_tab_ && !tabs_[i].editor->IsHibernated()
+            && now - tabs_[i].last_shown >= hibernate_after_)
+            tabs_[i].editor->Hibernate();   // retried next frame if busy
+
+    /*—— 2) memory pressure, checked every two seconds; footprints
+           use the recorded TU sizes, so this never waits on a parse ——*/
+    if (now - last_budget_check_ < std::chrono::seconds(2)) return;
+    last_budget_check_ = now;
+
+    std::size_t total = 0;
+    std::vector<std::pair<std::size_t, std::size_t>> candidates;   // (tab, bytes)
+    for (std::size_t i = 0; i < tabs_.size(); ++i) {
+        const std::size_t bytes = tabs_[i].editor->MemoryFootprint().Total();
+        total += bytes;
+        if (i != current_tab_ && !tabs_[i].editor->IsHibernated())
+            candidates.push_back({ i, bytes });
+    }
+    if (total <= memory_budget_) return;
+
+    std::sort(candidates.begin(), candidates.end(), [this](const auto& a, const auto& b) {
+        return tabs_[a.first].last_shown < tabs_[b.first].last_shown; });
+    for (const auto& [tab, bytes] : candidates) {
+        if (total <= memory_budget_) break;
+        if (!tabs_[tab].editor->Hibernate()) continue;
+        const std::size_t after = tabs_[tab].editor->MemoryFootprint().Total();
+        total -= std::min(total, bytes > after ? bytes - after : 0);
+    }
+}
+
 /*----------------------------------------------------------*/
 /*                      main drawing                        */
 void EditorWindow::Draw()
 {
+    PollSymbols();
     ImGui::Begin("Editor");
 
     if (ImGui::BeginTabBar("EditorTabs"))
@@ -95,9 +228,13 @@ void EditorWindow::Draw()
                 .filename()
                 .string();
 
-            if (ImGui::BeginTabItem(filename.c_str(), &open))
+            const ImGuiTabItemFlags flags =
+                (i == select_tab_) ? ImGuiTabItemFlags_SetSelected : ImGuiTabItemFlags_None;
+
+            if (ImGui::BeginTabItem(filename.c_str(), &open, flags))
             {
                 current_tab_ = i;
+                tabs_[i].last_shown = std::chrono::steady_clock::now();
 
                 ImGui::BeginChild("EditorRegion",
                     ImVec2(0, 0),
@@ -112,6 +249,8 @@ void EditorWindow::Draw()
             /*—— close-tab housekeeping ————————————*/
             if (!open)
             {
+                if (tabs_[i].clang_symbols.valid())
+                    retired_symbols_.push_back(std::move(tabs_[i].clang_symbols));
                 path_to_tab_.erase(tabs_[i].path);
                 tabs_.erase(tabs_.begin() + static_cast<long>(i));
 
@@ -127,6 +266,8 @@ void EditorWindow::Draw()
         }
         ImGui::EndTabBar();
     }
+    select_tab_ = kNoTab;
+    HibernateInactiveTabs();
 
     ImGui::End();
 }
@@ -1,5 +1,7 @@
 ﻿#pragma once
 #include <vector>
+#include <chrono>
+#include <future>
 #include <memory>
 #include <string>
 #include <unordered_map>
@@ -7,6 +9,7 @@
 #include "text_editor.h"
 #include "syntax_highlighter.h"
 #include "clang_indexer.h"
+#include "symbol_index.h"
 #include "gui/symbols_panel.h"   // ← new
 
 class EditorWindow
@@ -18,6 +21,31 @@ public:
     /*---------------------  public API  ---------------------*/
     void Draw();
     void OpenFile(const std::string& path);
+    /// Open (or switch to) `path` and put the caret at a 1-based location.
+    void OpenFileAt(const std::string& path, int line, int column);
+
+    /// The editor of the selected tab, or null with no tabs open.
+    TextEditor* ActiveEditor() { return tabs_.empty() ? nullptr : tabs_[current_tab_].editor.get(); }
+
+    /// Background highlight / semantic jobs summed over all open tabs.
+    TextEditor::BackgroundWork BackgroundQueue() const;
+    std::size_t                TabCount() const { return tabs_.size(); }
+
+    /// Per-document memory accounting, one entry per open tab.
+    struct DocumentMemory {
+        std::string             path;
+        TextEditor::MemoryUsage usage;
+        bool                    hibernated = false;
+    };
+    std::vector<DocumentMemory> MemoryReport();
+
+    /// Background tabs not shown for `idle` hibernate (TextEditor::Hibernate);
+    /// while all tabs together hold more than `memory_budget` bytes, the
+    /// least recently shown background tabs hibernate first.
+    void SetHibernation(std::chrono::seconds idle, std::size_t memory_budget);
+
+    /// Symbols of every file indexed so far, for workspace-wide search.
+    const SymbolIndex& WorkspaceSymbols() const { return symbol_index_; }
 
     /// Link a SymbolsPanel that we will populate and listen to.
     void SetSymbolsPanel(SymbolsPanel* panel);
@@ -27,19 +55,40 @@ private:
     struct EditorTab {
         std::string              path;
         std::unique_ptr<TextEditor> editor;
+        std::chrono::steady_clock::time_point last_shown = std::chrono::steady_clock::now();
+
+        /* outline: the tree-sitter one first, replaced by libclang's */
+        std::future<SymbolList>          clang_symbols{}; // in flight
+        bool                             outline_pending = false;
     };
 
     std::vector<EditorTab>                                tabs_;
     std::unordered_map<std::string, std::size_t>          path_to_tab_;
     std::size_t                                           current_tab_ = 0;
+    static constexpr std::size_t                          kNoTab = static_cast<std::size_t>(-1);
+    std::size_t                                           select_tab_ = kNoTab;   // bring to front next Draw
 
     /*-----------------  infrastructure  --------------------*/
     ClangIndexer                                           indexer_;
+    SymbolIndex                                            symbol_index_;
     std::unordered_map<std::string,
         std::unique_ptr<SyntaxHighlighter>> highlighters_;
 
     std::string DetectLanguage(const std::string& path);
 
+    /*----------------------  outline  ----------------------*/
+    /* libclang outlines of closed tabs, dropped once they finish:
+       destroying a std::async future blocks until its task is done */
+    std::vector<std::future<SymbolList>>                  retired_symbols_;
+    void PollSymbols();
+    void PublishSymbols(std::size_t tab, const std::vector<Symbol>& symbols);
+
+    /*--------------------  hibernation  --------------------*/
+    std::chrono::seconds                                  hibernate_after_{ 300 };
+    std::size_t                                           memory_budget_ = std::size_t(1) << 30;
+    std::chrono::steady_clock::time_point                 last_budget_check_{};
+    void HibernateInactiveTabs();
+
     /*------------------  external links  -------------------*/
     static SymbolsPanel* symbols_panel_;   // owned elsewhere
 };
@@ -0,0 +1,207 @@
+#include "file_snapshot.h"
+
+#include <bit>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define MUT_HAS_SSE2 1
+#endif
+
+/*──────────────────────────────────────────────────────────*/
+/*                   newline scanning                       */
+void ScanLineStarts(const char* data, size_t size, std::vector<size_t>& starts)
+{
+    starts.push_back(0);
+    size_t i = 0;
+
+#ifdef MUT_HAS_SSE2
+    // 16 bytes per step: compare against '\n', turn the result into a bit
+    // mask and peel off one set bit per newline.
+    const __m128i newline = _mm_set1_epi8('\n');
+    for (; i + 16 <= size; i += 16) {
+        __m128i  chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i));
+        unsigned mask = static_cast<unsigned>(_mm_movemask_epi8(_mm_cmpeq_epi8(chunk, newline)));
+        while (mask) {
+            starts.push_back(i + std::countr_zero(mask) + 1);
+            mask &= mask - 1;
+        }
+    }
+#endif
+
+    while (i < size) {
+        const void* hit = std::memchr(data + i, '\n', size - i);
+        if (!hit) break;
+        i = static_cast<size_t>(static_cast<const char*>(hit) - data) + 1;
+        starts.push_back(i);
+    }
+}
+
+/*──────────────────────────────────────────────────────────*/
+/*                    construction                          */
+FileSnapshot::Ptr FileSnapshot::Open(const std::string& path, size_t copy_below)
+{
+    std::shared_ptr<FileSnapshot> snap(new FileSnapshot());
+    snap->path_ = path;
+
+    std::error_code ec;
+    const std::uintmax_t size = std::filesystem::file_size(path, ec);
+
+    if (!ec && size >= copy_below && snap->MapFile()) {
+        snap->text_ = std::string_view(snap->mapping_, snap->mapping_size_);
+    }
+    else if (!ec) {
+        // Small enough to own: one read of the known size.
+        std::ifstream in(path, std::ios::binary);
+        snap->fallback_.resize(static_cast<size_t>(size));
+        in.read(snap->fallback_.data(), static_cast<std::streamsize>(size));
+        snap->fallback_.resize(static_cast<size_t>(in.gcount()));
+        snap->text_ = snap->fallback_;
+    }
+    else {
+        // Pipes, special files – read it the slow way.
+        std::ifstream in(path, std::ios::binary);
+        snap->fallback_.assign(std::istreambuf_iterator<char>(in), {});
+        snap->text_ = snap->fallback_;
+    }
+
+    // Skip a UTF-8 BOM; the editor never shows it.
+    if (snap->text_.size() >= 3 &&
+        static_cast<unsigned char>(snap->text_[0]) == 0xEF &&
+        static_cast<unsigned char>(snap->text_[1]) == 0xBB &&
+        static_cast<unsigned char>(snap->text_[2]) == 0xBF)
+        snap->text_.remove_prefix(3);
+
+    snap->BuildLineIndex();
+    return snap;
+}
+
+FileSnapshot::~FileSnapshot()
+{
+    UnmapFile();
+}
+
+void FileSnapshot::BuildLineIndex()
+{
+    line_starts_.clear();
+    line_starts_.reserve(text_.size() / 32 + 1);   // ~32 bytes per line of code
+    ScanLineStarts(text_.data(), text_.size(), line_starts_);
+
+    // getline semantics: a final '\n' terminates the last line instead of
+    // starting a new, empty one.
+    if (line_starts_.size() > 1 && line_starts_.back() == text_.size())
+        line_starts_.pop_back();
+}
+
+std::string_view FileSnapshot::Line(size_t index) const
+{
+    if (index >= line_starts_.size()) return {};
+
+    const size_t begin = line_starts_[index];
+    size_t       end = (index + 1 < line_starts_.size())
+        ? line_starts_[index + 1] - 1                 // drop the '\n'
+        : text_.size();
+    if (index + 1 == line_starts_.size() && end > begin && text_[end - 1] == '\n')
+        --end;
+    return text_.substr(begin, end - begin);
+}
+
+/*──────────────────────────────────────────────────────────*/
+/*                 platform mapping code                    */
+#ifdef _WIN32
+
+bool FileSnapshot::MapFile()
+{
+    const std::wstring wide = std::filesystem::path(path_).wstring();
+    HANDLE file = CreateFileW(wide.c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE,
+        nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+    if (file == INVALID_HANDLE_VALUE) return false;
+
+    LARGE_INTEGER size{};
+    if (!GetFileSizeEx(file, &size) || size.QuadPart == 0) {
+        // Zero-length files cannot be mapped; an empty view is just as good.
+        CloseHandle(file);
+        return false;
+    }
+
+    HANDLE mapping = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (!mapping) {
+        CloseHandle(file);
+        return false;
+    }
+
+    void* view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+    if (!view) {
+        CloseHandle(mapping);
+        CloseHandle(file);
+        return false;
+    }
+
+    file_handle_ = file;
+    map_handle_ = mapping;
+    mapping_ = static_cast<const char*>(view);
+    mapping_size_ = static_cast<size_t>(size.QuadPart);
+    return true;
+}
+
+void FileSnapshot::UnmapFile()
+{
+    if (mapping_)     UnmapViewOfFile(mapping_);
+    if (map_handle_)  CloseHandle(static_cast<HANDLE>(map_handle_));
+    if (file_handle_) CloseHandle(static_cast<HANDLE>(file_handle_));
+    mapping_ = nullptr;
+    map_handle_ = file_handle_ = nullptr;
+    mapping_size_ = 0;
+}
+
+#else
+
+bool FileSnapshot::MapFile()
+{
+    int fd = ::open(path_.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) return false;
+
+    struct stat st {};
+    if (::fstat(fd, &st) != 0 || !S_ISREG(st.st_mode) || st.st_size == 0) {
+        ::close(fd);
+        return false;
+    }
+
+    void* view = ::mmap(nullptr, static_cast<size_t>(st.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);   // the mapping keeps its own reference
+    if (view == MAP_FAILED) {
+        std::fprintf(stderr, "[FileSnapshot] mmap failed for %s\n", path_.c_str());
+        return false;
+    }
+    ::madvise(view, static_cast<size_t>(st.st_size), MADV_SEQUENTIAL);
+
+    mapping_ = static_cast<const char*>(view);
+    mapping_size_ = static_cast<size_t>(st.st_size);
+    return true;
+}
+
+void FileSnapshot::UnmapFile()
+{
+    if (mapping_)
+        ::munmap(const_cast<char*>(mapping_), mapping_size_);
+    mapping_ = nullptr;
+    mapping_size_ = 0;
+}
+
+#endif
@@ -0,0 +1,68 @@
+#pragma once
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+/*---------------------------------------------------------------------------
+    FileSnapshot – read-only, memory-mapped view of a source file.
+
+    The file is mapped once, a UTF-8 BOM is skipped, and the line-start
+    index is built with a vectorised newline scan.  Line splitting follows
+    std::getline: lines are split on '\n', a trailing '\n' does not open an
+    extra empty line and '\r' stays part of the line.
+
+    Snapshots are immutable and handed around as shared_ptr<const ...>, so
+    the editor, the highlighter and the indexer can all read the same bytes
+    without copying them.
+
+    A mapping lives as long as its snapshot, and reading a page past the
+    end of a file truncated in place since faults (SIGBUS).  Open() can
+    therefore read files below a size onto the heap instead; only what is
+    too big to copy should stay mapped.
+---------------------------------------------------------------------------*/
+class FileSnapshot {
+public:
+    using Ptr = std::shared_ptr<const FileSnapshot>;
+
+    /// Map `path` read-only, or read it onto the heap when it is smaller
+    /// than `copy_below` bytes.  Never returns null: a missing or unreadable
+    /// file yields an empty snapshot (one empty line), like an empty ifstream.
+    static Ptr Open(const std::string& path, size_t copy_below = 0);
+
+    ~FileSnapshot();
+    FileSnapshot(const FileSnapshot&) = delete;
+    FileSnapshot& operator=(const FileSnapshot&) = delete;
+
+    const std::string& Path() const { return path_; }
+    std::string_view   Text() const { return text_; }
+    size_t             Size() const { return text_.size(); }
+    bool               IsMapped() const { return mapping_ != nullptr; }
+
+    size_t                     LineCount() const { return line_starts_.size(); }
+    const std::vector<size_t>& LineStarts() const { return line_starts_; }
+    std::string_view           Line(size_t index) const;   // without '\n'
+
+private:
+    FileSnapshot() = default;
+
+    bool MapFile();
+    void UnmapFile();
+    void BuildLineIndex();
+
+    std::string         path_;
+    const char*         mapping_ = nullptr;   // start of the mapped region
+    size_t              mapping_size_ = 0;
+    std::string         fallback_;            // heap copy: small files, or mapping impossible
+    std::string_view    text_;
+    std::vector<size_t> line_starts_;
+#ifdef _WIN32
+    void*               file_handle_ = nullptr;
+    void*               map_handle_ = nullptr;
+#endif
+};
+
+/// Append the byte offset of every line start in `data` (the first line at 0
+/// included) to `starts`.  SSE2 when available, memchr-based otherwise.
+void ScanLineStarts(const char* data, size_t size, std::vector<size_t>& starts);
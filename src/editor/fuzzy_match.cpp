@@ -0,0 +1,157 @@
+// fuzzy_match.cpp
+#include "fuzzy_match.h"
+#include <algorithm>
+#include <bit>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define MUT_HAS_SSE2 1
+#endif
+
+namespace {
+    // Same weights as fzf's v1 scorer: a match is worth 16, gaps cost a
+    // little, and landing on a word or path boundary is worth half a match.
+    constexpr int kScoreMatch       = 16;
+    constexpr int kGapStart         = -3;
+    constexpr int kGapExtend        = -1;
+    constexpr int kBonusPath        = 10;   // after '/' or '\\', or at the very start
+    constexpr int kBonusBoundary    = 8;    // after '_', '-', '.', ' '
+    constexpr int kBonusCamel       = 7;    // fooBar: the 'B'
+    constexpr int kBonusConsecutive = -(kGapStart + kGapExtend);
+    constexpr int kBonusName        = 2 * kScoreMatch;
+
+    constexpr std::size_t npos = std::string_view::npos;
+
+    inline char lowerAscii(char c) { return (c >= 'A' && c <= 'Z') ? char(c - 'A' + 'a') : c; }
+
+    // Next `c` in `s` at or after `from`; this is where the scorer spends
+    // its time once the mask has let a candidate through.
+    std::size_t findByte(std::string_view s, std::size_t from, char c)
+    {
+#ifdef MUT_HAS_SSE2
+        const __m128i needle = _mm_set1_epi8(c);
+        while (from + 16 <= s.size()) {
+            __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(s.data() + from));
+            unsigned hits = static_cast<unsigned>(_mm_movemask_epi8(_mm_cmpeq_epi8(chunk, needle)));
+            if (hits) return from + std::countr_zero(hits);
+            from += 16;
+        }
+#endif
+        for (; from < s.size(); ++from)
+            if (s[from] == c) return from;
+        return npos;
+    }
+
+    int boundaryBonus(std::string_view candidate, std::size_t at)
+    {
+        if (at == 0) return kBonusPath;
+        const char prev = candidate[at - 1];
+        const char cur = candidate[at];
+        if (prev == '/' || prev == '\\') return kBonusPath;
+        if (prev == '_' || prev == '-' || prev == '.' || prev == ' ') return kBonusBoundary;
+        if (prev >= 'a' && prev <= 'z' && cur >= 'A' && cur <= 'Z') return kBonusCamel;
+        return 0;
+    }
+}
+
+std::string fuzzyLower(std::string_view text)
+{
+    std::string out(text);
+#ifdef MUT_HAS_SSE2
+    // 'A'..'Z' as a signed range test, then OR in 0x20 where it holds.
+    std::size_t i = 0;
+    const __m128i below = _mm_set1_epi8('A' - 1);
+    const __m128i above = _mm_set1_epi8('Z' + 1);
+    const __m128i flip  = _mm_set1_epi8(0x20);
+    for (; i + 16 <= out.size(); i += 16) {
+        auto* p = reinterpret_cast<__m128i*>(out.data() + i);
+        __m128i v = _mm_loadu_si128(p);
+        __m128i upper = _mm_and_si128(_mm_cmpgt_epi8(v, below), _mm_cmplt_epi8(v, above));
+        _mm_storeu_si128(p, _mm_or_si128(v, _mm_and_si128(upper, flip)));
+    }
+    for (; i < out.size(); ++i) out[i] = lowerAscii(out[i]);
+#else
+    for (char& c : out) c = lowerAscii(c);
+#endif
+    return out;
+}
+
+std::uint64_t fuzzyMask(std::string_view lowered)
+{
+    std::uint64_t mask = 0;
+    for (char c : lowered) {
+        int bit;
+        if (c >= 'a' && c <= 'z')      bit = c - 'a';
+        else if (c >= '0' && c <= '9') bit = 26 + (c - '0');
+        else switch (c) {
+            case '_':  bit = 36; break;
+            case '-':  bit = 37; break;
+            case '.':  bit = 38; break;
+            case '/':  bit = 39; break;
+            case ' ':  bit = 40; break;
+            default:   bit = 63; break;   // everything else shares one bit
+        }
+        mask |= std::uint64_t(1) << bit;
+    }
+    return mask;
+}
+
+// Score of the tightest window that contains the query, fzf v1 style.
+static int scoreWindow(std::string_view loweredQuery, std::string_view candidate, std::string_view lowered)
+{
+    const std::size_t m = loweredQuery.size();
+    if (m > lowered.size()) return kFuzzyNoMatch;
+
+    // 1) forward: the earliest end at which the whole query has been seen
+    std::size_t end = 0;
+    for (char c : loweredQuery) {
+        end = findByte(lowered, end, c);
+        if (end == npos) return kFuzzyNoMatch;
+        ++end;
+    }
+
+    // 2) backward from there: the latest start, i.e. the tightest window
+    std::size_t start = end;
+    for (std::size_t qi = m; qi-- > 0;)
+        do --start; while (lowered[start] != loweredQuery[qi]);
+
+    // 3) score the window
+    int score = 0;
+    int chunkBonus = 0;      // bonus of the first char in the current run
+    bool inGap = false;
+    bool inRun = false;
+    std::size_t qi = 0;
+    for (std::size_t j = start; j < end; ++j) {
+        if (qi < m && lowered[j] == loweredQuery[qi]) {
+            int bonus = boundaryBonus(candidate, j);
+            if (inRun) bonus = std::max({ bonus, chunkBonus, kBonusConsecutive });
+            else       chunkBonus = bonus;
+            score += kScoreMatch + (qi == 0 ? 2 * bonus : bonus);
+            inRun = true;
+            inGap = false;
+            ++qi;
+        }
+        else {
+            score += inGap ? kGapExtend : kGapStart;
+            inGap = true;
+            inRun = false;
+        }
+    }
+
+    return score;
+}
+
+int fuzzyScore(std::string_view loweredQuery, std::string_view candidate,
+               std::string_view lowered, std::size_t nameStart)
+{
+    if (loweredQuery.empty()) return 0;
+
+    // "fm" should find filemanager_panel.h before f/.../m/...: try the name alone first.
+    if (nameStart > 0 && nameStart < lowered.size()) {
+        int s = scoreWindow(loweredQuery, candidate.substr(nameStart), lowered.substr(nameStart));
+        if (s != kFuzzyNoMatch) return s + kBonusName;
+    }
+    int s = scoreWindow(loweredQuery, candidate, lowered);
+    if (s != kFuzzyNoMatch && nameStart == 0) s += kBonusName;
+    return s;
+}
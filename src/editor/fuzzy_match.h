@@ -0,0 +1,32 @@
+// fuzzy_match.h
+#pragma once
+#include <climits>
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+// Subsequence ("fzf-style") matching shared by the quick-open palettes.
+//
+// Candidates are matched on a pre-lowered copy so the hot loop never
+// touches case folding; the original spelling is only consulted for the
+// camelCase bonus.  A candidate whose character mask does not cover the
+// query's mask cannot match and is rejected with a single AND.
+
+constexpr int kFuzzyNoMatch = INT_MIN;
+
+// ASCII lower-case copy; UTF-8 sequences pass through unchanged.
+std::string fuzzyLower(std::string_view text);
+
+// One bit per letter, digit and common separator present in `lowered`.
+std::uint64_t fuzzyMask(std::string_view lowered);
+
+inline bool fuzzyMaskCovers(std::uint64_t candidate, std::uint64_t query)
+{
+    return (candidate & query) == query;
+}
+
+// Higher is better; kFuzzyNoMatch when `loweredQuery` is not a subsequence.
+// `lowered` must be fuzzyLower(candidate).  Matches that start at or after
+// `nameStart` (e.g. the file name of a path) score a bonus.
+int fuzzyScore(std::string_view loweredQuery, std::string_view candidate,
+               std::string_view lowered, std::size_t nameStart = 0);
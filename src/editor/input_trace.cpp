@@ -0,0 +1,130 @@
+#include "input_trace.h"
+
+#include <cstdio>
+#include <fstream>
+#include <memory>
+
+namespace {
+    constexpr const char* kMagic = "mut-input-trace 1";
+
+    const char* KindName(InputEvent::Kind kind)
+    {
+        switch (kind) {
+        case InputEvent::Kind::Char:      return "char";
+        case InputEvent::Kind::Enter:     return "enter";
+        case InputEvent::Kind::Backspace: return "backspace";
+        case InputEvent::Kind::Paste:     return "paste";
+        case InputEvent::Kind::Type:      return "type";
+        }
+        return "?";
+    }
+
+    // "<count>\n<bytes>" as written after "content" / "paste" / "type".
+    bool ReadPayload(std::istream& in, std::string& out)
+    {
+        size_t size = 0;
+        if (!(in >> size) || in.get() != '\n')
+            return false;
+        out.resize(size);
+        return static_cast<bool>(in.read(out.data(), static_cast<std::streamsize>(size)));
+    }
+
+    std::unique_ptr<InputRecorder> g_recorder;
+}
+
+/*──────────────────────────────────────────────────────────*/
+/*                        trace file                        */
+bool InputTrace::Save(const std::string& file) const
+{
+    std::ofstream out(file, std::ios::binary);
+    out << kMagic << '\n'
+        << "path " << path << '\n'
+        << "content " << content.size() << '\n' << content << '\n';
+    for (const auto& e : events) {
+        out << e.time_us << ' ' << e.line << ' ' << e.column << ' '
+            << e.sel_line << ' ' << e.sel_column << ' ' << KindName(e.kind);
+        if (e.kind == InputEvent::Kind::Char)
+            out << ' ' << e.codepoint;
+        else if (e.kind == InputEvent::Kind::Paste || e.kind == InputEvent::Kind::Type)
+            out << ' ' << e.text.size() << '\n' << e.text;
+        out << '\n';
+    }
+    if (!out) {
+        std::fprintf(stderr, "[InputTrace] Cannot write '%s'\n", file.c_str());
+        return false;
+    }
+    return true;
+}
+
+bool InputTrace::Load(const std::string& file, InputTrace& out)
+{
+    std::ifstream in(file, std::ios::binary);
+    std::string   line, word;
+    if (!std::getline(in, line) || line != kMagic)
+        return false;
+
+    InputTrace trace;
+    if (!(in >> word) || word != "path" || in.get() != ' ' || !std::getline(in, trace.path))
+        return false;
+    if (!(in >> word) || word != "content" || !ReadPayload(in, trace.content))
+        return false;
+
+    InputEvent e;
+    while (in >> e.time_us >> e.line >> e.column >> e.sel_line >> e.sel_column >> word) {
+        e.codepoint = 0;
+        e.text.clear();
+        if (word == "char") {
+            e.kind = InputEvent::Kind::Char;
+            if (!(in >> e.codepoint)) return false;
+        }
+        else if (word == "enter")     e.kind = InputEvent::Kind::Enter;
+        else if (word == "backspace") e.kind = InputEvent::Kind::Backspace;
+        else if (word == "paste" || word == "type") {
+            e.kind = word == "paste" ? InputEvent::Kind::Paste : InputEvent::Kind::Type;
+            if (!ReadPayload(in, e.text)) return false;
+        }
+        else return false;
+        trace.events.push_back(e);
+    }
+    if (!in.eof())
+        return false;
+
+    out = std::move(trace);
+    return true;
+}
+
+/*──────────────────────────────────────────────────────────*/
+/*                         recorder                         */
+void InputRecorder::Start()
+{
+    if (!g_recorder) {
+        g_recorder = std::make_unique<InputRecorder>();
+        s_active_ = g_recorder.get();
+    }
+}
+
+bool InputRecorder::Stop(const std::string& file)
+{
+    if (!g_recorder) return true;
+    const bool ok = !g_recorder->bound_ || g_recorder->trace_.Save(file);
+    s_active_ = nullptr;
+    g_recorder.reset();
+    return ok;
+}
+
+bool InputRecorder::Bind(const std::string& path, std::string content)
+{
+    if (bound_) return trace_.path == path;
+    trace_.path = path;
+    trace_.content = std::move(content);
+    bound_ = true;
+    start_ = std::chrono::steady_clock::now();
+    return true;
+}
+
+void InputRecorder::Record(InputEvent event)
+{
+    event.time_us = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now() - start_).count());
+    trace_.events.push_back(std::move(event));
+}
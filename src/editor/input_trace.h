@@ -0,0 +1,80 @@
+#pragma once
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+/*---------------------------------------------------------------------------
+    Input traces – recorded editing sessions for latency replay.
+
+    A trace holds the buffer as it was before the first recorded keystroke
+    and every edit after it, with its time offset and the cursor / selection
+    it was made at.  mut_replay feeds the events back through TextEditor's
+    own edit paths (InsertChar, InsertTyped, InsertNewLine, DeleteChar,
+    PasteText).
+
+    File format (text header, raw length-prefixed payloads):
+
+        mut-input-trace 1
+        path <original path>
+        content <byte count>\n<bytes>
+        <t_us> <line> <col> <sel_line> <sel_col> char <codepoint>
+        <t_us> <line> <col> <sel_line> <sel_col> type <byte count>\n<bytes>
+        <t_us> <line> <col> <sel_line> <sel_col> enter
+        <t_us> <line> <col> <sel_line> <sel_col> backspace
+        <t_us> <line> <col> <sel_line> <sel_col> paste <byte count>\n<bytes>
+
+    sel_line / sel_col are -1 when there is no selection.  "type" is every
+    character typed in one frame, applied as a single edit.
+---------------------------------------------------------------------------*/
+struct InputEvent {
+    enum class Kind : uint8_t { Char, Enter, Backspace, Paste, Type };
+
+    Kind        kind = Kind::Char;
+    uint64_t    time_us = 0;           // since the first recorded event
+    int         line = 0, column = 0;  // cursor before the edit
+    int         sel_line = -1, sel_column = -1;
+    uint32_t    codepoint = 0;         // Char
+    std::string text;                  // Paste, Type
+};
+
+struct InputTrace {
+    std::string             path;
+    std::string             content;
+    std::vector<InputEvent> events;
+
+    bool Save(const std::string& file) const;
+    /// Returns false, leaving `out` untouched, if the file is unreadable or
+    /// malformed.
+    static bool Load(const std::string& file, InputTrace& out);
+};
+
+/*---------------------------------------------------------------------------
+    InputRecorder – process-wide recorder the editor view reports keystrokes
+    to.  Off unless Start() was called (the GUI does so when MUT_INPUT_TRACE
+    names an output file).  A trace covers one document: the first editor
+    that records binds it, edits in other tabs are ignored.
+---------------------------------------------------------------------------*/
+class InputRecorder {
+public:
+    /// The active recorder, or null when recording is off.
+    static InputRecorder* Active() { return s_active_; }
+    static void Start();
+    /// Write the trace (if anything was recorded) and stop recording.
+    static bool Stop(const std::string& file);
+
+    /// True if edits in `path` are being recorded.  The first call with
+    /// content binds the recorder to that document.
+    bool IsBoundTo(const std::string& path) const { return bound_ && trace_.path == path; }
+    bool Bind(const std::string& path, std::string content);
+
+    void Record(InputEvent event);
+
+private:
+    static inline InputRecorder* s_active_ = nullptr;
+
+    InputTrace trace_;
+    bool       bound_ = false;
+    std::chrono::steady_clock::time_point start_;
+};
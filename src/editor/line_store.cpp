@@ -0,0 +1,219 @@
+#include "line_store.h"
+
+#include <algorithm>
+#include <iterator>
+
+#include "memory_usage.h"
+
+void LineStore::Assign(const FileSnapshot::Ptr& snapshot, bool lazy)
+{
+    pieces_.clear();
+    Piece piece;
+    if (lazy) {
+        snapshot_ = snapshot;
+        piece.owned = false;
+        piece.first = 0;
+        piece.count = snapshot->LineCount();
+    }
+    else {
+        snapshot_.reset();
+        piece.lines.reserve(snapshot->LineCount());
+        for (size_t i = 0; i < snapshot->LineCount(); ++i)
+            piece.lines.emplace_back(snapshot->Line(i));
+    }
+    pieces_.push_back(std::move(piece));
+    Normalize();
+}
+
+void LineStore::Assign(std::vector<std::string>&& lines)
+{
+    snapshot_.reset();
+    pieces_.clear();
+    Piece piece;
+    piece.lines = std::move(lines);
+    pieces_.push_back(std::move(piece));
+    Normalize();
+}
+
+std::pair<size_t, size_t> LineStore::Locate(size_t index) const
+{
+    if (pieces_.size() == 1) return { 0, index };   // the common, fully-owned case
+    auto it = std::upper_bound(piece_starts_.begin(), piece_starts_.end(), index);
+    size_t p = static_cast<size_t>(std::distance(piece_starts_.begin(), it)) - 1;
+    return { p, index - piece_starts_[p] };
+}
+
+std::string_view LineStore::View(size_t index) const
+{
+    auto [p, offset] = Locate(index);
+    const Piece& piece = pieces_[p];
+    if (piece.owned) return piece.lines[offset];
+    return snapshot_->Line(piece.first + offset);
+}
+
+std::string& LineStore::operator[](size_t index)
+{
+    auto [p, offset] = Locate(index);
+    if (pieces_[p].owned) return pieces_[p].lines[offset];
+
+    SplitOut(p, offset);
+    auto [q, at] = Locate(index);
+    return pieces_[q].lines[at];
+}
+
+size_t LineStore::SplitOut(size_t p, size_t offset)
+{
+    const Piece src = pieces_[p];
+
+    Piece before;
+    before.owned = false;
+    before.first = src.first;
+    before.count = offset;
+
+    Piece line;
+    line.lines.emplace_back(snapshot_->Line(src.first + offset));
+
+    Piece after;
+    after.owned = false;
+    after.first = src.first + offset + 1;
+    after.count = src.count - offset - 1;
+
+    pieces_[p] = std::move(before);
+    pieces_.insert(pieces_.begin() + p + 1, std::move(line));
+    pieces_.insert(pieces_.begin() + p + 2, std::move(after));
+    Normalize();
+    return p + 1;
+}
+
+void LineStore::insert(size_t index, std::string line)
+{
+    std::vector<std::string> one;
+    one.push_back(std::move(line));
+    insert(index, std::move(one));
+}
+
+void LineStore::insert(size_t index, std::vector<std::string> lines)
+{
+    if (lines.empty()) return;
+
+    if (pieces_.empty()) {
+        Piece piece;
+        piece.lines = std::move(lines);
+        pieces_.push_back(std::move(piece));
+        Normalize();
+        return;
+    }
+
+    if (index >= line_count_) {
+        if (!pieces_.back().owned) pieces_.emplace_back();
+        auto& tail = pieces_.back().lines;
+        tail.insert(tail.end(), std::make_move_iterator(lines.begin()), std::make_move_iterator(lines.end()));
+        Normalize();
+        return;
+    }
+
+    auto [p, offset] = Locate(index);
+    if (pieces_[p].owned) {
+        auto& owned = pieces_[p].lines;
+        owned.insert(owned.begin() + offset, std::make_move_iterator(lines.begin()), std::make_move_iterator(lines.end()));
+        Normalize();
+        return;
+    }
+
+    // Inside a snapshot run: cut it in two and put the new lines in between.
+    Piece added;
+    added.lines = std::move(lines);
+    if (offset == 0) {
+        pieces_.insert(pieces_.begin() + p, std::move(added));
+    }
+    else {
+        Piece tail;
+        tail.owned = false;
+        tail.first = pieces_[p].first + offset;
+        tail.count = pieces_[p].count - offset;
+        pieces_[p].count = offset;
+        pieces_.insert(pieces_.begin() + p + 1, std::move(added));
+        pieces_.insert(pieces_.begin() + p + 2, std::move(tail));
+    }
+    Normalize();
+}
+
+void LineStore::erase(size_t index, size_t count)
+{
+    count = std::min(count, line_count_ > index ? line_count_ - index : 0);
+    while (count > 0) {
+        auto [p, offset] = Locate(index);
+        Piece& piece = pieces_[p];
+        const size_t n = std::min(count, piece.size() - offset);
+
+        if (piece.owned) {
+            piece.lines.erase(piece.lines.begin() + offset,
+                piece.lines.begin() + offset + n);
+        }
+        else if (offset == 0) {
+            piece.first += n;
+            piece.count -= n;
+        }
+        else if (offset + n == piece.count) {
+            piece.count -= n;
+        }
+        else {
+            Piece tail;
+            tail.owned = false;
+            tail.first = piece.first + offset + n;
+            tail.count = piece.count - offset - n;
+            piece.count = offset;
+            pieces_.insert(pieces_.begin() + p + 1, std::move(tail));
+        }
+
+        count -= n;
+        Normalize();
+    }
+}
+
+size_t LineStore::MaterializedCount() const
+{
+    size_t n = 0;
+    for (const auto& piece : pieces_)
+        if (piece.owned) n += piece.lines.size();
+    return n;
+}
+
+void LineStore::Normalize()
+{
+    std::vector<Piece> merged;
+    merged.reserve(pieces_.size());
+    for (auto& piece : pieces_) {
+        if (piece.size() == 0) continue;
+        if (!merged.empty()) {
+            Piece& prev = merged.back();
+            if (prev.owned && piece.owned) {
+                prev.lines.insert(prev.lines.end(),
+                    std::make_move_iterator(piece.lines.begin()),
+                    std::make_move_iterator(piece.lines.end()));
+                continue;
+            }
+            if (!prev.owned && !piece.owned && prev.first + prev.count == piece.first) {
+                prev.count += piece.count;
+                continue;
+            }
+        }
+        merged.push_back(std::move(piece));
+    }
+    pieces_.swap(merged);
+
+    piece_starts_.resize(pieces_.size());
+    line_count_ = 0;
+    for (size_t i = 0; i < pieces_.size(); ++i) {
+        piece_starts_[i] = line_count_;
+        line_count_ += pieces_[i].size();
+    }
+}
+
+size_t LineStore::OwnedBytes() const
+{
+    size_t bytes = pieces_.capacity() * sizeof(Piece) + mem::HeapBytes(piece_starts_);
+    for (const Piece& piece : pieces_)
+        bytes += mem::HeapBytes(piece.lines);
+    return bytes;
+}
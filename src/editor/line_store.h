@@ -0,0 +1,70 @@
+#pragma once
+#include <cstddef>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "file_snapshot.h"
+
+/*---------------------------------------------------------------------------
+    LineStore – the editor's line buffer.
+
+    Lines live in a short list of pieces.  A piece is either a run of lines
+    that still point into a FileSnapshot, or a run of owned std::strings.
+    Small files are loaded fully owned (one piece, same cost as the old
+    std::vector<std::string>).  Large files start as a single snapshot piece
+    and a line is only copied into an owned piece when it is written to.
+
+      • View(i)       – read access, never copies or allocates.
+      • operator[](i) – write access, materializes the line first.
+---------------------------------------------------------------------------*/
+class LineStore {
+public:
+    LineStore() = default;
+
+    /// Replace the content with the lines of `snapshot`.  With `lazy` the
+    /// lines stay in the mapping until they are written to.
+    void Assign(const FileSnapshot::Ptr& snapshot, bool lazy);
+    void Assign(std::vector<std::string>&& lines);
+
+    size_t size() const { return line_count_; }
+    bool   empty() const { return line_count_ == 0; }
+
+    std::string_view View(size_t index) const;
+    std::string&     operator[](size_t index);      // materializes
+
+    void push_back(std::string line) { insert(line_count_, std::move(line)); }
+    void insert(size_t index, std::string line);
+    void insert(size_t index, std::vector<std::string> lines);   // one block
+    void erase(size_t index, size_t count = 1);
+
+    /// Number of lines held as owned strings (== size() for small files).
+    size_t MaterializedCount() const;
+    bool   IsLazy() const { return snapshot_ != nullptr; }
+    /// Heap bytes of the owned lines and the piece table (the snapshot's
+    /// mapping is not included).
+    size_t OwnedBytes() const;
+
+private:
+    struct Piece {
+        bool                     owned = true;
+        size_t                   first = 0;   // first snapshot line (!owned)
+        size_t                   count = 0;   // line count (!owned)
+        std::vector<std::string> lines;       // materialized lines (owned)
+
+        size_t size() const { return owned ? lines.size() : count; }
+    };
+
+    // Piece holding `index` and the offset inside it.
+    std::pair<size_t, size_t> Locate(size_t index) const;
+    // Split the snapshot piece `p` so that line `offset` becomes an owned
+    // piece of its own; returns the index of that piece.
+    size_t SplitOut(size_t p, size_t offset);
+    void   Normalize();   // drop empty pieces, merge owned neighbours, reindex
+
+    FileSnapshot::Ptr   snapshot_;
+    std::vector<Piece>  pieces_;
+    std::vector<size_t> piece_starts_;   // first line index of every piece
+    size_t              line_count_ = 0;
+};
@@ -0,0 +1,64 @@
+#pragma once
+#include <cstddef>
+#include <map>
+#include <string>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+/*---------------------------------------------------------------------------
+    Heap size estimates for the memory accounting view.
+
+    Containers are charged for their capacity, not their size, and node
+    based containers for a few pointers of bookkeeping per node.  The
+    numbers are good for ranking caches against each other, they do not
+    match the allocator byte for byte.
+---------------------------------------------------------------------------*/
+namespace mem {
+
+template <class T> size_t HeapBytes(const T&) { return 0; }   // no heap of its own
+inline size_t HeapBytes(const std::string& s);
+template <class A, class B> size_t HeapBytes(const std::pair<A, B>& p);
+template <class T, class Al> size_t HeapBytes(const std::vector<T, Al>& v);
+template <class K, class V, class C, class Al> size_t HeapBytes(const std::map<K, V, C, Al>& m);
+template <class K, class V, class H, class E, class Al> size_t HeapBytes(const std::unordered_map<K, V, H, E, Al>& m);
+
+inline size_t HeapBytes(const std::string& s)
+{
+    static const size_t kInline = std::string().capacity();   // small-string buffer
+    return s.capacity() > kInline ? s.capacity() + 1 : 0;
+}
+
+template <class A, class B>
+size_t HeapBytes(const std::pair<A, B>& p) { return HeapBytes(p.first) + HeapBytes(p.second); }
+
+template <class T, class Al>
+size_t HeapBytes(const std::vector<T, Al>& v)
+{
+    size_t bytes = v.capacity() * sizeof(T);
+    if constexpr (!std::is_trivially_copyable_v<T>)
+        for (const auto& x : v) bytes += HeapBytes(x);
+    return bytes;
+}
+
+template <class K, class V, class C, class Al>
+size_t HeapBytes(const std::map<K, V, C, Al>& m)
+{
+    constexpr size_t kNode = 4 * sizeof(void*);   // colour + parent/left/right
+    size_t bytes = m.size() * (sizeof(std::pair<const K, V>) + kNode);
+    for (const auto& kv : m) bytes += HeapBytes(kv.first) + HeapBytes(kv.second);
+    return bytes;
+}
+
+template <class K, class V, class H, class E, class Al>
+size_t HeapBytes(const std::unordered_map<K, V, H, E, Al>& m)
+{
+    constexpr size_t kNode = 2 * sizeof(void*);   // next link + cached hash
+    size_t bytes = m.bucket_count() * sizeof(void*)
+        + m.size() * (sizeof(std::pair<const K, V>) + kNode);
+    for (const auto& kv : m) bytes += HeapBytes(kv.first) + HeapBytes(kv.second);
+    return bytes;
+}
+
+} // namespace mem
@@ -0,0 +1,23 @@
+#include "string_pool.h"
+
+#include <algorithm>
+#include <cstring>
+
+uint32_t StringPool::Intern(std::string_view s)
+{
+    if (auto it = ids_.find(s); it != ids_.end())
+        return it->second;
+
+    if (block_used_ + s.size() > kBlockSize) {
+        blocks_.push_back(std::make_unique<char[]>(std::max(kBlockSize, s.size())));
+        block_used_ = 0;
+    }
+    char* dst = blocks_.back().get() + block_used_;
+    if (!s.empty()) std::memcpy(dst, s.data(), s.size());
+    block_used_ += s.size();
+
+    const uint32_t id = static_cast<uint32_t>(strings_.size());
+    strings_.emplace_back(dst, s.size());
+    ids_.emplace(strings_.back(), id);
+    return id;
+}
@@ -0,0 +1,24 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+/// Append-only string interner.  Text lives in fixed-size blocks so the
+/// views handed out (and used as map keys) never move.
+class StringPool {
+public:
+    uint32_t         Intern(std::string_view s);
+    std::string_view Get(uint32_t id) const { return strings_[id]; }
+    size_t           size() const { return strings_.size(); }
+
+private:
+    static constexpr size_t kBlockSize = 64 * 1024;
+
+    std::vector<std::unique_ptr<char[]>>          blocks_;
+    size_t                                        block_used_ = kBlockSize;
+    std::vector<std::string_view>                 strings_;
+    std::unordered_map<std::string_view, uint32_t> ids_;
+};
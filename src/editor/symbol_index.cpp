@@ -0,0 +1,145 @@
+#include "symbol_index.h"
+
+#include <algorithm>
+#include <cstring>
+
+#include "fuzzy_match.h"
+
+namespace {
+    // Prefix matches outrank every fuzzy score; among them shorter names
+    // (closer to an exact match) come first.
+    constexpr int kPrefixTier = 1 << 20;
+}
+
+/*──────────────────────────────────────────────────────────*/
+/*                         updates                          */
+uint32_t SymbolIndex::InternName(std::string_view name)
+{
+    const uint32_t id = names_.Intern(name);
+    if (id == names_mask_.size()) {
+        std::string lowered = fuzzyLower(name);
+        names_lowered_ += lowered;
+        names_lowered_at_.push_back(static_cast<uint32_t>(names_lowered_.size()));
+        names_mask_.push_back(fuzzyMask(lowered));
+        names_uses_.push_back(0);
+    }
+    return id;
+}
+
+void SymbolIndex::RemoveFile(const std::string& path)
+{
+    auto it = file_ids_.find(path);
+    if (it == file_ids_.end()) return;
+
+    FileEntries& file = files_[it->second];
+    for (uint32_t name : file.names) --names_uses_[name];
+    entry_count_ -= file.entries.size();
+    file.names = {};
+    file.entries = {};
+    ++generation_;
+}
+
+void SymbolIndex::UpdateFile(const std::string& path, const std::vector<Symbol>& symbols)
+{
+    RemoveFile(path);
+
+    auto [it, inserted] = file_ids_.try_emplace(path, static_cast<uint32_t>(files_.size()));
+    if (inserted) files_.push_back({ path, {}, {} });
+    FileEntries& file = files_[it->second];
+
+    file.names.reserve(symbols.size());
+    file.entries.reserve(symbols.size());
+    for (const Symbol& s : symbols) {
+        std::string_view full = s.name;
+        size_t sep = full.rfind("::");
+        std::string_view name = (sep == std::string_view::npos) ? full : full.substr(sep + 2);
+
+        const uint32_t name_id = InternName(name);
+        ++names_uses_[name_id];
+        file.names.push_back(name_id);
+
+        Entry e;
+        e.qualified = qualified_.Intern(full);
+        e.kind = s.kind;
+        e.line = s.line;
+        e.column = s.column;
+        file.entries.push_back(e);
+    }
+    entry_count_ += file.entries.size();
+    ++generation_;
+}
+
+/*──────────────────────────────────────────────────────────*/
+/*                          query                           */
+std::vector<SymbolIndex::Hit> SymbolIndex::Query(std::string_view text, size_t limit) const
+{
+    std::vector<Hit> hits;
+
+    // "ns::Foo" searches for Foo; spaces are ignored like in Go to File.
+    if (size_t sep = text.rfind("::"); sep != std::string_view::npos) text.remove_prefix(sep + 2);
+    std::string q = fuzzyLower(text);
+    q.erase(std::remove(q.begin(), q.end(), ' '), q.end());
+    if (q.empty() || limit == 0) return hits;
+
+    // 1) score every distinct live name once
+    const uint64_t qmask = fuzzyMask(q);
+    const size_t   name_count = names_mask_.size();
+    name_scores_.resize(name_count);
+    name_hits_.clear();
+    for (size_t id = 0; id < name_count; ++id) {
+        if (!fuzzyMaskCovers(names_mask_[id], qmask) || names_uses_[id] == 0) continue;
+
+        std::string_view lowered = Lowered(static_cast<uint32_t>(id));
+        int score = lowered.starts_with(q)
+            ? kPrefixTier - static_cast<int>(lowered.size())
+            : fuzzyScore(q, names_.Get(static_cast<uint32_t>(id)), lowered);
+        if (score == kFuzzyNoMatch) continue;
+        name_scores_[id] = score;
+        name_hits_.push_back(static_cast<uint32_t>(id));
+    }
+    if (name_hits_.empty()) return hits;
+
+    // 2) every name carries at least one entry, so the best `limit` names
+    //    are enough to fill the result; their lowest score is the cut.
+    auto by_score = [this](uint32_t a, uint32_t b) { return name_scores_[a] > name_scores_[b]; };
+    const size_t top = std::min(limit, name_hits_.size());
+    std::partial_sort(name_hits_.begin(), name_hits_.begin() + top, name_hits_.end(), by_score);
+    int    cut = name_scores_[name_hits_[top - 1]];
+    size_t carried = 0;
+    for (size_t i = 0; i < top; ++i) {
+        carried += names_uses_[name_hits_[i]];
+        if (carried >= limit) { cut = name_scores_[name_hits_[i]]; break; }
+    }
+
+    // 3) collect the entries that made the cut: a byte per name keeps the
+    //    lookup table small enough to stay in cache during the scan
+    name_taken_.assign(name_count, 0);
+    for (uint32_t id : name_hits_)
+        if (name_scores_[id] >= cut) name_taken_[id] = 1;
+
+    // Everything above the cut is needed; ties at the cut only until the
+    // result could be full, or a one-letter query drags in half the index.
+    size_t at_cut = 0;
+    for (uint32_t f = 0; f < files_.size(); ++f) {
+        const std::vector<uint32_t>& names = files_[f].names;
+        for (uint32_t i = 0; i < names.size(); ++i) {
+            if (!name_taken_[names[i]]) continue;
+            const int score = name_scores_[names[i]];
+            if (score == cut && at_cut++ >= limit) continue;
+            hits.push_back({ f, i, score });
+        }
+    }
+
+    auto better = [this](const Hit& a, const Hit& b) {
+        if (a.score != b.score) return a.score > b.score;
+        return QualifiedName(a).size() < QualifiedName(b).size();
+    };
+    if (hits.size() > limit) {
+        std::partial_sort(hits.begin(), hits.begin() + limit, hits.end(), better);
+        hits.resize(limit);
+    }
+    else {
+        std::sort(hits.begin(), hits.end(), better);
+    }
+    return hits;
+}
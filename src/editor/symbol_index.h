@@ -0,0 +1,85 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include "clang_indexer.h"   // Symbol
+#include "string_pool.h"
+
+/*---------------------------------------------------------------------------
+    SymbolIndex – every symbol the indexer has produced, for workspace-wide
+    "Go to Symbol" (Ctrl+T).
+
+    Names are interned and entries are grouped per file; an entry is 16
+    bytes (name id, location, kind), so a million symbols cost a few tens
+    of MB.  Queries match the unqualified name: each distinct name is scored
+    once (prefix matches first, then fuzzy) behind the same character-mask
+    prefilter the Go to File palette uses, and only entries whose name made
+    the cut are collected.
+
+      • UpdateFile(path, symbols) – replace everything known about a file.
+      • Query(text, limit)        – best matches, best first.
+---------------------------------------------------------------------------*/
+class SymbolIndex {
+public:
+    struct Hit {
+        uint32_t file;
+        uint32_t entry;   // within the file
+        int      score;
+    };
+
+    void UpdateFile(const std::string& path, const std::vector<Symbol>& symbols);
+    void RemoveFile(const std::string& path);
+
+    std::vector<Hit> Query(std::string_view text, size_t limit) const;
+
+    size_t             size() const { return entry_count_; }
+    uint64_t           Generation() const { return generation_; }   // bumped on every update; Hits die with it
+    std::string_view   QualifiedName(const Hit& h) const { return qualified_.Get(At(h).qualified); }
+    std::string_view   Kind(const Hit& h) const { return SymbolKindName(At(h).kind); }
+    const std::string& File(const Hit& h) const { return files_[h.file].path; }
+    int                Line(const Hit& h) const { return At(h).line; }     // 1-based
+    int                Column(const Hit& h) const { return At(h).column; } // 1-based
+
+private:
+    struct Entry {
+        uint32_t   qualified;   // in qualified_
+        int32_t    line;
+        int32_t    column;
+        SymbolKind kind;
+    };
+
+    /// Entries are kept per file so replacing one file never touches the
+    /// rest.  Name ids sit in their own array: it is all a query scans.
+    struct FileEntries {
+        std::string           path;
+        std::vector<uint32_t> names;     // unqualified, in names_
+        std::vector<Entry>    entries;
+    };
+
+    const Entry&     At(const Hit& h) const { return files_[h.file].entries[h.entry]; }
+    uint32_t         InternName(std::string_view name);
+    std::string_view Lowered(uint32_t name) const
+    {
+        return std::string_view(names_lowered_).substr(names_lowered_at_[name], names_lowered_at_[name + 1] - names_lowered_at_[name]);
+    }
+
+    StringPool                                names_;
+    std::string                               names_lowered_;     // all names, lowered, back to back
+    std::vector<uint32_t>                     names_lowered_at_{ 0 };
+    std::vector<uint64_t>                     names_mask_;     // per name id
+    std::vector<uint32_t>                     names_uses_;     // per name id: live entries carrying it
+    StringPool                                qualified_;
+    std::vector<FileEntries>                  files_;
+    std::unordered_map<std::string, uint32_t> file_ids_;
+    size_t                                    entry_count_ = 0;
+    uint64_t                                  generation_ = 0;
+
+    mutable std::vector<int>                  name_scores_;    // scratch for Query
+    mutable std::vector<uint32_t>             name_hits_;      // scratch for Query
+    mutable std::vector<uint8_t>              name_taken_;     // scratch for Query
+};
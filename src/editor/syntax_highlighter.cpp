@@ -8,7 +8,13 @@
 #include <cassert>
 #include <functional>
 #include <span>
+#include <cstring>
+#include <mutex>
 #include <text_editor.h>
+#include "clang_indexer.h"
+#include "file_snapshot.h"
+#include "platform/trace.h"
+#include "tags_queries.h"
 
 // Link to your language grammar here
 extern "C" const TSLanguage* tree_sitter_c();
@@ -98,13 +104,15 @@ void SaveTokenColorsToFile(const std::string& filename) {
     out << "}\n";
 }
 
-ImVec4 GetSemanticColor(const std::string& kind) {
-    if (kind == "FunctionDecl")    return ImVec4(1.00f, 0.80f, 0.30f, 1.0f);
-    if (kind == "VarDecl")         return ImVec4(0.85f, 0.85f, 0.60f, 1.0f);
-    if (kind == "ParmDecl")        return ImVec4(0.70f, 0.90f, 0.90f, 1.0f);
-    if (kind == "FieldDecl")       return ImVec4(0.60f, 0.90f, 0.60f, 1.0f);
-    if (kind == "MemberRefExpr")   return ImVec4(0.60f, 0.70f, 1.00f, 1.0f);
-    return GetColorForCapture(TokenType::Default);
+ImVec4 GetSemanticColor(SemanticKind kind) {
+    switch (kind) {
+    case SemanticKind::Function:  return ImVec4(1.00f, 0.80f, 0.30f, 1.0f);
+    case SemanticKind::Variable:  return ImVec4(0.85f, 0.85f, 0.60f, 1.0f);
+    case SemanticKind::Parameter: return ImVec4(0.70f, 0.90f, 0.90f, 1.0f);
+    case SemanticKind::Field:     return ImVec4(0.60f, 0.90f, 0.60f, 1.0f);
+    case SemanticKind::Member:    return ImVec4(0.60f, 0.70f, 1.00f, 1.0f);
+    default:                      return GetColorForCapture(TokenType::Default);
+    }
 }
 // --- Helper: classify_number_literal (unchanged, but returns TokenType) ---
 std::vector<std::pair<std::string, TokenType>> classify_number_literal(const std::string& token) {
@@ -323,58 +331,150 @@ void regex_colorization(
     }
 }
 
+/*──────────────────────────────────────────────────────────*/
+/*                        parser pool                        */
+// TSParser is not thread-safe, so a parse checks one out of a process-wide
+// pool and hands it back when done.  Highlight jobs run on std::async
+// threads, which libstdc++ never reuses, so a per-thread cache would build
+// a parser per job; the shared pool keeps them across jobs while jobs of
+// different documents still parse in parallel on parsers of their own.
+// Never destroyed, like the TU cache: jobs may finish during static
+// destruction.
+namespace {
+    class PooledParser {
+    public:
+        explicit PooledParser(const TSLanguage* language) : language_(language) {
+            {
+                std::lock_guard<std::mutex> lock(Mutex());
+                auto& idle = Idle();
+                for (auto it = idle.begin(); it != idle.end(); ++it)
+                    if (it->first == language) {
+                        parser_ = it->second;
+                        idle.erase(it);
+                        return;
+                    }
+            }
+            parser_ = ts_parser_new();
+            ts_parser_set_language(parser_, language);
+        }
+        ~PooledParser() {
+            std::lock_guard<std::mutex> lock(Mutex());
+            Idle().push_back({ language_, parser_ });
+        }
+        PooledParser(const PooledParser&) = delete;
+        PooledParser& operator=(const PooledParser&) = delete;
+
+        operator TSParser*() const { return parser_; }
+
+    private:
+        static std::vector<std::pair<const TSLanguage*, TSParser*>>& Idle() {
+            static auto& idle = *new std::vector<std::pair<const TSLanguage*, TSParser*>>;
+            return idle;
+        }
+        static std::mutex& Mutex() {
+            static auto& mutex = *new std::mutex;
+            return mutex;
+        }
+
+        const TSLanguage* language_;
+        TSParser*         parser_ = nullptr;
+    };
+}
+
+SyntaxHighlighter::ParseState::~ParseState()
+{
+    Reset();
+}
+
+void SyntaxHighlighter::ParseState::Reset()
+{
+    if (tree_) ts_tree_delete(tree_);
+    tree_ = nullptr;
+    code_size_ = 0;
+}
+
+// Everything in here is immutable after construction, so one Impl is
+// shared by all documents of a language and by all threads.
 struct SyntaxHighlighter::Impl {
-    TSParser* parser = nullptr;
-    TSTree* tree = nullptr;
     const TSLanguage* language = nullptr;
     std::string Llang;
-    std::string last_code;  // Cache last code for incremental updates
+
+    // What a capture of the tags query stands for.
+    enum class TagRole : uint8_t { None, Name, Class, Function, Method, Type };
+
+    TSQuery* tags = nullptr;              // tags_<lang>.scm; null for other languages
+    std::vector<TagRole> tag_roles;       // by capture id
 
     Impl(const std::string& lang) {
-        parser = ts_parser_new();
         if (lang == "c") language = tree_sitter_c();
         else if (lang == "cpp") language = tree_sitter_cpp();
-        ts_parser_set_language(parser, language);
         Llang = lang;
-
+        CompileTagsQuery(lang == "c" ? kTagsCQuery : lang == "cpp" ? kTagsCppQuery : nullptr);
     }
 
     ~Impl() {
-        if (tree) ts_tree_delete(tree);
-        ts_parser_delete(parser);
+        if (tags) ts_query_delete(tags);
     }
 
-    std::string LoadFile(const std::string& path) {
-        std::ifstream file(path, std::ios::binary);
-        std::stringstream buf;
-        buf << file.rdbuf();
-        std::string txt = buf.str();
-        const unsigned char bom[3] = { 0xEF, 0xBB, 0xBF };
-        if (txt.size() >= 3 &&
-            (unsigned char)txt[0] == bom[0] &&
-            (unsigned char)txt[1] == bom[1] &&
-            (unsigned char)txt[2] == bom[2])
-        {
-            txt.erase(0, 3);
+    void CompileTagsQuery(const char* source) {
+        if (!language || !source) return;
+        uint32_t error_offset = 0;
+        TSQueryError error = TSQueryErrorNone;
+        tags = ts_query_new(language, source, static_cast<uint32_t>(std::strlen(source)), &error_offset, &error);
+        if (!tags) {
+            MUT_TRACE(trace::Level::Error, "HIGHLIGHT", "TagsQuery",
+                "%s tags query rejected at byte %u (error %d)",
+                Llang.c_str(), error_offset, static_cast<int>(error));
+            return;
+        }
+
+        static const std::unordered_map<std::string_view, TagRole> roles = {
+            {"name", TagRole::Name},
+            {"definition.class", TagRole::Class},
+            {"definition.function", TagRole::Function},
+            {"definition.method", TagRole::Method},
+            {"definition.type", TagRole::Type},
+        };
+        tag_roles.resize(ts_query_capture_count(tags), TagRole::None);
+        for (uint32_t id = 0; id < tag_roles.size(); ++id) {
+            uint32_t length = 0;
+            const char* name = ts_query_capture_name_for_id(tags, id, &length);
+            if (auto it = roles.find(std::string_view(name, length)); it != roles.end())
+                tag_roles[id] = it->second;
         }
-        return txt;
     }
 
-    std::vector<TokenType> paren_colors = {
+    std::string LoadFile(const std::string& path) {
+        // The snapshot already skips a UTF-8 BOM.
+        return std::string(FileSnapshot::Open(path)->Text());
+    }
+
+    const std::vector<TokenType> paren_colors = {
         TokenType::Paren1, TokenType::Paren2, TokenType::Paren3, TokenType::Paren4,
         TokenType::Paren5, TokenType::Paren6, TokenType::Paren7, TokenType::Paren8
     };
 
-    std::vector<SyntaxToken> Highlight(const std::string& code) {
+    // Parse `code` from scratch on a pooled parser; no tree is kept.
+    // Also used for slices of a document (large-file window): token lines
+    // are shifted by `first_line` so they address the full document.
+    std::vector<SyntaxToken> Highlight(std::string_view code, int first_line = 0) {
+        if (!language) return {};
+        TSTree* tree = ts_parser_parse_string(PooledParser(language), nullptr, code.data(), static_cast<uint32_t>(code.size()));
+        if (!tree) return {};
+        std::vector<SyntaxToken> tokens = CollectTokens(ts_tree_root_node(tree), code);
+        ts_tree_delete(tree);
+
+        if (first_line != 0)
+            for (auto& tok : tokens)
+                tok.line += first_line;
+        return tokens;
+    }
+
+    std::vector<SyntaxToken> CollectTokens(TSNode root, std::string_view code) {
         // Reserve a reasonable amount to avoid reallocations
         std::vector<SyntaxToken> tokens;
         tokens.reserve(code.size() / 4);
 
-        if (tree) ts_tree_delete(tree);
-        tree = ts_parser_parse_string(parser, nullptr, code.c_str(), code.size());
-        if (!tree) return tokens;
-        TSNode root = ts_tree_root_node(tree);
-
         std::vector<TokenType> paren_stack;
         std::vector<TokenType> brace_stack;
 
@@ -620,10 +720,13 @@ struct SyntaxHighlighter::Impl {
         return tokens;
     }
 
-    std::vector<SyntaxToken> HighlightIncremental(const std::string& code, const std::vector<TextEdit>& edits) {
-        // If we have a tree and edits, update incrementally
-        if (tree && !edits.empty() && code.size() > 0 && last_code.size() > 0) {
-            // Apply edits to the tree
+    std::vector<SyntaxToken> HighlightIncremental(ParseState& state, std::string_view code, const std::vector<TextEdit>& edits) {
+        if (!language) return {};
+
+        // With a tree and edits, update the document's tree and let the
+        // parser reuse it; otherwise parse from scratch.
+        TSTree* old_tree = nullptr;
+        if (state.tree_ && !edits.empty() && code.size() > 0 && state.code_size_ > 0) {
             for (const auto& edit : edits) {
                 TSInputEdit ts_edit;
                 ts_edit.start_byte = edit.start_byte;
@@ -633,39 +736,131 @@ struct SyntaxHighlighter::Impl {
                 ts_edit.old_end_point = edit.old_end_point;
                 ts_edit.new_end_point = edit.new_end_point;
 
-                ts_tree_edit(tree, &ts_edit);
-            }
-
-            // Reparse incrementally
-            TSTree* new_tree = ts_parser_parse_string(parser, tree, code.c_str(), code.size());
-            if (new_tree) {
-                ts_tree_delete(tree);
-                tree = new_tree;
+                ts_tree_edit(state.tree_, &ts_edit);
             }
-        }
-        else {
-            // Full reparse
-            if (tree) ts_tree_delete(tree);
-            tree = ts_parser_parse_string(parser, nullptr, code.c_str(), code.size());
+            old_tree = state.tree_;
         }
 
-        last_code = code;
+        TSTree* tree = ts_parser_parse_string(PooledParser(language), old_tree, code.data(), static_cast<uint32_t>(code.size()));
+        state.Reset();
+        state.tree_ = tree;
+        state.code_size_ = code.size();
 
-        // Now perform highlighting with the updated tree
         if (!tree) return {};
+        return CollectTokens(ts_tree_root_node(tree), code);
+    }
 
-        std::vector<SyntaxToken> tokens;
-        tokens.reserve(code.size() / 4);
+    SymbolList Outline(const ParseState& state, std::string_view code) const {
+        SymbolList symbols;
+        if (!tags || !state.tree_ || state.code_size_ != code.size()) return symbols;
 
-        TSNode root = ts_tree_root_node(tree);
+        auto text = [&](TSNode node) {
+            const uint32_t start = ts_node_start_byte(node);
+            return code.substr(start, ts_node_end_byte(node) - start);
+        };
+        auto has_body = [](TSNode node) {
+            return !ts_node_is_null(ts_node_child_by_field_name(node, "body", 4));
+        };
 
-        // Reuse the existing highlighting logic
-        std::vector<TokenType> paren_stack;
-        std::vector<TokenType> brace_stack;
+        TSQueryCursor* cursor = ts_query_cursor_new();
+        ts_query_cursor_exec(cursor, tags, ts_tree_root_node(state.tree_));
+
+        TSQueryMatch match;
+        std::vector<std::string_view> scopes;
+        std::string qualified;
+        while (ts_query_cursor_next_match(cursor, &match)) {
+            TSNode name{}, definition{};
+            TagRole role = TagRole::None;
+            for (uint16_t i = 0; i < match.capture_count; ++i) {
+                const TagRole r = tag_roles[match.captures[i].index];
+                if (r == TagRole::Name) name = match.captures[i].node;
+                else if (r != TagRole::None) { definition = match.captures[i].node; role = r; }
+            }
+            if (ts_node_is_null(name) || ts_node_is_null(definition)) continue;
+
+            // Enclosing named namespaces and classes; anonymous ones are
+            // transparent, as in the libclang outline.  Nothing inside a
+            // function body belongs in an outline.
+            scopes.clear();
+            bool local = false;
+            for (TSNode p = ts_node_parent(definition); !ts_node_is_null(p) && !local; p = ts_node_parent(p)) {
+                std::string_view type(ts_node_type(p));
+                if (type == "compound_statement")
+                    local = true;
+                else if (type == "namespace_definition" || type == "class_specifier"
+                    || type == "struct_specifier" || type == "union_specifier") {
+                    TSNode scope_name = ts_node_child_by_field_name(p, "name", 4);
+                    if (!ts_node_is_null(scope_name)) scopes.push_back(text(scope_name));
+                }
+            }
+            if (local) continue;
+
+            // An out-of-line member keeps its written qualifier ("Type::member").
+            TSNode written = name;
+            for (TSNode p = ts_node_parent(written);
+                 !ts_node_is_null(p) && std::string_view(ts_node_type(p)) == "qualified_identifier";
+                 p = ts_node_parent(p))
+                written = p;
+
+            SymbolKind kind = SymbolKind::Other;
+            bool is_definition = true;
+            switch (role) {
+            case TagRole::Class: {
+                const TSNode specifier = ts_node_parent(name);
+                const std::string_view type(ts_node_type(specifier));
+                kind = type == "struct_specifier" ? SymbolKind::Struct
+                     : type == "union_specifier"  ? SymbolKind::Union : SymbolKind::Class;
+                is_definition = has_body(specifier);
+                break;
+            }
+            case TagRole::Function:
+            case TagRole::Method: {
+                kind = role == TagRole::Method || std::string_view(ts_node_type(name)) == "field_identifier"
+                    ? SymbolKind::Method : SymbolKind::Function;
+                // function_declarator, possibly under pointer / reference
+                // declarators, directly below the function_definition.
+                TSNode p = ts_node_parent(definition);
+                while (!ts_node_is_null(p) && std::string_view(ts_node_type(p)).ends_with("_declarator"))
+                    p = ts_node_parent(p);
+                is_definition = !ts_node_is_null(p) && std::string_view(ts_node_type(p)) == "function_definition";
+                break;
+            }
+            case TagRole::Type:
+                if (std::string_view(ts_node_type(definition)) == "enum_specifier") {
+                    kind = SymbolKind::Enum;
+                    is_definition = has_body(definition);
+                }
+                else kind = SymbolKind::Typedef;
+                break;
+            default:
+                break;
+            }
 
-        // Your existing highlighting logic here...
-        // (Just call the regular Highlight method since the tree is already updated)
-        return Highlight(code);
+            qualified.clear();
+            for (auto it = scopes.rbegin(); it != scopes.rend(); ++it) {
+                qualified += *it;
+                qualified += "::";
+            }
+            qualified += text(written);
+
+            // "Type::Type": the query cannot tell constructors apart.
+            if (kind == SymbolKind::Function || kind == SymbolKind::Method) {
+                const std::string_view q(qualified);
+                const size_t sep = q.rfind("::");
+                if (sep != std::string_view::npos) {
+                    const std::string_view scope = q.substr(0, sep);
+                    const size_t outer = scope.rfind("::");
+                    if (scope.substr(outer == std::string_view::npos ? 0 : outer + 2) == q.substr(sep + 2))
+                        kind = SymbolKind::Constructor;
+                }
+            }
+
+            const TSPoint at = ts_node_start_point(name);
+            symbols.symbols.push_back({ symbols.Intern(qualified), {},
+                static_cast<int>(at.row) + 1, static_cast<int>(at.column) + 1, kind, is_definition });
+        }
+        ts_query_cursor_delete(cursor);
+        return symbols;
     }
 };
 
@@ -681,11 +876,17 @@ std::string SyntaxHighlighter::LoadFile(const std::string& path) {
     return impl->LoadFile(path);
 }
 
-std::vector<SyntaxToken> SyntaxHighlighter::Highlight(const std::string& code) {
+std::vector<SyntaxToken> SyntaxHighlighter::Highlight(std::string_view code) {
     return impl->Highlight(code);
 }
-std::vector<SyntaxToken> SyntaxHighlighter::HighlightIncremental(const std::string& code, const std::vector<TextEdit>& edits) {
-    return impl->HighlightIncremental(code, edits);
+std::vector<SyntaxToken> SyntaxHighlighter::HighlightIncremental(ParseState& state, std::string_view code, const std::vector<TextEdit>& edits) {
+    return impl->HighlightIncremental(state, code, edits);
+}
+std::vector<SyntaxToken> SyntaxHighlighter::HighlightRange(std::string_view window, int first_line) {
+    return impl->Highlight(window, first_line);
+}
+SymbolList SyntaxHighlighter::Outline(const ParseState& state, std::string_view code) const {
+    return impl->Outline(state, code);
 }
 
 class StringInterner {
@@ -1,5 +1,7 @@
 ﻿#pragma once
+#include <cstdint>
 #include <string>
+#include <string_view>
 #include <vector>
 #include "imgui.h"
 #include <tree_sitter/api.h>
@@ -52,20 +54,55 @@ struct SyntaxToken {
 };
 
 struct TextEdit;  // Forward declaration
+struct SymbolList;    // clang_indexer.h
 
+// One SyntaxHighlighter per language, shared by every document of that
+// language: it only holds immutable resources (grammar, dispatch tables),
+// and parsers are checked out of a shared pool, so any number of documents
+// can highlight concurrently.  The incremental tree of a document lives in its
+// own ParseState.
 class SyntaxHighlighter {
 public:
+    // Per-document parse state: the tree-sitter tree of the last parse.
+    // Owned by the document; one highlight job at a time may use it.
+    class ParseState {
+    public:
+        ParseState() = default;
+        ~ParseState();
+        ParseState(const ParseState&) = delete;
+        ParseState& operator=(const ParseState&) = delete;
+
+        void Reset();   // drop the tree: the next highlight parses from scratch
+
+    private:
+        friend class SyntaxHighlighter;
+        TSTree* tree_ = nullptr;
+        size_t  code_size_ = 0;   // size of the text the tree was parsed from
+    };
+
     SyntaxHighlighter(const std::string& language);
     ~SyntaxHighlighter();
 
     std::string LoadFile(const std::string& path);
-    std::vector<SyntaxToken> Highlight(const std::string& code);
-    std::vector<SyntaxToken> HighlightIncremental(const std::string& code, const std::vector<TextEdit>& edits);
+    // One-shot parse, no tree is kept.
+    std::vector<SyntaxToken> Highlight(std::string_view code);
+    // Apply `edits` to the document's tree and reparse incrementally (a
+    // full parse when there is no tree or no edits).
+    std::vector<SyntaxToken> HighlightIncremental(ParseState& state, std::string_view code, const std::vector<TextEdit>& edits);
+    // Highlight only `window` (a run of whole lines starting at `first_line`,
+    // 0-based).  Used for files too large to parse in one piece.
+    std::vector<SyntaxToken> HighlightRange(std::string_view window, int first_line);
+    // Definitions matched by the language's tags query (tags_cpp.scm /
+    // tags_c.scm) in the document's tree: a quick outline to show until
+    // libclang has indexed the file.  `code` must be the text the tree was
+    // parsed from; empty without a tree.
+    SymbolList Outline(const ParseState& state, std::string_view code) const;
 
 private:
     struct Impl;
     Impl* impl;
 };
 
-ImVec4 GetSemanticColor(const std::string& clangCursorKind);
+enum class SemanticKind : uint8_t;   // clang_indexer.h
+ImVec4 GetSemanticColor(SemanticKind kind);
 const char* TokenTypeToString(TokenType type);
\ No newline at end of file
@@ -3,213 +3,477 @@
 #include <sstream>
 #include <algorithm>
 #include <functional>
+#include <iterator>
 #include <numeric>
 #include <cctype>
-#include "imgui.h"
-#include "imgui_internal.h"
+#include <tuple>
+#include "utf8.h"
 #include <regex>
+#include "text_editor_internal.h"
+#include "memory_usage.h"
 
-#define DEBUG_TEXTEDITOR
-
-#ifdef DEBUG_TEXTEDITOR
-#include <cstdio>
-#include <cstdarg>
-
-// ANSI color codes for terminal output
-#define ANSI_COLOR_RED     "\x1b[31m"
-#define ANSI_COLOR_GREEN   "\x1b[32m"
-#define ANSI_COLOR_YELLOW  "\x1b[33m"
-#define ANSI_COLOR_BLUE    "\x1b[34m"
-#define ANSI_COLOR_MAGENTA "\x1b[35m"
-#define ANSI_COLOR_CYAN    "\x1b[36m"
-#define ANSI_COLOR_RESET   "\x1b[0m"
-#define ANSI_COLOR_BOLD    "\x1b[1m"
-
-// Debug modules
-enum class DebugModule {
-    CORE,         // Core operations (constructor, destructor, etc.)
-    EDIT,         // Text editing operations
-    CURSOR,       // Cursor movement
-    SELECTION,    // Selection operations
-    CLIPBOARD,    // Copy/paste operations
-    UNDO,         // Undo/redo operations
-    HIGHLIGHT,    // Syntax highlighting
-    SEMANTIC,     // Semantic analysis
-    CACHE,        // Cache operations
-    RENDER,       // Rendering operations
-    SEARCH,       // Find/replace operations
-    MOUSE,        // Mouse operations
-    KEYBOARD,     // Keyboard input
-    MINIMAP,      // Minimap operations
-    SCROLL,       // Scrolling operations
-    PERF          // Performance metrics
-};
-
-const char* GetModuleName(DebugModule module) {
-    switch (module) {
-    case DebugModule::CORE:      return "CORE";
-    case DebugModule::EDIT:      return "EDIT";
-    case DebugModule::CURSOR:    return "CURSOR";
-    case DebugModule::SELECTION: return "SELECTION";
-    case DebugModule::CLIPBOARD: return "CLIPBOARD";
-    case DebugModule::UNDO:      return "UNDO";
-    case DebugModule::HIGHLIGHT: return "HIGHLIGHT";
-    case DebugModule::SEMANTIC:  return "SEMANTIC";
-    case DebugModule::CACHE:     return "CACHE";
-    case DebugModule::RENDER:    return "RENDER";
-    case DebugModule::SEARCH:    return "SEARCH";
-    case DebugModule::MOUSE:     return "MOUSE";
-    case DebugModule::KEYBOARD:  return "KEYBOARD";
-    case DebugModule::MINIMAP:   return "MINIMAP";
-    case DebugModule::SCROLL:    return "SCROLL";
-    case DebugModule::PERF:      return "PERF";
-    default:                     return "UNKNOWN";
+TextEditor::TextEditor(const std::string& file_path, SyntaxHighlighter& highlighter, ClangIndexer& indexer)
+    : file_path_(file_path), highlighter_(highlighter), indexer_(indexer)
+{
+    DBG_TEDITOR(DebugModule::CORE, "Constructor", "Initializing TextEditor for file: %s", file_path.c_str());
+
+    // Load the file once; lines_ is filled straight from the snapshot's
+    // bytes using its line index (no stream, no intermediate copies).  Only
+    // large files stay mapped: every other snapshot outlives any change
+    // made to the file on disk.
+    snapshot_ = FileSnapshot::Open(file_path_, s_large_file_threshold_);
+
+    DBG_TEDITOR(DebugModule::CORE, "FileLoad", "%s %zu bytes (%zu lines) from file",
+        snapshot_->IsMapped() ? "Mapped" : "Read", snapshot_->Size(), snapshot_->LineCount());
+
+    // Large files keep their lines in the mapping until they are edited.
+    large_file_ = snapshot_->Size() >= s_large_file_threshold_;
+    lines_.Assign(snapshot_, large_file_);
+    if (lines_.empty()) lines_.push_back("");
+
+    DBG_TEDITOR(DebugModule::CORE, "Parse", "Loaded %zu lines (%zu materialized)",
+        lines_.size(), lines_.MaterializedCount());
+
+    size_t bad_offset = 0;
+    if (!Utf8Validate(snapshot_->Text(), &bad_offset))
+        std::fprintf(stderr, "[TextEditor] %s: invalid UTF-8 at byte %zu\n",
+            file_path_.c_str(), bad_offset);
+    line_encoding_.assign(lines_.size(), kEncodingUnknown);
+
+    cursor_ = { 0, 0 };
+
+    if (large_file_) {
+        // No whole-file caches, parse or index: the viewport window is
+        // highlighted on demand from Draw().
+        DBG_TEDITOR(DebugModule::PERF, "LargeFile",
+            "%zu bytes >= %zu, viewport-only highlighting, no semantics, no undo",
+            snapshot_->Size(), s_large_file_threshold_);
     }
-}
+    else {
+        // Initialize caches
+        line_token_cache_.resize(lines_.size());
+        tokens_by_line_.resize(lines_.size());
+        StampLines(0, lines_.size());
+
+        DBG_TEDITOR(DebugModule::CACHE, "Init", "Initialized caches for %zu lines", lines_.size());
 
-const char* GetModuleColor(DebugModule module) {
-    switch (module) {
-    case DebugModule::CORE:      return ANSI_COLOR_BLUE;
-    case DebugModule::EDIT:      return ANSI_COLOR_GREEN;
-    case DebugModule::CURSOR:    return ANSI_COLOR_CYAN;
-    case DebugModule::SELECTION: return ANSI_COLOR_MAGENTA;
-    case DebugModule::CLIPBOARD: return ANSI_COLOR_YELLOW;
-    case DebugModule::UNDO:      return ANSI_COLOR_RED;
-    case DebugModule::HIGHLIGHT: return ANSI_COLOR_GREEN;
-    case DebugModule::SEMANTIC:  return ANSI_COLOR_BLUE;
-    case DebugModule::CACHE:     return ANSI_COLOR_MAGENTA;
-    case DebugModule::RENDER:    return ANSI_COLOR_CYAN;
-    case DebugModule::SEARCH:    return ANSI_COLOR_YELLOW;
-    case DebugModule::MOUSE:     return ANSI_COLOR_RED;
-    case DebugModule::KEYBOARD:  return ANSI_COLOR_GREEN;
-    case DebugModule::MINIMAP:   return ANSI_COLOR_BLUE;
-    case DebugModule::SCROLL:    return ANSI_COLOR_MAGENTA;
-    case DebugModule::PERF:      return ANSI_COLOR_YELLOW;
-    default:                     return ANSI_COLOR_RESET;
+        // Start background processing
+        UpdateHighlightingAsync();
+        UpdateSemanticKindsAsync();
     }
+
+    DBG_TEDITOR(DebugModule::CORE, "Constructor", "TextEditor initialization complete");
 }
 
-void DebugPrint(DebugModule module, const char* action, const char* fmt, ...) {
-    va_list args;
-    va_start(args, fmt);
+TextEditor::~TextEditor() {
+    DBG_TEDITOR(DebugModule::CORE, "Destructor", "Cleaning up TextEditor");
 
-    // Print timestamp
-    auto now = std::chrono::system_clock::now();
-    auto ms = std::chrono::duration_cast<std::chrono::milliseconds>(now.time_since_epoch()) % 1000;
-    auto time_t = std::chrono::system_clock::to_time_t(now);
-    struct tm* tm = localtime(&time_t);
+    // Wait for any pending async operations
+    if (highlight_future_.valid()) {
+        DBG_TEDITOR(DebugModule::HIGHLIGHT, "Cleanup", "Waiting for pending highlight task");
+        highlight_future_.wait();
+    }
+    if (semantic_future_.valid()) {
+        DBG_TEDITOR(DebugModule::SEMANTIC, "Cleanup", "Waiting for pending semantic task");
+        semantic_future_.wait();
+    }
+    if (window_future_.valid()) {
+        DBG_TEDITOR(DebugModule::HIGHLIGHT, "Cleanup", "Waiting for pending window highlight");
+        window_future_.wait();
+    }
 
-    fprintf(stderr, "[%02d:%02d:%02d.%03d] ",
-        tm->tm_hour, tm->tm_min, tm->tm_sec, (int)ms.count());
+    DBG_TEDITOR(DebugModule::CORE, "Destructor", "TextEditor cleanup complete");
+}
 
-    // Print module with color
-    fprintf(stderr, "%s%s[%-10s]%s ",
-        ANSI_COLOR_BOLD, GetModuleColor(module),
-        GetModuleName(module), ANSI_COLOR_RESET);
+/*──────────────────────────────────────────────────────────*/
+/*                     headless driving                     */
+void TextEditor::TypeText(std::string_view utf8)
+{
+    Wake();
+    for (size_t i = 0; i < utf8.size(); i = Utf8NextBoundary(utf8, i)) {
+        if (utf8[i] == '\n')
+            InsertNewLine();
+        else if (utf8[i] != '\r')
+            InsertChar(Utf8Decode(utf8, i));
+    }
+}
 
-    // Print action
-    fprintf(stderr, "%s%-20s%s ", ANSI_COLOR_BOLD, action, ANSI_COLOR_RESET);
+void TextEditor::Update()
+{
+    Wake();
+    ProcessPendingHighlights();
+    ProcessPendingSemantics();
+    RefreshSemanticsIfIdle();
+    if (large_file_)
+        UpdateWindowHighlightAsync();
+    ProcessPendingWindowHighlight();
+}
 
-    // Print details
-    vfprintf(stderr, fmt, args);
-    fprintf(stderr, "\n");
+void TextEditor::CollectBackgroundWork()
+{
+    if (hibernated_) {
+        if (tu_release_pending_)
+            tu_release_pending_ = !ClangIndexer::Release(file_path_);
+        return;
+    }
+    ProcessPendingHighlights();
+    ProcessPendingSemantics();
+    ProcessPendingWindowHighlight();
+}
 
-    va_end(args);
+bool TextEditor::HasPendingWork() const
+{
+    return highlight_future_.valid() || semantic_future_.valid() || window_future_.valid();
 }
 
-#define DBG_TEDITOR(module, action, fmt, ...) \
-    DebugPrint(module, action, fmt, ##__VA_ARGS__)
-#else
-#define DBG_TEDITOR(module, action, fmt, ...) ((void)0)
-#endif
+TextEditor::BackgroundWork TextEditor::BackgroundQueue() const
+{
+    BackgroundWork work;
+    work.highlight_running = (highlight_future_.valid() ? 1 : 0) + (window_future_.valid() ? 1 : 0);
+    work.highlight_queued = highlight_dirty_ ? 1 : 0;
+    work.semantic_running = semantic_future_.valid() ? 1 : 0;
+    work.semantic_queued = (!large_file_ && !semantic_future_.valid()
+        && semantic_version_ != content_version_.load()) ? 1 : 0;
+    return work;
+}
 
-static std::string SafeSubstr(const std::string& s, int pos, int count = INT_MAX)
+size_t TextEditor::TokenCount()
 {
-    if (pos < 0 || pos >= (int)s.size())
-        return "";
-    // clamp count so pos+count ≤ s.size()
-    int maxCount = std::min(count, (int)s.size() - pos);
-    return s.substr(pos, maxCount);
+    std::lock_guard<std::mutex> lock(tokens_mutex_);
+    size_t n = 0;
+    for (const auto& line : (large_file_ ? window_.tokens_by_line : tokens_by_line_))
+        n += line.size();
+    return n;
 }
 
-TextEditor::TextEditor(const std::string& file_path, SyntaxHighlighter& highlighter, ClangIndexer& indexer)
-    : file_path_(file_path), highlighter_(highlighter), indexer_(indexer)
+std::vector<SyntaxToken> TextEditor::Tokens()
 {
-    DBG_TEDITOR(DebugModule::CORE, "Constructor", "Initializing TextEditor for file: %s", file_path.c_str());
+    std::lock_guard<std::mutex> lock(tokens_mutex_);
+    std::vector<SyntaxToken> tokens;
+    for (const auto& line : (large_file_ ? window_.tokens_by_line : tokens_by_line_))
+        tokens.insert(tokens.end(), line.begin(), line.end());
+    return tokens;
+}
 
-    std::ifstream in(file_path_);
-    std::stringstream ss;
-    ss << in.rdbuf();
-    std::string content = ss.str();
+size_t TextEditor::SemanticKindCount()
+{
+    std::lock_guard<std::mutex> lock(semantic_mutex_);
+    size_t count = 0;
+    for (const auto& line : sem_lines_)
+        count += line.size();
+    return count;
+}
+
+TextEditor::MemoryUsage TextEditor::MemoryFootprint()
+{
+    MemoryUsage m;
+    m.buffer = lines_.OwnedBytes() + mem::HeapBytes(cached_content_) + mem::HeapBytes(line_encoding_);
+    if (snapshot_) {
+        const size_t snapshot_bytes = snapshot_->Size() + mem::HeapBytes(snapshot_->LineStarts());
+        (snapshot_->IsMapped() ? m.mapped : m.buffer) += snapshot_bytes;
+    }
 
-    DBG_TEDITOR(DebugModule::CORE, "FileLoad", "Loaded %zu bytes from file", content.size());
+    m.undo = (undo_stack_.capacity() + redo_stack_.capacity()) * sizeof(EditorState);
+    for (const auto* stack : { &undo_stack_, &redo_stack_ })
+        for (const auto& state : *stack)
+            m.undo += mem::HeapBytes(state.content);
 
-    // Pre-allocate based on estimated line count
-    size_t estimated_lines = std::count(content.begin(), content.end(), '\n') + 1;
-    lines_.reserve(estimated_lines);
+    {
+        std::lock_guard<std::mutex> lock(tokens_mutex_);
+        m.tokens_by_line = mem::HeapBytes(tokens_by_line_) + mem::HeapBytes(window_.tokens_by_line);
+    }
+    m.line_token_cache = line_token_cache_.capacity() * sizeof(LineCache) + mem::HeapBytes(line_versions_);
+    for (const auto& c : line_token_cache_)
+        m.line_token_cache += mem::HeapBytes(c.tokens);
 
-    DBG_TEDITOR(DebugModule::CORE, "Memory", "Pre-allocated space for %zu lines", estimated_lines);
+    if (!highlight_future_.valid())
+        token_cache_bytes_ = mem::HeapBytes(token_cache_);
+    m.token_cache = token_cache_bytes_;
 
-    // Split content into lines efficiently
-    std::istringstream iss(content);
-    std::string line;
-    while (std::getline(iss, line)) {
-        lines_.push_back(std::move(line));
+    if (!semantic_future_.valid())
+        semantic_cache_bytes_ = mem::HeapBytes(semantic_cache_);
+    {
+        std::lock_guard<std::mutex> lock(semantic_mutex_);
+        m.semantic = mem::HeapBytes(sem_lines_) + semantic_cache_bytes_;
     }
-    if (lines_.empty()) lines_.push_back("");
 
-    DBG_TEDITOR(DebugModule::CORE, "Parse", "Parsed %zu lines from content", lines_.size());
+    if (hibernated_) {
+        m.buffer += mem::HeapBytes(hibernated_->text);
+        m.undo += (hibernated_->undo.capacity() + hibernated_->redo.capacity()) * sizeof(UndoDelta);
+        for (const auto* deltas : { &hibernated_->undo, &hibernated_->redo })
+            for (const auto& d : *deltas)
+                m.undo += mem::HeapBytes(d.middle);
+        m.tokens_by_line += hibernated_->tokens.capacity() * sizeof(CompactToken);
+    }
 
-    cursor_ = { 0, 0 };
+    m.translation_unit = large_file_ ? 0 : ClangIndexer::TranslationUnitBytes(file_path_);
+    return m;
+}
 
-    // Initialize caches
-    line_token_cache_.resize(lines_.size());
-    tokens_by_line_.resize(lines_.size());
+/*──────────────────────────────────────────────────────────*/
+/*                        hibernation                       */
+namespace {
+    // `state` expressed against `newer`: shared prefix / suffix plus the
+    // bytes in between.  Neighbouring undo snapshots differ by one edit,
+    // so the middle is usually a few bytes.
+    template <class Delta>
+    Delta MakeDelta(std::string_view newer, std::string_view state)
+    {
+        Delta d;
+        const size_t limit = std::min(newer.size(), state.size());
+        while (d.prefix < limit && newer[d.prefix] == state[d.prefix]) ++d.prefix;
+        while (d.suffix < limit - d.prefix
+            && newer[newer.size() - 1 - d.suffix] == state[state.size() - 1 - d.suffix]) ++d.suffix;
+        d.middle.assign(state.substr(d.prefix, state.size() - d.prefix - d.suffix));
+        return d;
+    }
 
-    DBG_TEDITOR(DebugModule::CACHE, "Init", "Initialized caches for %zu lines", lines_.size());
+    template <class Delta>
+    std::string ApplyDelta(std::string_view newer, const Delta& d)
+    {
+        std::string state;
+        state.reserve(d.prefix + d.middle.size() + d.suffix);
+        state.append(newer.substr(0, d.prefix));
+        state.append(d.middle);
+        state.append(newer.substr(newer.size() - d.suffix));
+        return state;
+    }
+
+    // An undo / redo stack as a chain of deltas: the top against the
+    // current text, every other entry against the one above it.
+    template <class Delta, class State>
+    std::vector<Delta> EncodeStackImpl(std::string_view current, const std::vector<State>& stack)
+    {
+        std::vector<Delta> out(stack.size());
+        std::string_view newer = current;
+        for (size_t i = stack.size(); i-- > 0; newer = stack[i].content) {
+            out[i] = MakeDelta<Delta>(newer, stack[i].content);
+            out[i].cursor = stack[i].cursor;
+        }
+        return out;
+    }
 
-    // Start background processing
-    UpdateHighlightingAsync();
-    UpdateSemanticKindsAsync();
+    template <class State, class Delta>
+    std::vector<State> DecodeStackImpl(std::string_view current, const std::vector<Delta>& deltas)
+    {
+        std::vector<State> out(deltas.size());
+        std::string_view newer = current;
+        for (size_t i = deltas.size(); i-- > 0; newer = out[i].content)
+            out[i] = { ApplyDelta(newer, deltas[i]), deltas[i].cursor };
+        return out;
+    }
+}
 
-    DBG_TEDITOR(DebugModule::CORE, "Constructor", "TextEditor initialization complete");
+std::vector<TextEditor::UndoDelta> TextEditor::EncodeStack(std::string_view current, const std::vector<EditorState>& stack)
+{
+    return EncodeStackImpl<UndoDelta>(current, stack);
 }
 
-TextEditor::~TextEditor() {
-    DBG_TEDITOR(DebugModule::CORE, "Destructor", "Cleaning up TextEditor");
+std::vector<EditorState> TextEditor::DecodeStack(std::string_view current, const std::vector<UndoDelta>& deltas)
+{
+    return DecodeStackImpl<EditorState>(current, deltas);
+}
 
-    // Wait for any pending async operations
-    if (highlight_future_.valid()) {
-        DBG_TEDITOR(DebugModule::HIGHLIGHT, "Cleanup", "Waiting for pending highlight task");
-        highlight_future_.wait();
+bool TextEditor::Hibernate()
+{
+    if (hibernated_) return true;
+    if (HasPendingWork() || highlight_dirty_ || (!large_file_ && highlighted_version_ != content_version_.load())) {
+        DBG_TEDITOR(DebugModule::CACHE, "Hibernate", "Background work in flight, not hibernating");
+        return false;
     }
-    if (semantic_future_.valid()) {
-        DBG_TEDITOR(DebugModule::SEMANTIC, "Cleanup", "Waiting for pending semantic task");
-        semantic_future_.wait();
+
+    auto h = std::make_unique<HibernatedState>();
+    {
+        std::lock_guard<std::mutex> lock(tokens_mutex_);
+        window_ = {};
+        window_valid_ = false;
+        if (!large_file_) {
+            for (const auto& line : tokens_by_line_)
+                for (const auto& t : line)
+                    h->tokens.push_back({ t.line, t.column, t.length, t.type });
+            h->tokens.shrink_to_fit();
+        }
+        std::vector<std::vector<SyntaxToken>>().swap(tokens_by_line_);
     }
 
-    DBG_TEDITOR(DebugModule::CORE, "Destructor", "TextEditor cleanup complete");
+    // Large files keep their (mostly still mapped) line store as it is.
+    if (!large_file_) {
+        h->from_snapshot = content_version_.load() == 0;
+        std::string current = h->from_snapshot ? std::string(snapshot_->Text()) : GetContent();
+
+        h->undo = EncodeStack(current, undo_stack_);
+        h->redo = EncodeStack(current, redo_stack_);
+        if (!h->from_snapshot) h->text = std::move(current);
+        lines_.Assign(std::vector<std::string>{});
+        std::vector<EditorState>().swap(undo_stack_);
+        std::vector<EditorState>().swap(redo_stack_);
+    }
+
+    std::string().swap(cached_content_);
+    content_dirty_ = true;
+    std::vector<uint8_t>().swap(line_encoding_);
+    std::vector<LineCache>().swap(line_token_cache_);
+    std::vector<uint64_t>().swap(line_versions_);
+    decltype(token_cache_)().swap(token_cache_);
+    decltype(semantic_cache_)().swap(semantic_cache_);
+    token_cache_bytes_ = semantic_cache_bytes_ = 0;
+    parse_state_.Reset();
+    parsed_version_.reset();
+    find_results_.clear();
+    tu_release_pending_ = !ClangIndexer::Release(file_path_);
+
+    DBG_TEDITOR(DebugModule::CACHE, "Hibernate", "%s: %zu undo / %zu redo deltas, %zu tokens kept",
+        file_path_.c_str(), h->undo.size(), h->redo.size(), h->tokens.size());
+    hibernated_ = std::move(h);
+    return true;
+}
+
+void TextEditor::Wake()
+{
+    if (!hibernated_) return;
+    MUT_TRACE_SCOPE(trace::Level::Info, "CACHE", "Wake");
+    std::unique_ptr<HibernatedState> h = std::move(hibernated_);
+    tu_release_pending_ = false;
+
+    if (!large_file_) {
+        const std::string_view text = h->from_snapshot ? snapshot_->Text() : std::string_view(h->text);
+        if (h->from_snapshot) {
+            lines_.Assign(snapshot_, false);
+        }
+        else {
+            // Same split as std::getline: no extra line after a final '\n'.
+            std::vector<std::string> lines;
+            for (size_t pos = 0; pos < text.size();) {
+                size_t nl = text.find('\n', pos);
+                if (nl == std::string_view::npos) nl = text.size();
+                lines.emplace_back(text.substr(pos, nl - pos));
+                pos = nl + 1;
+            }
+            lines_.Assign(std::move(lines));
+        }
+        if (lines_.empty()) lines_.push_back("");
+
+        undo_stack_ = DecodeStack(text, h->undo);
+        redo_stack_ = DecodeStack(text, h->redo);
+
+        line_token_cache_.resize(lines_.size());
+        StampLines(0, lines_.size());
+        std::lock_guard<std::mutex> lock(tokens_mutex_);
+        tokens_by_line_.assign(lines_.size(), {});
+        for (const auto& t : h->tokens)
+            if (t.line >= 1 && t.line <= static_cast<int>(tokens_by_line_.size()))
+                tokens_by_line_[t.line - 1].push_back({ t.line, t.column, t.length, t.type, GetColorForCapture(t.type) });
+    }
+    line_encoding_.assign(lines_.size(), kEncodingUnknown);
+    content_dirty_ = true;
+    cursor_.line = std::clamp(cursor_.line, 0, static_cast<int>(lines_.size()) - 1);
+
+    DBG_TEDITOR(DebugModule::CACHE, "Wake", "%s: %zu lines, %zu undo states restored",
+        file_path_.c_str(), lines_.size(), undo_stack_.size());
 }
 
+std::optional<SymbolList> TextEditor::TakeOutline()
+{
+    // The job that owns parse_state_ must be done, and its tree must be
+    // of the text we hand the query (a token-cache hit does not reparse).
+    if (hibernated_ || large_file_ || highlight_future_.valid()
+        || parsed_version_ != content_version_.load())
+        return std::nullopt;
+
+    MUT_TRACE_SCOPE(trace::Level::Info, "HIGHLIGHT", "Outline");
+    const std::string_view text = content_version_.load() == 0 && snapshot_
+        ? snapshot_->Text() : std::string_view(GetContent());
+    auto symbols = highlighter_.Outline(parse_state_, text);
+    DBG_TEDITOR(DebugModule::HIGHLIGHT, "Outline", "%zu symbols from the tags query", symbols.symbols.size());
+    return symbols;
+}
+
+void TextEditor::ApplyInput(const InputEvent& event)
+{
+    Wake();
+    MoveCursorTo(event.line, event.column);
+    if (event.sel_line >= 0) {
+        const int line = std::clamp(event.sel_line, 0, (int)lines_.size() - 1);
+        SetSelection({ line, std::clamp(event.sel_column, 0, (int)lines_.View(line).size()) });
+    }
+    else {
+        ClearSelection();
+    }
+
+    switch (event.kind) {
+    case InputEvent::Kind::Char:      InsertChar(event.codepoint); break;
+    case InputEvent::Kind::Enter:     InsertNewLine(); break;
+    case InputEvent::Kind::Backspace: DeleteChar(); break;
+    case InputEvent::Kind::Paste:     PasteText(event.text); break;
+    case InputEvent::Kind::Type:      InsertTyped(event.text); break;
+    }
+}
+
+// Called by the view before it applies a keystroke, while the cursor and
+// selection are still where the keystroke was made.
+void TextEditor::RecordInput(InputEvent::Kind kind, uint32_t codepoint, std::string_view text)
+{
+    InputRecorder* recorder = InputRecorder::Active();
+    if (!recorder || large_file_) return;
+    if (!recorder->IsBoundTo(file_path_) && !recorder->Bind(file_path_, GetContent()))
+        return;
+
+    InputEvent event;
+    event.kind = kind;
+    event.line = cursor_.line;
+    event.column = cursor_.column;
+    if (has_selection_) {
+        event.sel_line = selection_start_.line;
+        event.sel_column = selection_start_.column;
+    }
+    event.codepoint = codepoint;
+    event.text = text;
+    recorder->Record(std::move(event));
+}
+/*──────────────────────────────────────────────────────────*/
+
 void TextEditor::InsertLineCaches(size_t idx, size_t n) {
+    if (idx <= line_encoding_.size())
+        line_encoding_.insert(line_encoding_.begin() + idx, n, kEncodingUnknown);
+    if (large_file_) return;   // no token caches in large-file mode
     DBG_TEDITOR(DebugModule::CACHE, "InsertLines", "Inserting %zu cache entries at index %zu", n, idx);
 
     line_token_cache_.insert(line_token_cache_.begin() + idx, n, {});
+    if (idx <= line_versions_.size())
+        line_versions_.insert(line_versions_.begin() + idx, n, ++line_version_clock_);
+    {
+        std::lock_guard<std::mutex> lock(semantic_mutex_);
+        if (idx <= sem_lines_.size())
+            sem_lines_.insert(sem_lines_.begin() + idx, n, {});
+    }
     std::lock_guard<std::mutex> lock(tokens_mutex_);
     tokens_by_line_.insert(tokens_by_line_.begin() + idx, n, {});
 }
 
 void TextEditor::EraseLineCaches(size_t idx, size_t n) {
+    if (idx < line_encoding_.size())
+        line_encoding_.erase(line_encoding_.begin() + idx,
+            line_encoding_.begin() + std::min(idx + n, line_encoding_.size()));
+    if (large_file_) return;
     DBG_TEDITOR(DebugModule::CACHE, "EraseLines", "Erasing %zu cache entries from index %zu", n, idx);
 
     line_token_cache_.erase(line_token_cache_.begin() + idx,
         line_token_cache_.begin() + idx + n);
+    if (idx < line_versions_.size())
+        line_versions_.erase(line_versions_.begin() + idx,
+            line_versions_.begin() + std::min(idx + n, line_versions_.size()));
+    {
+        std::lock_guard<std::mutex> lock(semantic_mutex_);
+        if (idx < sem_lines_.size())
+            sem_lines_.erase(sem_lines_.begin() + idx,
+                sem_lines_.begin() + std::min(idx + n, sem_lines_.size()));
+    }
     std::lock_guard<std::mutex> lock(tokens_mutex_);
     tokens_by_line_.erase(tokens_by_line_.begin() + idx,
         tokens_by_line_.begin() + idx + n);
 }
 
-bool TextEditor::MatchFind(const std::string& line, int& match_start, int& match_len) {
+bool TextEditor::MatchFind(std::string_view line, int& match_start, int& match_len) {
     match_start = 0;
     match_len = 0;
 
@@ -229,9 +493,10 @@ bool TextEditor::MatchFind(const std::string& line, int& match_start, int& match
                 flags |= std::regex_constants::icase;
 
             std::regex rgx(find_query_, flags);
-            std::smatch match;
+            std::cmatch match;
 
-            if (std::regex_search(line, match, rgx) && match.ready() && !match.empty()) {
+            if (std::regex_search(line.data(), line.data() + line.size(), match, rgx) &&
+                match.ready() && !match.empty()) {
                 match_start = static_cast<int>(match.position(0));
                 match_len = static_cast<int>(match.length(0));
                 DBG_TEDITOR(DebugModule::SEARCH, "RegexMatch", "Found match at pos %d, len %d", match_start, match_len);
@@ -241,7 +506,7 @@ bool TextEditor::MatchFind(const std::string& line, int& match_start, int& match
         else {
             DBG_TEDITOR(DebugModule::SEARCH, "StringMatch", "Attempting string match for: %s", find_query_.c_str());
 
-            std::string haystack = line;
+            std::string haystack(line);
             std::string needle = find_query_;
 
             if (!find_case_sensitive_) {
@@ -267,6 +532,7 @@ bool TextEditor::MatchFind(const std::string& line, int& match_start, int& match
 
 void TextEditor::SetContent(const std::string& content)
 {
+    Wake();
     DBG_TEDITOR(DebugModule::EDIT, "SetContent", "Setting new content, size=%zu bytes", content.size());
 
     // 1.  Read new buffer into temporary vector
@@ -287,23 +553,36 @@ void TextEditor::SetContent(const std::string& content)
     // 2.  Longest common prefix / suffix detection
     size_t prefix_len = 0;
     while (prefix_len < old_size && prefix_len < new_size &&
-        lines_[prefix_len] == new_lines[prefix_len])
+        lines_.View(prefix_len) == new_lines[prefix_len])
         ++prefix_len;
 
     size_t suffix_len = 0;
     while (suffix_len < old_size - prefix_len &&
         suffix_len < new_size - prefix_len &&
-        lines_[old_size - 1 - suffix_len] ==
+        lines_.View(old_size - 1 - suffix_len) ==
         new_lines[new_size - 1 - suffix_len])
         ++suffix_len;
 
     DBG_TEDITOR(DebugModule::PERF, "Diff", "Common prefix: %zu lines, suffix: %zu lines", prefix_len, suffix_len);
     DBG_TEDITOR(DebugModule::PERF, "Diff", "Changed range: lines %zu to %zu", prefix_len, new_size - suffix_len - 1);
 
+    line_encoding_.assign(new_size, kEncodingUnknown);
+
+    if (large_file_) {
+        // No per-line caches to carry over; the window job picks it up.
+        lines_.Assign(std::move(new_lines));
+        cursor_ = { 0, 0 };
+        has_selection_ = false;
+        UpdateContentFromLines();
+        return;
+    }
+
     
     // 3.  Build caches for new buffer (reuse unchanged lines)
     std::vector<LineCache>                 new_line_caches(new_size);
     std::vector<std::vector<SyntaxToken>>  new_tokens_by_line(new_size);
+    std::vector<uint64_t>                  new_line_versions(new_size, 0);
+    line_versions_.resize(old_size, 0);
 
     {
         std::lock_guard<std::mutex> lock(tokens_mutex_);
@@ -312,6 +591,7 @@ void TextEditor::SetContent(const std::string& content)
         for (size_t i = 0; i < prefix_len; ++i) {
             new_line_caches[i] = line_token_cache_[i];
             new_tokens_by_line[i] = tokens_by_line_[i];
+            new_line_versions[i] = line_versions_[i];
         }
 
         DBG_TEDITOR(DebugModule::CACHE, "Reuse", "Reused %zu prefix cache entries", prefix_len);
@@ -324,6 +604,7 @@ void TextEditor::SetContent(const std::string& content)
             size_t old_idx = new_idx + diff;
             new_line_caches[new_idx] = line_token_cache_[old_idx];
             new_tokens_by_line[new_idx] = tokens_by_line_[old_idx];
+            new_line_versions[new_idx] = line_versions_[old_idx];
         }
 
         DBG_TEDITOR(DebugModule::CACHE, "Reuse", "Reused %zu suffix cache entries", suffix_len);
@@ -346,7 +627,9 @@ void TextEditor::SetContent(const std::string& content)
         tokens_by_line_.swap(new_tokens_by_line);
     }
     line_token_cache_.swap(new_line_caches);
-    lines_.swap(new_lines);
+    line_versions_.swap(new_line_versions);
+    line_starts_.resize(std::min(line_starts_.size(), prefix_len + 1));
+    lines_.Assign(std::move(new_lines));
 
     
     // 5.  Reset cursor / selection and queue incremental highlight
@@ -364,62 +647,60 @@ void TextEditor::SetContent(const std::string& content)
     DBG_TEDITOR(DebugModule::EDIT, "SetContent", "Content update complete");
 }
 
-size_t TextEditor::HashLine(const std::string& line) const {
-    size_t hash = std::hash<std::string>{}(line);
-    //G_TEDITOR(DebugModule::CACHE, "HashLine", "Line hash: %zx, length: %zu", hash, line.length());
-    return hash;
-}
-
-size_t TextEditor::HashContent() const {
-    size_t hash = 0;
-    for (const auto& line : lines_) {
-        hash ^= HashLine(line) + 0x9e3779b9 + (hash << 6) + (hash >> 2);
-    }
-    DBG_TEDITOR(DebugModule::CACHE, "HashContent", "Content hash: %zx for %zu lines", hash, lines_.size());
-    return hash;
+void TextEditor::StampLines(size_t first, size_t count) {
+    line_starts_.resize(std::min(line_starts_.size(), first + 1));
+    line_versions_.resize(lines_.size(), 0);
+    const uint64_t stamp = ++line_version_clock_;
+    const size_t last = std::min(first + count, line_versions_.size());
+    for (size_t i = first; i < last; ++i)
+        line_versions_[i] = stamp;
 }
 
-void TextEditor::TrackEdit(size_t start_byte, size_t old_length, size_t new_length) {
-    DBG_TEDITOR(DebugModule::EDIT, "TrackEdit", "Tracking edit at byte %zu: old_len=%zu, new_len=%zu",
-        start_byte, old_length, new_length);
-
-    std::lock_guard<std::mutex> lock(edit_mutex_);
+void TextEditor::TrackEdit(int line, int column, size_t old_length, size_t new_length) {
+    if (large_file_) return;   // the window job parses from scratch anyway
 
-    size_t byte_pos = 0;
-    int line = 0;
-    int column = 0;
-
-    for (int i = 0; i < lines_.size() && byte_pos < start_byte; ++i) {
-        size_t line_length = lines_[i].length() + 1;
-        if (byte_pos + line_length > start_byte) {
-            line = i;
-            column = start_byte - byte_pos;
-            break;
-        }
-        byte_pos += line_length;
+    if (line_starts_.empty()) line_starts_.push_back(0);
+    while (line_starts_.size() <= static_cast<size_t>(line)) {
+        const size_t prev = line_starts_.size() - 1;
+        line_starts_.push_back(line_starts_[prev] + lines_.View(prev).length() + 1);
     }
+    const size_t start_byte = line_starts_[line] + static_cast<size_t>(column);
+
+    DBG_TEDITOR(DebugModule::EDIT, "TrackEdit", "Tracking edit at %d:%d (byte %zu): old_len=%zu, new_len=%zu",
+        line, column, start_byte, old_length, new_length);
 
+    const uint32_t row = static_cast<uint32_t>(line);
+    const uint32_t col = static_cast<uint32_t>(column);
     TextEdit edit;
     edit.start_byte = start_byte;
     edit.old_end_byte = start_byte + old_length;
     edit.new_end_byte = start_byte + new_length;
-    edit.start_point = { static_cast<uint32_t>(line), static_cast<uint32_t>(column) };
+    edit.start_point = { row, col };
+    edit.old_end_point = { row, col + static_cast<uint32_t>(old_length) };
+    edit.new_end_point = { row, col + static_cast<uint32_t>(new_length) };
 
+    std::lock_guard<std::mutex> lock(edit_mutex_);
     pending_edits_.push_back(edit);
-
-    DBG_TEDITOR(DebugModule::EDIT, "TrackEdit", "Edit tracked at line %d, column %d", line, column);
+    edit_tracked_ = true;
 }
 
 const std::string& TextEditor::GetContent() const {
+    if (hibernated_ && !large_file_) {
+        // Read access does not wake the editor: hand out a copy of the kept text.
+        cached_content_ = hibernated_->from_snapshot ? std::string(snapshot_->Text()) : hibernated_->text;
+        return cached_content_;
+    }
     if (content_dirty_) {
         DBG_TEDITOR(DebugModule::CACHE, "GetContent", "Rebuilding content cache");
 
         cached_content_.clear();
-        cached_content_.reserve(std::accumulate(lines_.begin(), lines_.end(), size_t(0),
-            [](size_t sum, const std::string& line) { return sum + line.size() + 1; }));
+        size_t total = 0;
+        for (size_t i = 0; i < lines_.size(); ++i)
+            total += lines_.View(i).size() + 1;
+        cached_content_.reserve(total);
 
         for (size_t i = 0; i < lines_.size(); ++i) {
-            cached_content_ += lines_[i];
+            cached_content_ += lines_.View(i);
             if (i + 1 < lines_.size()) cached_content_ += '\n';
         }
         content_dirty_ = false;
@@ -442,38 +723,63 @@ void TextEditor::UpdateHighlightingAsync()
         "Launching async highlight task, version=%llu",
         static_cast<unsigned long long>(this_version));
 
-    // Grab a snapshot of the current content and edits
-    std::string           content = GetContent();
+    // Grab a snapshot of the current content and edits.  An untouched buffer
+    // is still the mapped file, so share that instead of joining lines_.
+    FileSnapshot::Ptr     snapshot;
+    std::string           content;
+    if (this_version == 0 && snapshot_)
+        snapshot = snapshot_;
+    else
+        content = GetContent();
     std::vector<TextEdit> edits;
+    bool                  untracked = false;
     {
         std::lock_guard<std::mutex> lock(edit_mutex_);
         edits = std::move(pending_edits_);
+        pending_edits_.clear();
+        untracked = untracked_edit_;
+        if (untracked) edits.clear();   // the tree cannot follow: full parse
+        untracked_edit_ = false;
     }
 
     DBG_TEDITOR(DebugModule::HIGHLIGHT, "AsyncStart",
         "Highlighting %zu bytes with %zu pending edits",
-        content.size(), edits.size());
+        snapshot ? snapshot->Size() : content.size(), edits.size());
 
     // Launch background task
     highlight_future_ = std::async(
         std::launch::async,
         [this,
+        snapshot = std::move(snapshot),
         content = std::move(content),
         edits = std::move(edits),
+        untracked,
         this_version]() -> std::pair<uint64_t, std::vector<SyntaxToken>>
         {
+            MUT_TRACE_SCOPE(trace::Level::Info, "HIGHLIGHT", "Highlight");
+            std::string_view text = snapshot ? snapshot->Text() : std::string_view(content);
+
             // If we have edits, skip the global cache entirely
             if (!edits.empty()) {
                 DBG_TEDITOR(DebugModule::CACHE, "TokenCache",
                     "Skipping cache lookup due to %zu pending edits", edits.size());
-                auto tokens = highlighter_.HighlightIncremental(content, edits);
+                auto tokens = highlighter_.HighlightIncremental(parse_state_, text, edits);
+                parsed_version_ = this_version;
                 DBG_TEDITOR(DebugModule::HIGHLIGHT, "AsyncProcess",
                     "Generated %zu tokens", tokens.size());
                 return { this_version, std::move(tokens) };
             }
 
+            // The tree no longer matches the text, and a cache hit would not
+            // reparse it: drop it so the next tracked edit parses afresh
+            // instead of editing a stale tree.
+            if (untracked) {
+                parse_state_.Reset();
+                parsed_version_.reset();
+            }
+
             // No edits: attempt to hit the cache
-            size_t h = std::hash<std::string>{}(content);
+            size_t h = std::hash<std::string_view>{}(text);
             if (auto it = token_cache_.find(h); it != token_cache_.end()) {
                 DBG_TEDITOR(DebugModule::CACHE, "TokenCache",
                     "Cache HIT for hash %zx: %zu tokens", h, it->second.size());
@@ -483,7 +789,8 @@ void TextEditor::UpdateHighlightingAsync()
             // Cache miss: do a full incremental highlight and insert into cache
             DBG_TEDITOR(DebugModule::CACHE, "TokenCache",
                 "Cache MISS for hash %zx, highlighting.", h);
-            auto tokens = highlighter_.HighlightIncremental(content, edits);
+            auto tokens = highlighter_.HighlightIncremental(parse_state_, text, edits);
+            parsed_version_ = this_version;
             DBG_TEDITOR(DebugModule::HIGHLIGHT, "AsyncProcess",
                 "Generated %zu tokens", tokens.size());
 
@@ -508,36 +815,62 @@ void TextEditor::UpdateSemanticKindsAsync() {
 
     DBG_TEDITOR(DebugModule::SEMANTIC, "AsyncStart", "Launching async semantic analysis");
 
-    std::string content = GetContent();
-
-    semantic_future_ = std::async(std::launch::async, [this, content = std::move(content)]() {
-        size_t content_hash = std::hash<std::string>{}(content);
+    FileSnapshot::Ptr snapshot;
+    std::string       content;
+    if (content_version_.load() == 0 && snapshot_)
+        snapshot = snapshot_;
+    else
+        content = GetContent();
+
+    const uint64_t version = content_version_.load();
+    const int line_count = static_cast<int>(lines_.size());
+    const int first_visible = std::clamp(visible_line_start_, 0, std::max(line_count - 1, 0));
+    const int last_visible = std::min(first_visible + visible_line_count_, line_count) - 1;
+    semantic_future_ = std::async(std::launch::async,
+        [this, snapshot = std::move(snapshot), content = std::move(content), version,
+         line_count, first_visible, last_visible]()
+        -> std::pair<uint64_t, SemanticLines> {
+        MUT_TRACE_SCOPE(trace::Level::Info, "SEMANTIC", "Semantic");
+        std::string_view text = snapshot ? snapshot->Text() : std::string_view(content);
+        size_t content_hash = std::hash<std::string_view>{}(text);
 
         auto cache_it = semantic_cache_.find(content_hash);
         if (cache_it != semantic_cache_.end()) {
             DBG_TEDITOR(DebugModule::CACHE, "SemanticCache", "Cache HIT for hash %zx", content_hash);
-            return cache_it->second;
+            return { version, cache_it->second };
         }
 
-        DBG_TEDITOR(DebugModule::CACHE, "SemanticCache", "Cache MISS for hash %zx, indexing...", content_hash);
+        DBG_TEDITOR(DebugModule::CACHE, "SemanticCache", "Cache MISS for hash %zx, annotating...", content_hash);
 
-        auto symbols = indexer_.Index(file_path_, content);
-        std::map<std::pair<int, int>, std::string> sem_kind;
+        if (!indexer_.Parse(file_path_, text))
+            return { version, SemanticLines(line_count) };
 
-        DBG_TEDITOR(DebugModule::SEMANTIC, "AsyncProcess", "Indexed %zu symbols", symbols.size());
-
-        for (const auto& sym : symbols) {
-            sem_kind[{sym.line, sym.column}] = sym.kind;
+        // Visible lines first: ProcessPendingSemantics() applies them while
+        // the rest of the file is still being annotated.
+        SemanticLines visible = indexer_.Annotate(file_path_, text, first_visible, last_visible);
+        {
+            std::lock_guard<std::mutex> lock(semantic_mutex_);
+            semantic_visible_ = SemanticRange{ version, first_visible, visible };
         }
 
-        semantic_cache_[content_hash] = sem_kind;
+        SemanticLines sem_lines = indexer_.Annotate(file_path_, text, 0, first_visible - 1);
+        SemanticLines below = indexer_.Annotate(file_path_, text, last_visible + 1, line_count - 1);
+        sem_lines.reserve(line_count);
+        std::move(visible.begin(), visible.end(), std::back_inserter(sem_lines));
+        std::move(below.begin(), below.end(), std::back_inserter(sem_lines));
+        sem_lines.resize(line_count);
+
+        DBG_TEDITOR(DebugModule::SEMANTIC, "AsyncProcess", "Annotated %d lines, visible %d-%d first",
+            line_count, first_visible, last_visible);
+
+        semantic_cache_[content_hash] = sem_lines;
         if (semantic_cache_.size() > 5) {
             DBG_TEDITOR(DebugModule::CACHE, "SemanticCache", "Cache size exceeded limit, clearing");
             semantic_cache_.clear();
-            semantic_cache_[content_hash] = sem_kind;
+            semantic_cache_[content_hash] = sem_lines;
         }
 
-        return sem_kind;
+        return { version, std::move(sem_lines) };
         });
 }
 
@@ -564,11 +897,9 @@ void TextEditor::ProcessPendingHighlights()
         }
 
         DBG_TEDITOR(DebugModule::HIGHLIGHT, "Apply", "Applying %zu tokens", tokens.size());
+        highlighted_version_ = job_ver;
 
-        size_t h = HashContent();
-        token_cache_[h] = tokens;
-
-        RebuildTokensByLine();
+        RebuildTokensByLine(tokens);
         for (auto& c : line_token_cache_)
             c.needs_update = true;
 
@@ -580,44 +911,133 @@ void TextEditor::ProcessPendingHighlights()
 }
 
 void TextEditor::ProcessPendingSemantics() {
+    std::lock_guard<std::mutex> lock(semantic_mutex_);
+
+    // The visible lines of a running job land before the rest of the file.
+    if (semantic_visible_) {
+        if (semantic_visible_->version == content_version_.load()) {
+            sem_lines_.resize(lines_.size());
+            auto& range = *semantic_visible_;
+            for (size_t i = 0; i < range.lines.size() && range.first_line + i < sem_lines_.size(); ++i)
+                sem_lines_[range.first_line + i] = std::move(range.lines[i]);
+
+            DBG_TEDITOR(DebugModule::SEMANTIC, "ApplyVisible", "Applied %zu lines from %d ahead of the full result",
+                range.lines.size(), range.first_line);
+        }
+        semantic_visible_.reset();
+    }
+
     if (semantic_future_.valid() &&
         semantic_future_.wait_for(std::chrono::milliseconds(0)) == std::future_status::ready) {
 
         DBG_TEDITOR(DebugModule::SEMANTIC, "Process", "Semantic result ready");
 
-        std::lock_guard<std::mutex> lock(semantic_mutex_);
-        sem_kind_ = semantic_future_.get();
+        auto [job_ver, lines] = semantic_future_.get();
         semantic_pending_ = false;
 
-        DBG_TEDITOR(DebugModule::SEMANTIC, "Apply", "Applied %zu semantic kinds", sem_kind_.size());
+        // Edits made while libclang ran have shifted sem_lines_ already;
+        // the job's lines address the old text.  Keep the shifted ones and
+        // let RefreshSemanticsIfIdle() schedule a pass for the new text.
+        if (job_ver != content_version_.load()) {
+            DBG_TEDITOR(DebugModule::SEMANTIC, "StaleResult",
+                "Discarding stale result (job v%llu != current v%llu)",
+                static_cast<unsigned long long>(job_ver),
+                static_cast<unsigned long long>(content_version_.load()));
+            return;
+        }
+
+        semantic_version_ = job_ver;
+        sem_lines_ = std::move(lines);
+        DBG_TEDITOR(DebugModule::SEMANTIC, "Apply", "Applied semantic tokens for %zu lines", sem_lines_.size());
     }
 }
 
-void TextEditor::RebuildTokensByLine() {
+// Re-index once typing has paused for SEMANTIC_DEBOUNCE; libclang is far
+// too slow to run per keystroke like the highlighter.
+void TextEditor::RefreshSemanticsIfIdle()
+{
+    if (large_file_ || semantic_pending_ || semantic_version_ == content_version_.load())
+        return;
+    if (std::chrono::steady_clock::now() - last_edit_time_ < SEMANTIC_DEBOUNCE)
+        return;
+    UpdateSemanticKindsAsync();
+}
+
+void TextEditor::UpdateWindowHighlightAsync()
+{
+    // One window job at a time; the next Draw() re-checks once it lands.
+    if (window_future_.valid())
+        return;
+
+    const uint64_t version = content_version_.load();
+    const int total = static_cast<int>(lines_.size());
+    const int first_visible = visible_line_start_;
+    const int last_visible = std::min(visible_line_start_ + visible_line_count_, total);
+
+    if (window_valid_ && window_.version == version &&
+        first_visible >= window_.first_line &&
+        last_visible <= window_.first_line + static_cast<int>(window_.tokens_by_line.size()))
+        return;
+
+    const int first = std::max(0, first_visible - kWindowMargin);
+    const int last = std::min(total, last_visible + kWindowMargin);
+
+    std::string text;
+    for (int i = first; i < last; ++i) {
+        text += lines_.View(i);
+        text += '\n';
+    }
+
+    DBG_TEDITOR(DebugModule::HIGHLIGHT, "WindowStart",
+        "Highlighting lines %d-%d (%zu bytes), version=%llu",
+        first, last, text.size(), static_cast<unsigned long long>(version));
+
+    window_future_ = std::async(std::launch::async,
+        [this, text = std::move(text), version, first, count = last - first]() {
+        WindowHighlight result;
+        result.version = version;
+        result.first_line = first;
+        result.tokens_by_line.resize(count);
+
+        for (const auto& tok : highlighter_.HighlightRange(text, first)) {
+            int idx = tok.line - 1 - first;
+            if (idx >= 0 && idx < count)
+                result.tokens_by_line[idx].push_back(tok);
+        }
+        for (auto& line_tokens : result.tokens_by_line)
+            std::sort(line_tokens.begin(), line_tokens.end(),
+                [](const auto& a, const auto& b) { return a.column < b.column; });
+        return result;
+        });
+}
+
+void TextEditor::ProcessPendingWindowHighlight()
+{
+    if (window_future_.valid() &&
+        window_future_.wait_for(std::chrono::milliseconds(0)) == std::future_status::ready) {
+        window_ = window_future_.get();
+        window_valid_ = true;
+        highlighted_version_ = window_.version;
+
+        DBG_TEDITOR(DebugModule::HIGHLIGHT, "WindowApply", "Window at line %d, %zu lines",
+            window_.first_line, window_.tokens_by_line.size());
+    }
+}
+
+void TextEditor::RebuildTokensByLine(const std::vector<SyntaxToken>& tokens) {
     DBG_TEDITOR(DebugModule::HIGHLIGHT, "RebuildLines", "Rebuilding tokens for %zu lines", lines_.size());
 
     std::lock_guard<std::mutex> lock(tokens_mutex_);
 
-    // Store old tokens for fallback
-    auto old_tokens_by_line = tokens_by_line_;
-
     // Clear and resize
     tokens_by_line_.clear();
     tokens_by_line_.resize(lines_.size());
 
-    size_t content_hash = HashContent();
-    auto cache_it = token_cache_.find(content_hash);
-    if (cache_it == token_cache_.end()) {
-        DBG_TEDITOR(DebugModule::HIGHLIGHT, "RebuildLines", "No tokens found, keeping old tokens");
-        tokens_by_line_ = old_tokens_by_line;
-        return;
-    }
-
     size_t token_count = 0;
     // Distribute new tokens to lines
-    for (const auto& token : cache_it->second) {
+    for (const auto& token : tokens) {
         int line_idx = token.line - 1;
-        if (line_idx >= 0 && line_idx < tokens_by_line_.size()) {
+        if (line_idx >= 0 && line_idx < static_cast<int>(tokens_by_line_.size())) {
             tokens_by_line_[line_idx].push_back(token);
             token_count++;
         }
@@ -639,16 +1059,25 @@ void TextEditor::RebuildTokensByLine() {
 }
 
 std::vector<SyntaxToken> TextEditor::GetVisibleTokensForLine(int line_number) {
-    if (line_number < 0 || line_number >= lines_.size()) {
+    if (line_number < 0 || line_number >= static_cast<int>(lines_.size())) {
         DBG_TEDITOR(DebugModule::RENDER, "GetTokens", "Invalid line number: %d", line_number);
         return {};
     }
 
+    if (large_file_) {
+        const int idx = line_number - window_.first_line;
+        if (window_valid_ && idx >= 0 && idx < static_cast<int>(window_.tokens_by_line.size()))
+            return FilterVisibleTokens(window_.tokens_by_line[idx]);
+        return {};   // outside the highlighted window: drawn as plain text
+    }
+
+    if (line_versions_.size() != lines_.size())
+        StampLines(line_versions_.size(), lines_.size());
     auto& cache = line_token_cache_[line_number];
-    size_t line_hash = HashLine(lines_[line_number]);
+    const uint64_t line_version = line_versions_[line_number];
 
     // Check if cache is valid and doesn't need update
-    if (cache.is_valid && !cache.needs_update && cache.line_hash == line_hash) {
+    if (cache.is_valid && !cache.needs_update && cache.line_version == line_version) {
         //G_TEDITOR(DebugModule::CACHE, "LineCache", "Cache HIT for line %d", line_number);
         return FilterVisibleTokens(cache.tokens);
     }
@@ -658,11 +1087,11 @@ std::vector<SyntaxToken> TextEditor::GetVisibleTokensForLine(int line_number) {
     // Update cache from tokens_by_line
     {
         std::lock_guard<std::mutex> lock(tokens_mutex_);
-        if (line_number < tokens_by_line_.size()) {
+        if (line_number < static_cast<int>(tokens_by_line_.size())) {
             // If we have new tokens, use them
             if (!tokens_by_line_[line_number].empty()) {
                 cache.tokens = tokens_by_line_[line_number];
-                cache.line_hash = line_hash;
+                cache.line_version = line_version;
                 cache.is_valid = true;
                 cache.needs_update = false;
                 DBG_TEDITOR(DebugModule::CACHE, "LineCache", "Updated line %d with %zu tokens",
@@ -671,17 +1100,18 @@ std::vector<SyntaxToken> TextEditor::GetVisibleTokensForLine(int line_number) {
             // If no new tokens but cache is invalid, create default tokens
             else if (!cache.is_valid) {
                 // Create a single default token for the entire line
+                std::string_view line = lines_.View(line_number);
                 cache.tokens.clear();
-                if (!lines_[line_number].empty()) {
+                if (!line.empty()) {
                     cache.tokens.push_back({
                         line_number + 1,
                         0,
-                        static_cast<int>(lines_[line_number].length()),
+                        static_cast<int>(line.length()),
                         TokenType::Default,
                         GetColorForCapture(TokenType::Default)
                         });
                 }
-                cache.line_hash = line_hash;
+                cache.line_version = line_version;
                 cache.is_valid = true;
                 cache.needs_update = true; // Will be updated when new tokens arrive
                 DBG_TEDITOR(DebugModule::CACHE, "LineCache", "Created default token for line %d", line_number);
@@ -713,35 +1143,6 @@ std::vector<SyntaxToken> TextEditor::FilterVisibleTokens(const std::vector<Synta
     return visible_tokens;
 }
 
-void TextEditor::CalculateVisibleArea() {
-    ImGuiContext* g = ImGui::GetCurrentContext();
-    if (!g) return;
-
-    float window_height = ImGui::GetWindowHeight();
-    float line_height = ImGui::GetTextLineHeightWithSpacing();
-
-    int old_line_count = visible_line_count_;
-    int old_line_start = visible_line_start_;
-
-    visible_line_count_ = static_cast<int>(window_height / line_height) + 2;
-
-    float scroll_y = ImGui::GetScrollY();
-    visible_line_start_ = std::max(0, static_cast<int>(scroll_y / line_height) - 1);
-    visible_line_start_ = std::min(visible_line_start_, static_cast<int>(lines_.size()) - 1);
-
-    float scroll_x = ImGui::GetScrollX();
-    visible_column_start_ = scroll_x / ImGui::GetTextLineHeightWithSpacing();
-    visible_column_width_ = ImGui::GetContentRegionAvail().x / ImGui::GetTextLineHeightWithSpacing();
-
-    if (old_line_start != visible_line_start_ || old_line_count != visible_line_count_) {
-        DBG_TEDITOR(DebugModule::RENDER, "VisibleArea",
-            "Updated: lines %d-%d (count=%d), cols %.1f-%.1f",
-            visible_line_start_, visible_line_start_ + visible_line_count_,
-            visible_line_count_, visible_column_start_,
-            visible_column_start_ + visible_column_width_);
-    }
-}
-
 void TextEditor::UpdateContentFromLines(int start_line, int end_line)
 {
     if (end_line < 0) {
@@ -760,6 +1161,30 @@ void TextEditor::UpdateContentFromLines(int start_line, int end_line)
         static_cast<unsigned long long>(old_version),
         static_cast<unsigned long long>(content_version_.load()));
 
+    // Edited lines get their encoding re-detected on next use.
+    line_encoding_.resize(lines_.size(), kEncodingUnknown);
+    if (start_line >= 0) {
+        for (int i = start_line; i <= end_line && i < static_cast<int>(line_encoding_.size()); ++i)
+            line_encoding_[i] = kEncodingUnknown;
+    }
+    else {
+        std::fill(line_encoding_.begin(), line_encoding_.end(), kEncodingUnknown);
+    }
+
+    // Large files: the version bump is all Draw() needs to refresh the window.
+    if (large_file_) return;
+
+    if (start_line >= 0)
+        StampLines(start_line, static_cast<size_t>(end_line - start_line + 1));
+    else
+        StampLines(0, lines_.size());
+
+    {
+        std::lock_guard<std::mutex> lock(edit_mutex_);
+        if (!edit_tracked_) untracked_edit_ = true;
+        edit_tracked_ = false;
+    }
+
     // keep cache vectors in sync with buffer size
     if (line_token_cache_.size() != lines_.size()) {
         DBG_TEDITOR(DebugModule::CACHE, "Resize", "Resizing line cache from %zu to %zu",
@@ -819,7 +1244,9 @@ void TextEditor::UpdateContentFromLines(int start_line, int end_line)
 
 void TextEditor::SaveUndo()
 {
-    size_t old_size = undo_stack_.size();
+    // Undo states are whole-buffer copies; not an option for large files.
+    if (large_file_) return;
+
     undo_stack_.push_back({ GetContent(), cursor_ });
 
     if (undo_stack_.size() > MAX_UNDO_STACK) {
@@ -838,6 +1265,7 @@ void TextEditor::SaveUndo()
 
 void TextEditor::Undo()
 {
+    Wake();
     if (undo_stack_.empty()) {
         DBG_TEDITOR(DebugModule::UNDO, "Undo", "No undo states available");
         return;
@@ -861,6 +1289,7 @@ void TextEditor::Undo()
 
 void TextEditor::Redo()
 {
+    Wake();
     if (redo_stack_.empty()) {
         DBG_TEDITOR(DebugModule::UNDO, "Redo", "No redo states available");
         return;
@@ -882,10 +1311,17 @@ void TextEditor::Redo()
         cursor_.line, cursor_.column);
 }
 
-void TextEditor::InsertChar(char c)
+void TextEditor::InsertChar(uint32_t codepoint)
 {
-    DBG_TEDITOR(DebugModule::EDIT, "InsertChar", "Inserting '%c' (0x%02X) at (%d, %d)",
-        isprint(c) ? c : '?', (unsigned char)c, cursor_.line, cursor_.column);
+    char      utf8[4];
+    const int len = Utf8Encode(codepoint, utf8);
+    InsertTyped(std::string_view(utf8, len));
+}
+
+void TextEditor::InsertTyped(std::string_view utf8)
+{
+    DBG_TEDITOR(DebugModule::EDIT, "InsertTyped", "Inserting %zu bytes at (%d, %d)",
+        utf8.size(), cursor_.line, cursor_.column);
 
     if (has_selection_) {
         DBG_TEDITOR(DebugModule::SELECTION, "Clear", "Clearing selection before insert");
@@ -904,8 +1340,9 @@ void TextEditor::InsertChar(char c)
     }
     last_type_time_ = now;
 
-    lines_[cursor_.line].insert(cursor_.column, 1, c);
-    cursor_.column++;
+    lines_[cursor_.line].insert(cursor_.column, utf8.data(), utf8.size());
+    TrackEdit(cursor_.line, cursor_.column, 0, utf8.size());
+    cursor_.column += static_cast<int>(utf8.size());
 
     DBG_TEDITOR(DebugModule::CURSOR, "Move", "Cursor moved to (%d, %d)", cursor_.line, cursor_.column);
 
@@ -931,7 +1368,7 @@ void TextEditor::InsertNewLine()
     DBG_TEDITOR(DebugModule::EDIT, "Split", "Split line %d: '%s' | '%s'",
         cursor_.line, line.c_str(), new_line.c_str());
 
-    lines_.insert(lines_.begin() + cursor_.line + 1, new_line);
+    lines_.insert(cursor_.line + 1, new_line);
     InsertLineCaches(cursor_.line + 1);
 
     cursor_.line++;
@@ -974,20 +1411,22 @@ void TextEditor::DeleteChar()
         DBG_TEDITOR(DebugModule::EDIT, "MergeLines", "Merging line %d with line %d",
             cursor_.line, cursor_.line - 1);
         cursor_.line--;
-        cursor_.column = lines_[cursor_.line].length();
-        lines_[cursor_.line] += lines_[cursor_.line + 1];
-        lines_.erase(lines_.begin() + cursor_.line + 1);
+        auto& line = lines_[cursor_.line];
+        cursor_.column = line.length();
+        line += lines_.View(cursor_.line + 1);
+        lines_.erase(cursor_.line + 1);
         EraseLineCaches(cursor_.line + 1);
 
         UpdateContentFromLines(cursor_.line, lines_.size() - 1);
     }
     else {
-        char deleted_char = lines_[cursor_.line][cursor_.column - 1];
-        DBG_TEDITOR(DebugModule::EDIT, "DeleteChar", "Deleting '%c' (0x%02X)",
-            isprint(deleted_char) ? deleted_char : '?', (unsigned char)deleted_char);
+        const int start = IsAsciiLine(cursor_.line)
+            ? cursor_.column - 1
+            : static_cast<int>(Utf8PrevBoundary(lines_.View(cursor_.line), cursor_.column));
+        DBG_TEDITOR(DebugModule::EDIT, "DeleteChar", "Deleting %d byte(s)", cursor_.column - start);
 
-        lines_[cursor_.line].erase(cursor_.column - 1, 1);
-        cursor_.column--;
+        lines_[cursor_.line].erase(start, cursor_.column - start);
+        cursor_.column = start;
         UpdateContentFromLines(cursor_.line, cursor_.line);
     }
 
@@ -999,11 +1438,13 @@ void TextEditor::MoveCursorLeft()
     CursorPosition old_pos = cursor_;
 
     if (cursor_.column > 0) {
-        cursor_.column--;
+        cursor_.column = IsAsciiLine(cursor_.line)
+            ? cursor_.column - 1
+            : static_cast<int>(Utf8PrevBoundary(lines_.View(cursor_.line), cursor_.column));
     }
     else if (cursor_.line > 0) {
         cursor_.line--;
-        cursor_.column = lines_[cursor_.line].length();
+        cursor_.column = lines_.View(cursor_.line).length();
     }
 
     DBG_TEDITOR(DebugModule::CURSOR, "Left", "Moved from (%d, %d) to (%d, %d)",
@@ -1014,10 +1455,12 @@ void TextEditor::MoveCursorRight()
 {
     CursorPosition old_pos = cursor_;
 
-    if (cursor_.column < lines_[cursor_.line].length()) {
-        cursor_.column++;
+    if (cursor_.column < static_cast<int>(lines_.View(cursor_.line).length())) {
+        cursor_.column = IsAsciiLine(cursor_.line)
+            ? cursor_.column + 1
+            : static_cast<int>(Utf8NextBoundary(lines_.View(cursor_.line), cursor_.column));
     }
-    else if (cursor_.line < lines_.size() - 1) {
+    else if (cursor_.line < static_cast<int>(lines_.size()) - 1) {
         cursor_.line++;
         cursor_.column = 0;
     }
@@ -1031,9 +1474,10 @@ void TextEditor::MoveCursorUp()
     CursorPosition old_pos = cursor_;
 
     if (cursor_.line > 0) {
+        // keep the visual column, not the byte offset
+        const size_t display = DisplayColumn(cursor_.line, cursor_.column);
         cursor_.line--;
-        cursor_.column = std::min(cursor_.column,
-            static_cast<int>(lines_[cursor_.line].length()));
+        cursor_.column = ByteFromDisplayColumn(cursor_.line, display);
     }
 
     DBG_TEDITOR(DebugModule::CURSOR, "Up", "Moved from (%d, %d) to (%d, %d)",
@@ -1044,16 +1488,42 @@ void TextEditor::MoveCursorDown()
 {
     CursorPosition old_pos = cursor_;
 
-    if (cursor_.line < lines_.size() - 1) {
+    if (cursor_.line < static_cast<int>(lines_.size()) - 1) {
+        const size_t display = DisplayColumn(cursor_.line, cursor_.column);
         cursor_.line++;
-        cursor_.column = std::min(cursor_.column,
-            static_cast<int>(lines_[cursor_.line].length()));
+        cursor_.column = ByteFromDisplayColumn(cursor_.line, display);
     }
 
     DBG_TEDITOR(DebugModule::CURSOR, "Down", "Moved from (%d, %d) to (%d, %d)",
         old_pos.line, old_pos.column, cursor_.line, cursor_.column);
 }
 
+bool TextEditor::IsAsciiLine(int line)
+{
+    if (line < 0 || line >= static_cast<int>(lines_.size())) return true;
+    if (line_encoding_.size() != lines_.size())
+        line_encoding_.resize(lines_.size(), kEncodingUnknown);
+
+    uint8_t& encoding = line_encoding_[line];
+    if (encoding == kEncodingUnknown)
+        encoding = Utf8IsAscii(lines_.View(line)) ? kEncodingAscii : kEncodingMultibyte;
+    return encoding == kEncodingAscii;
+}
+
+size_t TextEditor::DisplayColumn(int line, int byte)
+{
+    if (IsAsciiLine(line)) return static_cast<size_t>(std::max(byte, 0));
+    return Utf8ByteToCodepoint(lines_.View(line), static_cast<size_t>(std::max(byte, 0)));
+}
+
+int TextEditor::ByteFromDisplayColumn(int line, size_t display_column)
+{
+    std::string_view text = lines_.View(line);
+    if (IsAsciiLine(line))
+        return static_cast<int>(std::min(display_column, text.size()));
+    return static_cast<int>(Utf8CodepointToByte(text, display_column));
+}
+
 std::string TextEditor::GetSelectedText() {
     if (!has_selection_) {
         DBG_TEDITOR(DebugModule::SELECTION, "GetText", "No selection active");
@@ -1067,19 +1537,19 @@ std::string TextEditor::GetSelectedText() {
         start.line, start.column, end.line, end.column);
 
     if (start.line == end.line) {
-        return lines_[start.line].substr(start.column, end.column - start.column);
+        return std::string(lines_.View(start.line).substr(start.column, end.column - start.column));
     }
 
     std::string result;
-    result += lines_[start.line].substr(start.column);
+    result += lines_.View(start.line).substr(start.column);
     result += '\n';
 
     for (int i = start.line + 1; i < end.line; ++i) {
-        result += lines_[i];
+        result += lines_.View(i);
         result += '\n';
     }
 
-    result += lines_[end.line].substr(0, end.column);
+    result += lines_.View(end.line).substr(0, end.column);
 
     DBG_TEDITOR(DebugModule::SELECTION, "GetText", "Selected text: %zu bytes", result.size());
     return result;
@@ -1106,10 +1576,10 @@ void TextEditor::DeleteSelectedText() {
         UpdateContentFromLines(start.line, start.line);
     }
     else {
-        lines_[start.line] = lines_[start.line].substr(0, start.column)
-            + lines_[end.line].substr(end.column);
-        lines_.erase(lines_.begin() + start.line + 1,
-            lines_.begin() + end.line + 1);
+        std::string merged(lines_.View(start.line).substr(0, start.column));
+        merged += lines_.View(end.line).substr(end.column);
+        lines_[start.line] = std::move(merged);
+        lines_.erase(start.line + 1, removed);
 
         EraseLineCaches(start.line + 1, removed);
         UpdateContentFromLines(start.line, lines_.size() - 1);
@@ -1124,6 +1594,7 @@ void TextEditor::DeleteSelectedText() {
 }
 
 void TextEditor::PasteText(const std::string& text) {
+    Wake();
     DBG_TEDITOR(DebugModule::CLIPBOARD, "Paste", "Pasting %zu bytes at (%d, %d)",
         text.size(), cursor_.line, cursor_.column);
 
@@ -1151,30 +1622,32 @@ void TextEditor::PasteText(const std::string& text) {
     std::string suffix = curLine.substr(cursor_.column);
 
     // 3) Replace the current line with prefix + first pasted line
+    const int startLine = cursor_.line;
     lines_[cursor_.line] = prefix + newLines[0];
 
-    // 4) Insert any middle lines
-    for (size_t i = 1; i < newLines.size(); ++i) {
-        lines_.insert(
-            lines_.begin() + cursor_.line + i,
-            newLines[i]
-        );
-        InsertLineCaches(cursor_.line + i);
+    // 4) Insert the remaining lines, and their caches, as one block;
+    //    the saved suffix goes onto the very last pasted line
+    const size_t lastLine = cursor_.line + newLines.size() - 1;
+    const int lastColumn = static_cast<int>(newLines.back().size());
+    if (newLines.size() > 1) {
+        newLines.back() += suffix;
+        lines_.insert(cursor_.line + 1, std::vector<std::string>(
+            std::make_move_iterator(newLines.begin() + 1), std::make_move_iterator(newLines.end())));
+        InsertLineCaches(cursor_.line + 1, newLines.size() - 1);
+    }
+    else {
+        lines_[lastLine] += suffix;
     }
 
-    // 5) Append the saved suffix onto the very last pasted line
-    size_t lastLine = cursor_.line + newLines.size() - 1;
-    lines_[lastLine] += suffix;
-
-    // 6) Move the cursor to the end of the pasted text
+    // 5) Move the cursor to the end of the pasted text
     cursor_.line = static_cast<int>(lastLine);
-    cursor_.column = static_cast<int>(newLines.back().size());
+    cursor_.column = lastColumn;
 
-    // 7) Mark that we need to scroll so the cursor is visible
+    // 6) Mark that we need to scroll so the cursor is visible
     scrollToCursor_ = true;
 
-    // 8) Update from start line to end
-    UpdateContentFromLines(cursor_.line, lines_.size() - 1);
+    // 7) Update from start line to end
+    UpdateContentFromLines(startLine, lines_.size() - 1);
 
     DBG_TEDITOR(DebugModule::CURSOR, "Move", "Cursor at (%d, %d) after paste",
         cursor_.line, cursor_.column);
@@ -1210,786 +1683,14 @@ void TextEditor::InsertTextAtCursor(const std::string& text) {
     UpdateContentFromLines(start_line, cursor_.line);
 }
 
-void TextEditor::DrawFindReplacePanel() {
-    //DBG_TEDITOR(DebugModule::RENDER, "FindPanel", "Drawing find/replace panel");
-
-    ImGui::SetNextWindowSizeConstraints(ImVec2(400, 0), ImVec2(FLT_MAX, FLT_MAX));
-    ImGui::SetNextWindowBgAlpha(0.95f); // semi-transparent
-    ImGui::SetNextWindowPos(ImVec2(ImGui::GetMainViewport()->Pos.x + 20, ImGui::GetMainViewport()->Pos.y + 20), ImGuiCond_FirstUseEver);
-
-    ImGui::Begin("Find / Replace", &show_find_panel_, ImGuiWindowFlags_AlwaysAutoResize);
-
-    static bool find_case_sensitive = false;
-    static char find_buf[512] = "";
-    static char replace_buf[512] = "";
-    strncpy(find_buf, find_query_.c_str(), sizeof(find_buf));
-    strncpy(replace_buf, replace_text_.c_str(), sizeof(replace_buf));
-
-    ImGui::InputText("Find", find_buf, sizeof(find_buf));
-    ImGui::SameLine();
-    ImGui::Checkbox("Regex", &find_use_regex_);
-    ImGui::SameLine();
-    ImGui::Checkbox("Case Sensitive", &find_case_sensitive_);
-    ImGui::InputText("Replace", replace_buf, sizeof(replace_buf));
-
-    find_query_ = find_buf;
-    replace_text_ = replace_buf;
-
-    if (ImGui::Button("Find All")) {
-        DBG_TEDITOR(DebugModule::SEARCH, "FindAll", "Searching for: %s", find_query_.c_str());
-
-        find_results_.clear();
-        for (int i = 0; i < lines_.size(); ++i) {
-            int start = 0, len = 0;
-            if (MatchFind(lines_[i], start, len)) {
-                find_results_.emplace_back(CursorPosition{ i, start });
-            }
-        }
-        current_find_index_ = 0;
-
-        DBG_TEDITOR(DebugModule::SEARCH, "FindAll", "Found %zu matches", find_results_.size());
-
-        if (!find_results_.empty()) {
-            cursor_ = find_results_[0];
-            scrollToCursor_ = true;
-        }
-    }
-
-    ImGui::SameLine();
-    if (ImGui::Button("Replace All")) {
-        DBG_TEDITOR(DebugModule::SEARCH, "ReplaceAll", "Replacing '%s' with '%s'",
-            find_query_.c_str(), replace_text_.c_str());
-
-        SaveUndo();
-        int total_replacements = 0;
-
-        for (int i = 0; i < lines_.size(); ++i) {
-            size_t search_pos = 0;
-            int start = 0, len = 0;
-            int line_replacements = 0;
-
-            while (MatchFind(lines_[i].substr(search_pos), start, len)) {
-                lines_[i].replace(search_pos + start, len, replace_text_);
-                search_pos += start + replace_text_.length();
-                line_replacements++;
-                total_replacements++;
-            }
-
-            if (line_replacements > 0) {
-                DBG_TEDITOR(DebugModule::SEARCH, "ReplaceLine",
-                    "Line %d: %d replacements", i, line_replacements);
-            }
-        }
-
-        DBG_TEDITOR(DebugModule::SEARCH, "ReplaceAll", "Total replacements: %d", total_replacements);
-        UpdateContentFromLines();
-    }
-
-    if (!find_results_.empty()) {
-        if (ImGui::Button("Previous")) {
-            if (--current_find_index_ < 0)
-                current_find_index_ = (int)find_results_.size() - 1;
-            cursor_ = find_results_[current_find_index_];
-            scrollToCursor_ = true;
-
-            DBG_TEDITOR(DebugModule::SEARCH, "Navigate", "Previous match: %d/%zu at (%d, %d)",
-                current_find_index_ + 1, find_results_.size(),
-                cursor_.line, cursor_.column);
-        }
-        ImGui::SameLine();
-        if (ImGui::Button("Next")) {
-            if (++current_find_index_ >= (int)find_results_.size())
-                current_find_index_ = 0;
-            cursor_ = find_results_[current_find_index_];
-            scrollToCursor_ = true;
-
-            DBG_TEDITOR(DebugModule::SEARCH, "Navigate", "Next match: %d/%zu at (%d, %d)",
-                current_find_index_ + 1, find_results_.size(),
-                cursor_.line, cursor_.column);
-        }
-    }
-
-    ImGui::Text("Matches: %d", (int)find_results_.size());
-    ImGui::End();
-}
-
-void TextEditor::DrawMinimap()
-{
-    ImDrawList* draw_list = ImGui::GetWindowDrawList();
-    ImVec2      canvas_pos = ImGui::GetCursorScreenPos();
-    ImVec2      canvas_size = ImGui::GetContentRegionAvail();
-    float       minimap_w = canvas_size.x;
-    float       minimap_h = canvas_size.y;
-
-    // vertical scale: pixel-per-line, clamped
-    const float kMaxLineH = 7.5f;
-    float scale = minimap_h / std::max(1, (int)lines_.size());
-    scale = std::min(scale, kMaxLineH);
-
-    ImFont* font = ImGui::GetFont();
-    float   font_scale = 0.35f;
-    float   font_size = font->FontSize * font_scale;
-
-    // 1) Find the widest line in pixels
-    float max_line_w = 0.0f;
-    for (auto& line : lines_) {
-        float w = font->CalcTextSizeA(font_size, FLT_MAX, 0.0f, line.c_str()).x;
-        max_line_w = std::max(max_line_w, w);
-    }
-
-    // 2) Compute horizontal scale so max_line_w * hScale == minimap_w
-    float hScale = (max_line_w > 0.0f)
-        ? (minimap_w / max_line_w)
-        : 1.0f;
-
-    // reserve space & handle clicks (unchanged)
-    ImGui::InvisibleButton("##Minimap", ImVec2(minimap_w, minimap_h));
-    if (ImGui::IsItemActive()) {
-        ImVec2 mouse = ImGui::GetMousePos();
-        int lineHit = std::clamp(int((mouse.y - canvas_pos.y) / scale),
-            0, (int)lines_.size() - 1);
-        float lineH = ImGui::GetTextLineHeightWithSpacing();
-        scrollToLineY_ = lineHit * lineH
-            - (visible_line_count_ * 0.5f) * lineH;
-    }
-
-    // clip to minimap rect
-    draw_list->PushClipRect(
-        canvas_pos,
-        ImVec2(canvas_pos.x + minimap_w, canvas_pos.y + minimap_h),
-        true
-    );
-
-    // now draw each line
-    for (int i = 0; i < (int)lines_.size(); ++i) {
-        float y0 = canvas_pos.y + i * scale;
-
-        // background
-        ImU32 bg = IM_COL32(100, 100, 100, 100);
-        if (i >= visible_line_start_ &&
-            i < visible_line_start_ + visible_line_count_)
-            bg = IM_COL32(180, 180, 255, 150);
-        if (std::any_of(find_results_.begin(), find_results_.end(),
-            [i](auto& m) { return m.line == i; }))
-            bg = IM_COL32(255, 255, 100, 180);
-
-        draw_list->AddRectFilled(
-            ImVec2(canvas_pos.x, y0),
-            ImVec2(canvas_pos.x + minimap_w, y0 + scale),
-            bg
-        );
-
-        // gather tokens
-        std::vector<SyntaxToken> toks;
-        {
-            std::lock_guard<std::mutex> lk(tokens_mutex_);
-            if (i < tokens_by_line_.size())
-                toks = tokens_by_line_[i];
-        }
-
-        // un-scaled x offset (pixels)
-        float x_unscaled = 0.0f;
-
-        // draw plain+token+trailing in sequence
-        int col = 0;
-        for (auto& t : toks) {
-            // plain text before this token
-            if (t.column > col) {
-                std::string txt = SafeSubstr(lines_[i], col, t.column - col);
-                ImU32 colTxt = IM_COL32(220, 220, 220, 160);
-
-                // compute display position
-                float x_disp = canvas_pos.x + x_unscaled * hScale;
-                draw_list->AddText(
-                    font,
-                    font_size * hScale,
-                    ImVec2(x_disp, y0),
-                    colTxt,
-                    txt.c_str()
-                );
-                // advance unscaled offset
-                x_unscaled += font->CalcTextSizeA(
-                    font_size, FLT_MAX, 0.0f, txt.c_str()).x;
-            }
-
-            // the token itself
-            std::string tokTxt = SafeSubstr(lines_[i], t.column, t.length);
-            ImU32 colTok = ImGui::ColorConvertFloat4ToU32(t.color);
-            float  x_disp = canvas_pos.x + x_unscaled * hScale;
-            draw_list->AddText(
-                font,
-                font_size * hScale,
-                ImVec2(x_disp, y0),
-                colTok,
-                tokTxt.c_str()
-            );
-            x_unscaled += font->CalcTextSizeA(
-                font_size, FLT_MAX, 0.0f, tokTxt.c_str()).x;
-
-            col = t.column + t.length;
-        }
-
-        // trailing text
-        if (col < (int)lines_[i].size()) {
-            std::string rest = SafeSubstr(lines_[i], col);
-            ImU32 colTxt = IM_COL32(220, 220, 220, 160);
-            float x_disp = canvas_pos.x + x_unscaled * hScale;
-            draw_list->AddText(
-                font,
-                font_size * hScale,
-                ImVec2(x_disp, y0),
-                colTxt,
-                rest.c_str()
-            );
-        }
-    }
-
-    draw_list->PopClipRect();
-}
-
-
-
-
-void TextEditor::Draw() {
-    ProcessPendingHighlights();
-    ProcessPendingSemantics();
-
-    ImGuiIO& io = ImGui::GetIO();
-    ImVec2 avail = ImGui::GetContentRegionAvail();
-    float totalW = avail.x;
-    float minimapW = totalW * 0.10f;    // always 10%
-    float editorW = totalW - minimapW; // the other 90%
-
-    ImGui::SetWindowFontScale(font_scale_);
-    ImVec2 gutterSize = ImGui::CalcTextSize("9999 | ");
-    float gutterWidth = gutterSize.x;
-    if (show_find_panel_)
-        DrawFindReplacePanel();
-    ImGui::BeginChild("TextEditor", ImVec2(editorW, 0), false, ImGuiWindowFlags_NoScrollbar | ImGuiWindowFlags_NoMove);
-    CalculateVisibleArea();
-    if (scrollToLineY_) {
-        ImGui::SetScrollY(std::max(0.0f, *scrollToLineY_));
-        scrollToLineY_.reset();
-    }
-
-    if (ImGui::IsWindowFocused() && !ImGui::IsAnyItemActive() && io.KeyCtrl) {
-        if (ImGui::IsKeyPressed(ImGuiKey_F)) {
-            show_find_panel_ = true;
-        }
-        if (ImGui::IsKeyPressed(ImGuiKey_H)) {
-            show_find_panel_ = true;
-        }
-    }
-
-
-    if (ImGui::IsWindowHovered() && ImGui::GetIO().KeyCtrl && ImGui::GetIO().MouseWheel != 0.0f) {
-        font_scale_ += ImGui::GetIO().MouseWheel * 0.1f;
-        font_scale_ = std::clamp(font_scale_, 0.5f, 3.0f); // clamp to reasonable range
-    }
-
-    // Handle keyboard input
-    if (ImGui::IsWindowFocused() && !ImGui::IsAnyItemActive()) {
-        // Ctrl+C/V/X/Z/Y
-        if (io.KeyCtrl) {
-            if (ImGui::IsKeyPressed(ImGuiKey_C)) {
-                if (has_selection_) {
-                    ImGui::SetClipboardText(GetSelectedText().c_str());
-                }
-            }
-            if (ImGui::IsKeyPressed(ImGuiKey_V)) {
-                if (const char* cb = ImGui::GetClipboardText())
-                    PasteText(cb);
-            }
-            if (ImGui::IsKeyPressed(ImGuiKey_X)) {
-                if (has_selection_) {
-                    ImGui::SetClipboardText(GetSelectedText().c_str());
-                    DeleteSelectedText();
-                }
-            }
-            if (ImGui::IsKeyPressed(ImGuiKey_Z)) {
-                Undo();
-            }
-            if (ImGui::IsKeyPressed(ImGuiKey_Y)) {
-                Redo();
-            }
-            if (ImGui::IsKeyPressed(ImGuiKey_A)) {
-                selection_start_ = { 0, 0 };
-                cursor_ = { static_cast<int>(lines_.size() - 1), static_cast<int>(lines_.back().length()) };
-                has_selection_ = true;
-            }
-        }
-
-        // Navigation
-        if (ImGui::IsKeyPressed(ImGuiKey_LeftArrow)) {
-            if (io.KeyShift && !has_selection_) {
-                SetSelection(cursor_);
-            }
-            MoveCursorLeft();
-            if (!io.KeyShift) {
-                ClearSelection();
-            }
-        }
-        if (ImGui::IsKeyPressed(ImGuiKey_RightArrow)) {
-            if (io.KeyShift && !has_selection_) {
-                SetSelection(cursor_);
-            }
-            MoveCursorRight();
-            if (!io.KeyShift) {
-                ClearSelection();
-            }
-        }
-        if (ImGui::IsKeyPressed(ImGuiKey_UpArrow)) {
-            if (io.KeyShift && !has_selection_) {
-                SetSelection(cursor_);
-            }
-            MoveCursorUp();
-            if (!io.KeyShift) {
-                ClearSelection();
-            }
-        }
-        if (ImGui::IsKeyPressed(ImGuiKey_DownArrow)) {
-            if (io.KeyShift && !has_selection_) {
-                SetSelection(cursor_);
-            }
-            MoveCursorDown();
-            if (!io.KeyShift) {
-                ClearSelection();
-            }
-        }
-
-        // Home/End
-        if (ImGui::IsKeyPressed(ImGuiKey_Home)) {
-            if (io.KeyShift && !has_selection_) {
-                SetSelection(cursor_);
-            }
-            cursor_.column = 0;
-            if (!io.KeyShift) {
-                ClearSelection();
-            }
-        }
-        if (ImGui::IsKeyPressed(ImGuiKey_End)) {
-            if (io.KeyShift && !has_selection_) {
-                SetSelection(cursor_);
-            }
-            cursor_.column = lines_[cursor_.line].length();
-            if (!io.KeyShift) {
-                ClearSelection();
-            }
-        }
-
-        // Editing
-        if (ImGui::IsKeyPressed(ImGuiKey_Tab)) {
-            // If you want a single undo‐step for the whole tab:
-            SaveUndo();
-            InsertTextAtCursor("    ");
-        }
-        if (ImGui::IsKeyPressed(ImGuiKey_Enter)) {
-            InsertNewLine();
-        }
-        if (ImGui::IsKeyPressed(ImGuiKey_Backspace)) {
-            DeleteChar();
-        }
-        if (ImGui::IsKeyPressed(ImGuiKey_Delete)) {
-            if (has_selection_) {
-                DeleteSelectedText();
-            }
-            else if (cursor_.column < lines_[cursor_.line].length()) {
-                SaveUndo();
-                lines_[cursor_.line].erase(cursor_.column, 1);
-                UpdateContentFromLines(cursor_.line, cursor_.line);
-            }
-            else if (cursor_.line < lines_.size() - 1) {
-                SaveUndo();
-                lines_[cursor_.line] += lines_[cursor_.line + 1];
-                lines_.erase(lines_.begin() + cursor_.line + 1);
-                UpdateContentFromLines(cursor_.line, lines_.size() - 1);
-            }
-        }
-
-        // Text input
-        if (io.InputQueueCharacters.Size > 0) {
-            for (int n = 0; n < io.InputQueueCharacters.Size; n++) {
-                auto c = io.InputQueueCharacters[n];
-                if (c != 0 && c != '\n' && c != '\r') {
-                    InsertChar(static_cast<char>(c));
-                }
-            }
-            io.InputQueueCharacters.resize(0);
-        }
-    }
-
-    // Handle mouse input
-    if (ImGui::IsWindowHovered()) {
-        if (ImGui::IsMouseClicked(0)) {
-            // 1) Update click count based on timing
-            double now = ImGui::GetTime();
-            if (now - lastClickTime_ < ImGui::GetIO().MouseDoubleClickTime) {
-                clickCount_ = std::min(clickCount_ + 1, 3);
-            }
-            else {
-                clickCount_ = 1;
-            }
-            lastClickTime_ = now;
-
-            // 2) Figure out which line/column was clicked
-            ImVec2 mouse_pos = ImGui::GetMousePos();
-            ImVec2 window_pos = ImGui::GetWindowPos();
-            float  line_h = ImGui::GetTextLineHeightWithSpacing();
-            int    clickedLine = static_cast<int>((mouse_pos.y - window_pos.y + ImGui::GetScrollY()) / line_h);
-            clickedLine = std::clamp(clickedLine, 0, (int)lines_.size() - 1);
-
-            float x_offset = mouse_pos.x - window_pos.x - gutterWidth;
-            int   clickedCol = 0;
-            {
-                const std::string& line = lines_[clickedLine];
-                float accum = 0;
-                for (int i = 0; i < line.size(); ++i) {
-                    float w = ImGui::CalcTextSize(SafeSubstr(line, i, 1).c_str()).x;
-                    if (accum + w * 0.5f > x_offset + ImGui::GetScrollX())
-                        break;
-                    accum += w;
-                    clickedCol++;
-                }
-            }
-
-            // 3) Dispatch based on clickCount_
-            if (clickCount_ == 2) {
-                // double-click → select word
-                cursor_ = { clickedLine, clickedCol };
-                SelectWordAt(cursor_);
-            }
-            else if (clickCount_ >= 3) {
-                // triple-click → select entire line
-                SelectLineAt(clickedLine);
-            }
-            else {
-                // single-click → move cursor & start/cancel selection
-                cursor_ = { clickedLine, clickedCol };
-                if (ImGui::GetIO().KeyShift) {
-                    if (!has_selection_) SetSelection(cursor_);
-                }
-                else {
-                    ClearSelection();
-                }
-                is_selecting_with_mouse_ = true;
-            }
-        }
-
-        if (ImGui::IsMouseDragging(0) && is_selecting_with_mouse_) {
-            if (!has_selection_) {
-                SetSelection(cursor_);
-            }
-
-            ImVec2 mouse_pos = ImGui::GetMousePos();
-            ImVec2 window_pos = ImGui::GetWindowPos();
-            float line_height = ImGui::GetTextLineHeightWithSpacing();
-
-            // Corrected: subtract scroll Y
-            int clicked_line = static_cast<int>((mouse_pos.y - window_pos.y + ImGui::GetScrollY()) / line_height);
-            clicked_line = std::clamp(clicked_line, 0, static_cast<int>(lines_.size()) - 1);
-
-            float x_offset = mouse_pos.x - window_pos.x - gutterWidth;
-            int column = 0;
-            if (clicked_line < lines_.size()) {
-                const std::string& line = lines_[clicked_line];
-                float text_width = 0;
-                for (int i = 0; i < line.length(); ++i) {
-                    float char_width = ImGui::CalcTextSize(SafeSubstr(line, i, 1).c_str()).x;
-                    if (text_width + char_width * 0.5f > x_offset + ImGui::GetScrollX()) {
-                        break;
-                    }
-                    text_width += char_width;
-                    column++;
-                }
-            }
-
-            cursor_ = { clicked_line, column };
-        }
-
-        if (ImGui::IsMouseClicked(ImGuiMouseButton_Right)) {
-            ImVec2 mouse_pos = ImGui::GetMousePos();
-            ImVec2 window_pos = ImGui::GetWindowPos();
-            float line_h = ImGui::GetTextLineHeightWithSpacing();
-            int clicked_line = static_cast<int>((mouse_pos.y - window_pos.y + ImGui::GetScrollY()) / line_h);
-            clicked_line = std::clamp(clicked_line, 0, (int)lines_.size() - 1);
-
-            float x_offset = mouse_pos.x - window_pos.x - gutterWidth;
-            int clicked_col = 0;
-            {
-                const std::string& line = lines_[clicked_line];
-                float accum = 0;
-                for (int i = 0; i < line.size(); ++i) {
-                    float w = ImGui::CalcTextSize(SafeSubstr(line, i, 1).c_str()).x;
-                    if (accum + w * 0.5f > x_offset + ImGui::GetScrollX())
-                        break;
-                    accum += w;
-                    clicked_col++;
-                }
-            }
-
-            // If no selection, move cursor to click location
-            if (!has_selection_) {
-                cursor_ = { clicked_line, clicked_col };
-                ClearSelection();
-            }
-
-            // Open context menu popup
-            ImGui::OpenPopup("TextEditorContextMenu");
-        }
-
-        if (ImGui::IsMouseReleased(0)) {
-            is_selecting_with_mouse_ = false;
-        }
-    }
-
-    if (ImGui::BeginPopup("TextEditorContextMenu")) {
-        if (has_selection_) {
-            if (ImGui::MenuItem("Copy", "Ctrl+C")) {
-                ImGui::SetClipboardText(GetSelectedText().c_str());
-            }
-
-            if (ImGui::MenuItem("Paste", "Ctrl+V")) {
-                if (const char* cb = ImGui::GetClipboardText())
-                    PasteText(cb);
-            }
-
-            if (ImGui::MenuItem("Cut", "Ctrl+X")) {
-                ImGui::SetClipboardText(GetSelectedText().c_str());
-                DeleteSelectedText();
-            }
-        }
-        else {
-            if (ImGui::MenuItem("Copy Line")) {
-                ImGui::SetClipboardText(lines_[cursor_.line].c_str());
-            }
-
-            if (ImGui::MenuItem("Paste", "Ctrl+V")) {
-                if (const char* cb = ImGui::GetClipboardText())
-                    PasteText(cb);
-            }
-
-            if (ImGui::MenuItem("Cut Line")) {
-                SaveUndo();
-                ImGui::SetClipboardText(lines_[cursor_.line].c_str());
-                lines_.erase(lines_.begin() + cursor_.line);
-                if (lines_.empty()) lines_.push_back("");
-                cursor_.line = std::min(cursor_.line, (int)lines_.size() - 1);
-                cursor_.column = std::min(cursor_.column, (int)lines_[cursor_.line].size());
-                UpdateContentFromLines();
-            }
-
-            ImGui::Separator();
-
-            if (ImGui::MenuItem("Undo", "Ctrl+Z", false, !undo_stack_.empty())) {
-                Undo();
-            }
-
-            if (ImGui::MenuItem("Redo", "Ctrl+Y", false, !redo_stack_.empty())) {
-                Redo();
-            }
-
-            ImGui::Separator();
-
-            if (ImGui::MenuItem("Select All", "Ctrl+A")) {
-                selection_start_ = { 0, 0 };
-                cursor_ = { static_cast<int>(lines_.size() - 1), static_cast<int>(lines_.back().length()) };
-                has_selection_ = true;
-            }
-        }
-
-        ImGui::EndPopup();
-    }
-
-    if (scrollToCursor_) {
-        // Vertical scroll only if cursor is off-screen
-        if (cursor_.line < visible_line_start_ ||
-            cursor_.line >= visible_line_start_ + visible_line_count_)
-        {
-            float lineH = ImGui::GetTextLineHeightWithSpacing();
-            // center cursor line in view
-            float targetY = cursor_.line * lineH - (visible_line_count_ / 2) * lineH;
-            ImGui::SetScrollY(std::max(0.0f, targetY));
-        }
-
-        // Horizontal scroll only if cursor column is off-screen
-        float scrollX = ImGui::GetScrollX();
-        float availW = ImGui::GetContentRegionAvail().x;
-        // measure the width of all text up to the cursor
-        std::string  line = lines_[cursor_.line];
-        std::string  before = SafeSubstr(line, 0, cursor_.column);
-        float cursorPx = ImGui::CalcTextSize(before.c_str()).x;
-
-        // if the cursor is left of scroll or right of visible area, recenter it
-        if (cursorPx < scrollX || cursorPx > scrollX + availW) {
-            float targetX = cursorPx - (availW * 0.5f);
-            ImGui::SetScrollX(std::max(0.0f, targetX));
-        }
-        scrollToCursor_ = false;
-    }
-
-    ImVec2 window_pos = ImGui::GetWindowPos();
-    float window_width = ImGui::GetWindowWidth();
-
-    int end_line = std::min(visible_line_start_ + visible_line_count_,
-        static_cast<int>(lines_.size()));
-
-    if (visible_line_start_ > 0) {
-        float skip_height = visible_line_start_ * ImGui::GetTextLineHeightWithSpacing();
-        ImGui::SetCursorPosY(ImGui::GetCursorPosY() + skip_height);
-    }
-
-    std::map<std::pair<int, int>, std::string> local_sem_kind;
-    {
-        std::lock_guard<std::mutex> lock(semantic_mutex_);
-        local_sem_kind = sem_kind_;
-    }
-
-    for (int lineNo = visible_line_start_; lineNo < end_line; ++lineNo) {
-        char buf[32];
-        sprintf(buf, "%4d | ", lineNo + 1);
-        ImGui::TextUnformatted(buf);
-        ImGui::SameLine(0, 0);
-        float line_height = ImGui::GetTextLineHeightWithSpacing();
-        ImVec2 text_start = ImGui::GetCursorScreenPos();
-
-        if (!find_results_.empty()) {
-            // Highlight matched lines and matches
-            for (const auto& match : find_results_) {
-                if (match.line == lineNo) {
-                    // Highlight the entire line (dim background)
-                    ImVec2 highlight_start = ImVec2(window_pos.x, text_start.y);
-                    ImVec2 highlight_end = ImVec2(window_pos.x + window_width, text_start.y + line_height);
-                    ImGui::GetWindowDrawList()->AddRectFilled(highlight_start, highlight_end, IM_COL32(60, 80, 20, 60));
-
-                    // Highlight the matched substring (stronger highlight)
-                    int match_col = match.column;
-                    std::string match_text = SafeSubstr(lines_[lineNo], match_col, find_query_.length());
-
-                    ImVec2 match_start = text_start;
-                    match_start.x += ImGui::CalcTextSize(SafeSubstr(lines_[lineNo], 0, match_col).c_str()).x;
-
-                    ImVec2 match_end = match_start;
-                    match_end.x += ImGui::CalcTextSize(match_text.c_str()).x;
-                    match_end.y += line_height;
-
-                    ImGui::GetWindowDrawList()->AddRectFilled(match_start, match_end, IM_COL32(200, 200, 0, 100));
-                }
-            }
-        }
-
-        const std::string& line = lines_[lineNo];
-
-        bool is_cursor_line = (cursor_.line == lineNo);
-        if (is_cursor_line) {
-            ImVec2 highlight_start = ImVec2(window_pos.x, text_start.y);
-            ImVec2 highlight_end = ImVec2(window_pos.x + window_width, text_start.y + line_height);
-            ImGui::GetWindowDrawList()->AddRectFilled(highlight_start, highlight_end,
-                IM_COL32(60, 60, 120, 60));
-        }
-
-        static float blink_timer = 0.0f;
-        static bool blink_on = true;
-
-        blink_timer += io.DeltaTime;
-        if (blink_timer >= 15) {
-            blink_timer = 0.0f;
-            blink_on = !blink_on;
-        }
-
-        if (is_cursor_line && blink_on && ImGui::IsWindowFocused()) {
-            float x = text_start.x + ImGui::CalcTextSize(SafeSubstr(line, 0, cursor_.column).c_str()).x;
-            float y = text_start.y;
-            ImGui::GetWindowDrawList()->AddLine(
-                ImVec2(x, y), ImVec2(x, y + line_height),
-                IM_COL32(255, 255, 255, 255), 1.5f
-            );
-        }
-
-        if (has_selection_) {
-            CursorPosition sel_start = std::min(cursor_, selection_start_);
-            CursorPosition sel_end = std::max(cursor_, selection_start_);
-
-            if (lineNo >= sel_start.line && lineNo <= sel_end.line) {
-                int begin_col = (lineNo == sel_start.line) ? sel_start.column : 0;
-                int end_col = (lineNo == sel_end.line) ? sel_end.column : static_cast<int>(line.size());
-
-                if (begin_col < end_col) {
-                    std::string segment = SafeSubstr(line, begin_col, end_col - begin_col);
-
-                    ImVec2 sel_start_pos = text_start;
-                    sel_start_pos.x += ImGui::CalcTextSize(SafeSubstr(line, 0, begin_col).c_str()).x;
-
-                    ImVec2 sel_end_pos = sel_start_pos;
-                    sel_end_pos.x += ImGui::CalcTextSize(segment.c_str()).x;
-                    sel_end_pos.y += line_height;
-
-                    ImGui::GetWindowDrawList()->AddRectFilled(sel_start_pos, sel_end_pos,
-                        IM_COL32(100, 100, 255, 80));
-                }
-            }
-        }
-
-        auto lineTokens = GetVisibleTokensForLine(lineNo);
-
-        int col = 0;
-        for (const auto& tok : lineTokens) {
-            if (tok.column < col) continue;
-
-            if (tok.column > col) {
-                std::string text = SafeSubstr(line, col, tok.column - col);
-                ImGui::TextUnformatted(text.c_str());
-                ImGui::SameLine(0, 0);
-            }
-
-            ImVec4 color = tok.color;
-            auto sem_it = local_sem_kind.find({ tok.line, tok.column });
-            if (sem_it != local_sem_kind.end()) {
-                color = GetSemanticColor(sem_it->second);
-            }
-
-            int tok_end = tok.column + tok.length;
-            if (tok_end > visible_column_start_ && tok.column < visible_column_start_ + visible_column_width_) {
-                ImGui::PushStyleColor(ImGuiCol_Text, color);
-                ImGui::TextUnformatted(SafeSubstr(line, tok.column, tok.length).c_str());
-                ImGui::PopStyleColor();
-                ImGui::SameLine(0, 0);
-            }
-
-            col = tok_end;
-        }
-
-        if (col < static_cast<int>(line.size())) {
-            ImGui::TextUnformatted(SafeSubstr(line, col).c_str());
-            ImGui::SameLine(0, 0);
-        }
-
-        ImGui::NewLine();
-    }
-
-    int remaining_lines = static_cast<int>(lines_.size()) - end_line;
-    if (remaining_lines > 0) {
-        float skip_height = remaining_lines * ImGui::GetTextLineHeightWithSpacing();
-        ImGui::SetCursorPosY(ImGui::GetCursorPosY() + skip_height);
-    }
-    ImGui::SetWindowFontScale(1.0f);
-    ImGui::EndChild();
-
-    ImGui::SameLine();
-    ImGui::BeginChild("Minimap", ImVec2(minimapW, 0), false,
-        ImGuiWindowFlags_NoScrollbar | ImGuiWindowFlags_NoScrollWithMouse);
-    DrawMinimap();
-    
-    ImGui::EndChild();
-}
-
 void TextEditor::SelectWordAt(const CursorPosition& pos)
 {
-    if (pos.line >= lines_.size()) return;
-    const std::string& line = lines_[pos.line];
-    if (pos.column >= line.size()) return;
+    if (pos.line >= static_cast<int>(lines_.size())) return;
+    std::string_view line = lines_.View(pos.line);
+    if (pos.column >= static_cast<int>(line.size())) return;
 
     auto isWord = [](char c) {
-        return std::isalnum((unsigned char)c) || c == '_' || c == '-';
+        return std::isalnum((unsigned char)c) || c == '_' || c == '-' || (unsigned char)c >= 0x80;
         };
     if (!isWord(line[pos.column])) return;
 
@@ -2009,13 +1710,13 @@ void TextEditor::SelectWordAt(const CursorPosition& pos)
 }
 void TextEditor::SelectLineAt(int lineIdx)
 {
-    if (lineIdx >= lines_.size()) return;
+    if (lineIdx >= static_cast<int>(lines_.size())) return;
 
     selection_start_ = { lineIdx, 0 };
-    cursor_ = { lineIdx, (int)lines_[lineIdx].size() };
+    cursor_ = { lineIdx, (int)lines_.View(lineIdx).size() };
     has_selection_ = true;
 
     DBG_TEDITOR(DebugModule::SELECTION, "SelectLine",
         "line %d selected (length=%zu)",
-        lineIdx, lines_[lineIdx].size());
+        lineIdx, lines_.View(lineIdx).size());
 }
\ No newline at end of file
@@ -8,8 +8,14 @@
 #include <future>
 #include <atomic>
 #include <mutex>
+#include <optional>
+#include <memory>
+#include <algorithm>
 #include "syntax_highlighter.h"
 #include "clang_indexer.h"
+#include "file_snapshot.h"
+#include "input_trace.h"
+#include "line_store.h"
 #include <tree_sitter/api.h>
 #include <utility>
 
@@ -47,7 +53,7 @@ struct TextEdit {
 
 // Line-based caching with update tracking
 struct LineCache {
-    size_t line_hash = 0;
+    uint64_t line_version = 0;  // TextEditor::line_versions_ stamp the tokens were built for
     std::vector<SyntaxToken> tokens;
     bool is_valid = false;
     bool needs_update = false;  // New field for tracking if update is pending
@@ -67,11 +73,102 @@ public:
     void SetContent(const std::string& content);
     void MoveCursorTo(int line, int column)
     {
+        Wake();
         cursor_.line = std::clamp(line, 0, (int)lines_.size() - 1);
-        cursor_.column = std::clamp(column, 0, (int)lines_[cursor_.line].size());
+        cursor_.column = std::clamp(column, 0, (int)lines_.View(cursor_.line).size());
         scrollToCursor_ = true;
     }
 
+    /// The file as it was loaded from disk (shared, read-only).
+    const FileSnapshot::Ptr& Snapshot() const { return snapshot_; }
+
+    /// Files at or above this size open in large-file mode: lines stay in the
+    /// mapping until edited, only the viewport is highlighted, semantic
+    /// indexing and undo are off.
+    static void   SetLargeFileThreshold(size_t bytes) { s_large_file_threshold_ = bytes; }
+    static size_t LargeFileThreshold() { return s_large_file_threshold_; }
+    bool          IsLargeFile() const { return large_file_; }
+
+    /// Headless driving (tools, benchmarks): the code paths keyboard input
+    /// takes in Draw(), without an ImGui context.
+    void   TypeText(std::string_view utf8);   // one keystroke per code point, '\n' is Enter
+    void   Backspace() { DeleteChar(); }
+    void   PasteText(const std::string& text);
+    void   Undo();
+    void   Redo();
+    void   Update();                          // apply finished background jobs, as each Draw() does
+    bool   HasPendingWork() const;            // a highlight / semantic job is still in flight
+    size_t LineCount() const { return lines_.size(); }
+    size_t TokenCount();
+    std::vector<SyntaxToken> Tokens();        // applied highlight, line by line
+    size_t SemanticKindCount();
+    CursorPosition Cursor() const { return cursor_; }
+
+    /// Replay one recorded keystroke: restore its cursor / selection, then
+    /// take the same edit path the keyboard handler would.
+    void   ApplyInput(const InputEvent& event);
+
+    /// Content versions (bumped by every edit) and the versions the applied
+    /// highlight / semantic results were computed from.  A keystroke made
+    /// at version v is on screen once HighlightedVersion() >= v.
+    uint64_t ContentVersion() const { return content_version_.load(); }
+    uint64_t HighlightedVersion() const { return highlighted_version_; }
+    uint64_t SemanticVersion() const { return semantic_version_; }
+
+    /// Background jobs of this document: running now, and queued behind
+    /// them (a follow-up highlight, a semantic pass waiting out its debounce).
+    struct BackgroundWork {
+        int highlight_running = 0;
+        int highlight_queued = 0;
+        int semantic_running = 0;
+        int semantic_queued = 0;
+    };
+    BackgroundWork BackgroundQueue() const;
+
+    /// Approximate heap bytes held by this document, per structure.  The
+    /// mapped file is listed apart and left out of Total(): it is read-only,
+    /// file-backed and paged in and out by the OS.
+    struct MemoryUsage {
+        size_t buffer = 0;             // owned lines, joined content, encoding flags, heap snapshot
+        size_t undo = 0;               // undo + redo snapshots
+        size_t tokens_by_line = 0;     // incl. the large-file window
+        size_t line_token_cache = 0;
+        size_t token_cache = 0;
+        size_t semantic = 0;           // sem_lines_ + semantic_cache_
+        size_t translation_unit = 0;   // libclang TU of this path
+        size_t mapped = 0;             // FileSnapshot of a large file
+
+        size_t Total() const {
+            return buffer + undo + tokens_by_line + line_token_cache
+                + token_cache + semantic + translation_unit;
+        }
+    };
+    MemoryUsage MemoryFootprint();
+
+    /// Hibernation for tabs nobody is looking at: the buffer is joined into
+    /// one string (or dropped when it still equals the loaded file), undo
+    /// and redo snapshots are delta-encoded against each other, the derived
+    /// token caches are dropped and the libclang TU is released (later, by
+    /// CollectBackgroundWork, while another tab's parse holds it).  The last
+    /// highlight is kept in compact form, so Wake() restores the colours
+    /// without reparsing.  Refused (false) while background jobs run.
+    /// Every entry point that touches the buffer wakes the editor first.
+    bool Hibernate();
+    void Wake();
+    bool IsHibernated() const { return hibernated_ != nullptr; }
+    /// Apply finished background jobs like Update(), but without waking
+    /// the editor or starting a debounced semantic pass.  For tabs that are
+    /// not drawn: their jobs must still be collected before they can
+    /// hibernate.  A hibernated tab retries releasing its TU here.
+    void CollectBackgroundWork();
+
+    /// Outline from the tree-sitter tags query over the highlighter's tree
+    /// of the current text (SyntaxHighlighter::Outline).  Empty optional
+    /// while no such tree exists yet: a highlight job is in flight, the
+    /// text changed since the last parse, or the tab hibernates.  Every
+    /// answer runs the query again (milliseconds).
+    std::optional<SymbolList> TakeOutline();
+
 private:
     bool find_case_sensitive_ = false;
     std::optional<float> scrollToLineY_;
@@ -99,12 +196,53 @@ private:
     bool is_selecting_with_mouse_ = false;
 
     // Content state
-    std::vector<std::string> lines_;
+    FileSnapshot::Ptr snapshot_;
+    LineStore lines_;
+    // Per-line encoding flags, kept index-aligned with lines_ so pure ASCII
+    // lines (the common case) map columns in O(1).
+    enum LineEncoding : uint8_t { kEncodingUnknown = 0, kEncodingAscii, kEncodingMultibyte };
+    std::vector<uint8_t> line_encoding_;
+    // Per-line version stamps, index-aligned with lines_ like line_encoding_.
+    // Every edit path restamps the lines it touches from a monotonic clock,
+    // so a LineCache is current iff its stamp matches: no rehashing per frame.
+    std::vector<uint64_t> line_versions_;
+    uint64_t line_version_clock_ = 0;
+    // Byte offset of each line in the joined text, for TrackEdit.  Only a
+    // prefix is kept: entry i depends on lines before i, so restamping
+    // line `first` drops the entries after it and typing on one line
+    // finds its offset in O(1).
+    std::vector<size_t> line_starts_;
+    bool large_file_ = false;
+    static inline size_t s_large_file_threshold_ = 32u * 1024 * 1024;
     mutable std::string cached_content_;
     mutable bool content_dirty_ = true;
 
+    // Hibernation state (see Hibernate())
+    struct UndoDelta {              // a snapshot relative to its newer neighbour
+        size_t         prefix = 0;  // bytes shared at the front
+        size_t         suffix = 0;  // bytes shared at the back
+        std::string    middle;      // what differs in between
+        CursorPosition cursor;
+    };
+    struct CompactToken {           // SyntaxToken without its (derived) colour
+        int       line, column, length;
+        TokenType type;
+    };
+    struct HibernatedState {
+        bool                      from_snapshot = false;   // buffer == snapshot_
+        std::string               text;                    // joined buffer otherwise
+        std::vector<UndoDelta>    undo, redo;              // stack order, top last
+        std::vector<CompactToken> tokens;
+    };
+    std::unique_ptr<HibernatedState> hibernated_;
+    bool tu_release_pending_ = false;   // hibernated, TU still cached
+    static std::vector<UndoDelta>   EncodeStack(std::string_view current, const std::vector<EditorState>& stack);
+    static std::vector<EditorState> DecodeStack(std::string_view current, const std::vector<UndoDelta>& deltas);
+
     // Edit tracking for incremental updates
     std::vector<TextEdit> pending_edits_;
+    bool edit_tracked_ = false;     // the edit being applied called TrackEdit()
+    bool untracked_edit_ = false;   // pending_edits_ misses an edit: parse fully
     std::mutex edit_mutex_;
 
     // Undo/Redo
@@ -114,28 +252,55 @@ private:
 
     // External dependencies
     std::string file_path_;
-    SyntaxHighlighter& highlighter_;
+    SyntaxHighlighter& highlighter_;          // shared by all documents of the language
+    SyntaxHighlighter::ParseState parse_state_;   // this document's tree; used by one highlight job at a time
+    std::optional<uint64_t> parsed_version_;      // content version parse_state_ was parsed from
     ClangIndexer& indexer_;
 
     // Threading for background processing
     std::future<std::pair<uint64_t, std::vector<SyntaxToken>>> highlight_future_;
     std::atomic<bool> highlight_pending_{ false };
     std::atomic<bool> highlight_dirty_{ false };
-    std::future<std::map<std::pair<int, int>, std::string>> semantic_future_;
+    std::future<std::pair<uint64_t, SemanticLines>> semantic_future_;
     std::atomic<bool> semantic_pending_{ false };
+    uint64_t highlighted_version_ = 0;
+    uint64_t semantic_version_ = 0;
+
+    // Large-file mode: highlight a window of lines around the viewport only
+    struct WindowHighlight {
+        uint64_t version = 0;
+        int first_line = 0;
+        std::vector<std::vector<SyntaxToken>> tokens_by_line;
+    };
+    static constexpr int kWindowMargin = 200;   // lines parsed above/below the viewport
+    std::future<WindowHighlight> window_future_;
+    WindowHighlight window_;
+    bool window_valid_ = false;
 
     // Token storage with line-based organization
     std::vector<std::vector<SyntaxToken>> tokens_by_line_;
     std::mutex tokens_mutex_;
 
-    // Semantic information
-    std::map<std::pair<int, int>, std::string> sem_kind_;
+    // Semantic information: per-line (column, length, kind) arrays, kept
+    // index-aligned with lines_.  A job annotates the visible lines first
+    // and stages them in semantic_visible_ before annotating the rest.
+    struct SemanticRange {
+        uint64_t version = 0;
+        int first_line = 0;
+        SemanticLines lines;
+    };
+    SemanticLines sem_lines_;
+    std::optional<SemanticRange> semantic_visible_;
     std::mutex semantic_mutex_;
 
     // Smart caching
     std::vector<LineCache> line_token_cache_;
     std::unordered_map<size_t, std::vector<SyntaxToken>> token_cache_;
-    std::unordered_map<size_t, std::map<std::pair<int, int>, std::string>> semantic_cache_;
+    std::unordered_map<size_t, SemanticLines> semantic_cache_;
+    // The two caches above are written by the background jobs; while one
+    // runs, MemoryFootprint() reports the size it last measured.
+    size_t token_cache_bytes_ = 0;
+    size_t semantic_cache_bytes_ = 0;
 
     // Timing for debouncing
     std::chrono::steady_clock::time_point last_edit_time_;
@@ -159,13 +324,15 @@ private:
     void UpdateSemanticKindsAsync();
     void ProcessPendingHighlights();
     void ProcessPendingSemantics();
+    void RefreshSemanticsIfIdle();
+    void UpdateWindowHighlightAsync();
+    void ProcessPendingWindowHighlight();
     void SaveUndo();
-    void Undo();
-    void Redo();
-    void InsertChar(char c);
+    void InsertChar(uint32_t codepoint);
+    void InsertTyped(std::string_view utf8);   // a run of typed characters, no newlines
     void DeleteChar();
     void InsertNewLine();
-    void PasteText(const std::string& text);
+    void RecordInput(InputEvent::Kind kind, uint32_t codepoint = 0, std::string_view text = {});
 
 
     void UpdateContentFromLines(int start_line = -1, int end_line = -1);  // Updated signature
@@ -173,6 +340,11 @@ private:
     void MoveCursorRight();
     void MoveCursorUp();
     void MoveCursorDown();
+
+    // UTF-8 aware column helpers (columns are byte offsets)
+    bool IsAsciiLine(int line);
+    size_t DisplayColumn(int line, int byte);
+    int ByteFromDisplayColumn(int line, size_t display_column);
     void ClearSelection() { has_selection_ = false; }
     void SetSelection(const CursorPosition& start) { selection_start_ = start; has_selection_ = true; }
     std::string GetSelectedText();
@@ -183,12 +355,14 @@ private:
     void CalculateVisibleArea();
     std::vector<SyntaxToken> GetVisibleTokensForLine(int line_number);
     std::vector<SyntaxToken> FilterVisibleTokens(const std::vector<SyntaxToken>& tokens);  // New method
-    size_t HashLine(const std::string& line) const;
-    size_t HashContent() const;
-    void TrackEdit(size_t start_byte, size_t old_length, size_t new_length);
-    void RebuildTokensByLine();
+    void StampLines(size_t first, size_t count);
+    // Queue a tree-sitter edit for the next highlight job: `old_length`
+    // bytes at (line, column) replaced by `new_length` bytes on that line.
+    // Edits that are not tracked make the next job parse from scratch.
+    void TrackEdit(int line, int column, size_t old_length, size_t new_length);
+    void RebuildTokensByLine(const std::vector<SyntaxToken>& tokens);
 
     void DrawMinimap();
     void DrawFindReplacePanel();
-    bool MatchFind(const std::string& line, int& match_start, int& match_len);
+    bool MatchFind(std::string_view line, int& match_start, int& match_len);
 };
\ No newline at end of file
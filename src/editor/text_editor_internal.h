@@ -0,0 +1,78 @@
+#pragma once
+// ===== text_editor_internal.h =====
+// Shared by the two halves of TextEditor: text_editor.cpp (buffer, edit
+// tracking, background highlight / semantic jobs) and text_editor_view.cpp
+// (ImGui drawing and input).  Not part of the editor's public interface.
+#include <algorithm>
+#include <climits>
+#include <string>
+#include <string_view>
+#include "platform/trace.h"
+
+// Debug modules, recorded as trace categories (see platform/trace.h).
+enum class DebugModule {
+    CORE,         // Core operations (constructor, destructor, etc.)
+    EDIT,         // Text editing operations
+    CURSOR,       // Cursor movement
+    SELECTION,    // Selection operations
+    CLIPBOARD,    // Copy/paste operations
+    UNDO,         // Undo/redo operations
+    HIGHLIGHT,    // Syntax highlighting
+    SEMANTIC,     // Semantic analysis
+    CACHE,        // Cache operations
+    RENDER,       // Rendering operations
+    SEARCH,       // Find/replace operations
+    MOUSE,        // Mouse operations
+    KEYBOARD,     // Keyboard input
+    MINIMAP,      // Minimap operations
+    SCROLL,       // Scrolling operations
+    PERF          // Performance metrics
+};
+
+static constexpr const char* GetModuleName(DebugModule module) {
+    switch (module) {
+    case DebugModule::CORE:      return "CORE";
+    case DebugModule::EDIT:      return "EDIT";
+    case DebugModule::CURSOR:    return "CURSOR";
+    case DebugModule::SELECTION: return "SELECTION";
+    case DebugModule::CLIPBOARD: return "CLIPBOARD";
+    case DebugModule::UNDO:      return "UNDO";
+    case DebugModule::HIGHLIGHT: return "HIGHLIGHT";
+    case DebugModule::SEMANTIC:  return "SEMANTIC";
+    case DebugModule::CACHE:     return "CACHE";
+    case DebugModule::RENDER:    return "RENDER";
+    case DebugModule::SEARCH:    return "SEARCH";
+    case DebugModule::MOUSE:     return "MOUSE";
+    case DebugModule::KEYBOARD:  return "KEYBOARD";
+    case DebugModule::MINIMAP:   return "MINIMAP";
+    case DebugModule::SCROLL:    return "SCROLL";
+    case DebugModule::PERF:      return "PERF";
+    default:                     return "UNKNOWN";
+    }
+}
+
+// Modules that fire per keystroke or per frame only record at Verbose.
+static constexpr trace::Level GetModuleLevel(DebugModule module) {
+    switch (module) {
+    case DebugModule::CURSOR:
+    case DebugModule::CACHE:
+    case DebugModule::RENDER:
+    case DebugModule::MOUSE:
+    case DebugModule::KEYBOARD:
+    case DebugModule::MINIMAP:
+    case DebugModule::SCROLL:    return trace::Level::Verbose;
+    default:                     return trace::Level::Debug;
+    }
+}
+
+#define DBG_TEDITOR(module, action, fmt, ...) \
+    MUT_TRACE(GetModuleLevel(module), GetModuleName(module), action, fmt, ##__VA_ARGS__)
+
+inline std::string SafeSubstr(std::string_view s, int pos, int count = INT_MAX)
+{
+    if (pos < 0 || pos >= (int)s.size())
+        return "";
+    // clamp count so pos+count ≤ s.size()
+    int maxCount = std::min(count, (int)s.size() - pos);
+    return std::string(s.substr(pos, maxCount));
+}
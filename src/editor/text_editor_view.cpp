@@ -0,0 +1,860 @@
+﻿#include "text_editor.h"
+#include <algorithm>
+#include "imgui.h"
+#include "imgui_internal.h"
+#include "utf8.h"
+#include "text_editor_internal.h"
+#include "gui/frame_profiler.h"
+
+/*---------------------------------------------------------------------------
+    TextEditor, view half: everything that talks to ImGui (layout, drawing,
+    keyboard and mouse input, find panel, minimap).  The buffer, edit
+    tracking and background jobs live in text_editor.cpp.
+---------------------------------------------------------------------------*/
+
+// Byte column under `x` (relative to the text start), stepping whole code
+// points so a click never lands inside a multibyte sequence.
+static int ColumnFromX(std::string_view line, float x)
+{
+    float  accum = 0;
+    size_t i = 0;
+    while (i < line.size()) {
+        size_t next = Utf8NextBoundary(line, i);
+        float  w = ImGui::CalcTextSize(line.data() + i, line.data() + next).x;
+        if (accum + w * 0.5f > x)
+            break;
+        accum += w;
+        i = next;
+    }
+    return static_cast<int>(i);
+}
+
+void TextEditor::CalculateVisibleArea() {
+    ImGuiContext* g = ImGui::GetCurrentContext();
+    if (!g) return;
+
+    float window_height = ImGui::GetWindowHeight();
+    float line_height = ImGui::GetTextLineHeightWithSpacing();
+
+    int old_line_count = visible_line_count_;
+    int old_line_start = visible_line_start_;
+
+    visible_line_count_ = static_cast<int>(window_height / line_height) + 2;
+
+    float scroll_y = ImGui::GetScrollY();
+    visible_line_start_ = std::max(0, static_cast<int>(scroll_y / line_height) - 1);
+    visible_line_start_ = std::min(visible_line_start_, static_cast<int>(lines_.size()) - 1);
+
+    float scroll_x = ImGui::GetScrollX();
+    visible_column_start_ = scroll_x / ImGui::GetTextLineHeightWithSpacing();
+    visible_column_width_ = ImGui::GetContentRegionAvail().x / ImGui::GetTextLineHeightWithSpacing();
+
+    if (old_line_start != visible_line_start_ || old_line_count != visible_line_count_) {
+        DBG_TEDITOR(DebugModule::RENDER, "VisibleArea",
+            "Updated: lines %d-%d (count=%d), cols %.1f-%.1f",
+            visible_line_start_, visible_line_start_ + visible_line_count_,
+            visible_line_count_, visible_column_start_,
+            visible_column_start_ + visible_column_width_);
+    }
+}
+
+void TextEditor::DrawFindReplacePanel() {
+    //DBG_TEDITOR(DebugModule::RENDER, "FindPanel", "Drawing find/replace panel");
+
+    ImGui::SetNextWindowSizeConstraints(ImVec2(400, 0), ImVec2(FLT_MAX, FLT_MAX));
+    ImGui::SetNextWindowBgAlpha(0.95f); // semi-transparent
+    ImGui::SetNextWindowPos(ImVec2(ImGui::GetMainViewport()->Pos.x + 20, ImGui::GetMainViewport()->Pos.y + 20), ImGuiCond_FirstUseEver);
+
+    ImGui::Begin("Find / Replace", &show_find_panel_, ImGuiWindowFlags_AlwaysAutoResize);
+
+    static char find_buf[512] = "";
+    static char replace_buf[512] = "";
+    strncpy(find_buf, find_query_.c_str(), sizeof(find_buf));
+    strncpy(replace_buf, replace_text_.c_str(), sizeof(replace_buf));
+
+    ImGui::InputText("Find", find_buf, sizeof(find_buf));
+    ImGui::SameLine();
+    ImGui::Checkbox("Regex", &find_use_regex_);
+    ImGui::SameLine();
+    ImGui::Checkbox("Case Sensitive", &find_case_sensitive_);
+    ImGui::InputText("Replace", replace_buf, sizeof(replace_buf));
+
+    find_query_ = find_buf;
+    replace_text_ = replace_buf;
+
+    if (ImGui::Button("Find All")) {
+        DBG_TEDITOR(DebugModule::SEARCH, "FindAll", "Searching for: %s", find_query_.c_str());
+
+        find_results_.clear();
+        for (int i = 0; i < static_cast<int>(lines_.size()); ++i) {
+            int start = 0, len = 0;
+            if (MatchFind(lines_.View(i), start, len)) {
+                find_results_.emplace_back(CursorPosition{ i, start });
+            }
+        }
+        current_find_index_ = 0;
+
+        DBG_TEDITOR(DebugModule::SEARCH, "FindAll", "Found %zu matches", find_results_.size());
+
+        if (!find_results_.empty()) {
+            cursor_ = find_results_[0];
+            scrollToCursor_ = true;
+        }
+    }
+
+    ImGui::SameLine();
+    if (ImGui::Button("Replace All")) {
+        DBG_TEDITOR(DebugModule::SEARCH, "ReplaceAll", "Replacing '%s' with '%s'",
+            find_query_.c_str(), replace_text_.c_str());
+
+        SaveUndo();
+        int total_replacements = 0;
+
+        for (int i = 0; i < static_cast<int>(lines_.size()); ++i) {
+            size_t search_pos = 0;
+            int start = 0, len = 0;
+            int line_replacements = 0;
+
+            // Only lines that actually match get materialized.
+            if (!MatchFind(lines_.View(i), start, len))
+                continue;
+
+            std::string& line = lines_[i];
+            while (MatchFind(std::string_view(line).substr(search_pos), start, len)) {
+                line.replace(search_pos + start, len, replace_text_);
+                search_pos += start + replace_text_.length();
+                line_replacements++;
+                total_replacements++;
+            }
+
+            if (line_replacements > 0) {
+                DBG_TEDITOR(DebugModule::SEARCH, "ReplaceLine",
+                    "Line %d: %d replacements", i, line_replacements);
+            }
+        }
+
+        DBG_TEDITOR(DebugModule::SEARCH, "ReplaceAll", "Total replacements: %d", total_replacements);
+        UpdateContentFromLines();
+    }
+
+    if (!find_results_.empty()) {
+        if (ImGui::Button("Previous")) {
+            if (--current_find_index_ < 0)
+                current_find_index_ = (int)find_results_.size() - 1;
+            cursor_ = find_results_[current_find_index_];
+            scrollToCursor_ = true;
+
+            DBG_TEDITOR(DebugModule::SEARCH, "Navigate", "Previous match: %d/%zu at (%d, %d)",
+                current_find_index_ + 1, find_results_.size(),
+                cursor_.line, cursor_.column);
+        }
+        ImGui::SameLine();
+        if (ImGui::Button("Next")) {
+            if (++current_find_index_ >= (int)find_results_.size())
+                current_find_index_ = 0;
+            cursor_ = find_results_[current_find_index_];
+            scrollToCursor_ = true;
+
+            DBG_TEDITOR(DebugModule::SEARCH, "Navigate", "Next match: %d/%zu at (%d, %d)",
+                current_find_index_ + 1, find_results_.size(),
+                cursor_.line, cursor_.column);
+        }
+    }
+
+    ImGui::Text("Matches: %d", (int)find_results_.size());
+    ImGui::End();
+}
+
+void TextEditor::DrawMinimap()
+{
+    ImDrawList* draw_list = ImGui::GetWindowDrawList();
+    ImVec2      canvas_pos = ImGui::GetCursorScreenPos();
+    ImVec2      canvas_size = ImGui::GetContentRegionAvail();
+    float       minimap_w = canvas_size.x;
+    float       minimap_h = canvas_size.y;
+
+    if (large_file_) {
+        // Rendering every line is exactly what large-file mode avoids; show
+        // where the viewport sits in the file instead.
+        const float total = static_cast<float>(std::max<size_t>(1, lines_.size()));
+        ImGui::InvisibleButton("##Minimap", ImVec2(minimap_w, minimap_h));
+        if (ImGui::IsItemActive() && minimap_h > 0.0f) {
+            float frac = std::clamp((ImGui::GetMousePos().y - canvas_pos.y) / minimap_h, 0.0f, 1.0f);
+            float lineH = ImGui::GetTextLineHeightWithSpacing();
+            scrollToLineY_ = frac * total * lineH - (visible_line_count_ * 0.5f) * lineH;
+        }
+
+        float y0 = canvas_pos.y + minimap_h * (visible_line_start_ / total);
+        float y1 = canvas_pos.y + minimap_h * ((visible_line_start_ + visible_line_count_) / total);
+        draw_list->AddRectFilled(canvas_pos,
+            ImVec2(canvas_pos.x + minimap_w, canvas_pos.y + minimap_h),
+            IM_COL32(100, 100, 100, 100));
+        draw_list->AddRectFilled(ImVec2(canvas_pos.x, y0),
+            ImVec2(canvas_pos.x + minimap_w, std::max(y1, y0 + 2.0f)),
+            IM_COL32(180, 180, 255, 150));
+        return;
+    }
+
+    // vertical scale: pixel-per-line, clamped
+    const float kMaxLineH = 7.5f;
+    float scale = minimap_h / std::max(1, (int)lines_.size());
+    scale = std::min(scale, kMaxLineH);
+
+    ImFont* font = ImGui::GetFont();
+    float   font_scale = 0.35f;
+    float   font_size = font->FontSize * font_scale;
+
+    // 1) Find the widest line in pixels
+    float max_line_w = 0.0f;
+    for (size_t i = 0; i < lines_.size(); ++i) {
+        std::string_view line = lines_.View(i);
+        float w = font->CalcTextSizeA(font_size, FLT_MAX, 0.0f, line.data(), line.data() + line.size()).x;
+        max_line_w = std::max(max_line_w, w);
+    }
+
+    // 2) Compute horizontal scale so max_line_w * hScale == minimap_w
+    float hScale = (max_line_w > 0.0f)
+        ? (minimap_w / max_line_w)
+        : 1.0f;
+
+    // reserve space & handle clicks (unchanged)
+    ImGui::InvisibleButton("##Minimap", ImVec2(minimap_w, minimap_h));
+    if (ImGui::IsItemActive()) {
+        ImVec2 mouse = ImGui::GetMousePos();
+        int lineHit = std::clamp(int((mouse.y - canvas_pos.y) / scale),
+            0, (int)lines_.size() - 1);
+        float lineH = ImGui::GetTextLineHeightWithSpacing();
+        scrollToLineY_ = lineHit * lineH
+            - (visible_line_count_ * 0.5f) * lineH;
+    }
+
+    // clip to minimap rect
+    draw_list->PushClipRect(
+        canvas_pos,
+        ImVec2(canvas_pos.x + minimap_w, canvas_pos.y + minimap_h),
+        true
+    );
+
+    // now draw each line
+    for (int i = 0; i < (int)lines_.size(); ++i) {
+        float y0 = canvas_pos.y + i * scale;
+
+        // background
+        ImU32 bg = IM_COL32(100, 100, 100, 100);
+        if (i >= visible_line_start_ &&
+            i < visible_line_start_ + visible_line_count_)
+            bg = IM_COL32(180, 180, 255, 150);
+        if (std::any_of(find_results_.begin(), find_results_.end(),
+            [i](auto& m) { return m.line == i; }))
+            bg = IM_COL32(255, 255, 100, 180);
+
+        draw_list->AddRectFilled(
+            ImVec2(canvas_pos.x, y0),
+            ImVec2(canvas_pos.x + minimap_w, y0 + scale),
+            bg
+        );
+
+        // gather tokens
+        std::vector<SyntaxToken> toks;
+        {
+            std::lock_guard<std::mutex> lk(tokens_mutex_);
+            if (i < static_cast<int>(tokens_by_line_.size()))
+                toks = tokens_by_line_[i];
+        }
+
+        // un-scaled x offset (pixels)
+        float x_unscaled = 0.0f;
+
+        // draw plain+token+trailing in sequence
+        int col = 0;
+        for (auto& t : toks) {
+            // plain text before this token
+            if (t.column > col) {
+                std::string txt = SafeSubstr(lines_.View(i), col, t.column - col);
+                ImU32 colTxt = IM_COL32(220, 220, 220, 160);
+
+                // compute display position
+                float x_disp = canvas_pos.x + x_unscaled * hScale;
+                draw_list->AddText(
+                    font,
+                    font_size * hScale,
+                    ImVec2(x_disp, y0),
+                    colTxt,
+                    txt.c_str()
+                );
+                // advance unscaled offset
+                x_unscaled += font->CalcTextSizeA(
+                    font_size, FLT_MAX, 0.0f, txt.c_str()).x;
+            }
+
+            // the token itself
+            std::string tokTxt = SafeSubstr(lines_.View(i), t.column, t.length);
+            ImU32 colTok = ImGui::ColorConvertFloat4ToU32(t.color);
+            float  x_disp = canvas_pos.x + x_unscaled * hScale;
+            draw_list->AddText(
+                font,
+                font_size * hScale,
+                ImVec2(x_disp, y0),
+                colTok,
+                tokTxt.c_str()
+            );
+            x_unscaled += font->CalcTextSizeA(
+                font_size, FLT_MAX, 0.0f, tokTxt.c_str()).x;
+
+            col = t.column + t.length;
+        }
+
+        // trailing text
+        if (col < (int)lines_.View(i).size()) {
+            std::string rest = SafeSubstr(lines_.View(i), col);
+            ImU32 colTxt = IM_COL32(220, 220, 220, 160);
+            float x_disp = canvas_pos.x + x_unscaled * hScale;
+            draw_list->AddText(
+                font,
+                font_size * hScale,
+                ImVec2(x_disp, y0),
+                colTxt,
+                rest.c_str()
+            );
+        }
+    }
+
+    draw_list->PopClipRect();
+}
+
+
+
+
+void TextEditor::Draw() {
+    Wake();
+    FrameProfiler::Scope results("Text editor: results");
+    ProcessPendingHighlights();
+    ProcessPendingSemantics();
+    RefreshSemanticsIfIdle();
+    ProcessPendingWindowHighlight();
+    results.end();
+
+    ImGuiIO& io = ImGui::GetIO();
+    ImVec2 avail = ImGui::GetContentRegionAvail();
+    float totalW = avail.x;
+    float minimapW = totalW * 0.10f;    // always 10%
+    float editorW = totalW - minimapW; // the other 90%
+
+    ImGui::SetWindowFontScale(font_scale_);
+    ImVec2 gutterSize = ImGui::CalcTextSize("9999 | ");
+    float gutterWidth = gutterSize.x;
+    if (show_find_panel_)
+        DrawFindReplacePanel();
+    ImGui::BeginChild("TextEditor", ImVec2(editorW, 0), false, ImGuiWindowFlags_NoScrollbar | ImGuiWindowFlags_NoMove);
+    CalculateVisibleArea();
+    if (large_file_)
+        UpdateWindowHighlightAsync();
+    if (scrollToLineY_) {
+        ImGui::SetScrollY(std::max(0.0f, *scrollToLineY_));
+        scrollToLineY_.reset();
+    }
+
+    if (ImGui::IsWindowFocused() && !ImGui::IsAnyItemActive() && io.KeyCtrl) {
+        if (ImGui::IsKeyPressed(ImGuiKey_F)) {
+            show_find_panel_ = true;
+        }
+        if (ImGui::IsKeyPressed(ImGuiKey_H)) {
+            show_find_panel_ = true;
+        }
+    }
+
+
+    if (ImGui::IsWindowHovered() && ImGui::GetIO().KeyCtrl && ImGui::GetIO().MouseWheel != 0.0f) {
+        font_scale_ += ImGui::GetIO().MouseWheel * 0.1f;
+        font_scale_ = std::clamp(font_scale_, 0.5f, 3.0f); // clamp to reasonable range
+    }
+
+    FrameProfiler::Scope input("Text editor: input");
+    // Handle keyboard input
+    if (ImGui::IsWindowFocused() && !ImGui::IsAnyItemActive()) {
+        // Ctrl+C/V/X/Z/Y
+        if (io.KeyCtrl) {
+            if (ImGui::IsKeyPressed(ImGuiKey_C)) {
+                if (has_selection_) {
+                    ImGui::SetClipboardText(GetSelectedText().c_str());
+                }
+            }
+            if (ImGui::IsKeyPressed(ImGuiKey_V)) {
+                if (const char* cb = ImGui::GetClipboardText()) {
+                    RecordInput(InputEvent::Kind::Paste, 0, cb);
+                    PasteText(cb);
+                }
+            }
+            if (ImGui::IsKeyPressed(ImGuiKey_X)) {
+                if (has_selection_) {
+                    ImGui::SetClipboardText(GetSelectedText().c_str());
+                    DeleteSelectedText();
+                }
+            }
+            if (ImGui::IsKeyPressed(ImGuiKey_Z)) {
+                Undo();
+            }
+            if (ImGui::IsKeyPressed(ImGuiKey_Y)) {
+                Redo();
+            }
+            if (ImGui::IsKeyPressed(ImGuiKey_A)) {
+                selection_start_ = { 0, 0 };
+                cursor_ = { static_cast<int>(lines_.size() - 1), static_cast<int>(lines_.View(lines_.size() - 1).length()) };
+                has_selection_ = true;
+            }
+        }
+
+        // Navigation
+        if (ImGui::IsKeyPressed(ImGuiKey_LeftArrow)) {
+            if (io.KeyShift && !has_selection_) {
+                SetSelection(cursor_);
+            }
+            MoveCursorLeft();
+            if (!io.KeyShift) {
+                ClearSelection();
+            }
+        }
+        if (ImGui::IsKeyPressed(ImGuiKey_RightArrow)) {
+            if (io.KeyShift && !has_selection_) {
+                SetSelection(cursor_);
+            }
+            MoveCursorRight();
+            if (!io.KeyShift) {
+                ClearSelection();
+            }
+        }
+        if (ImGui::IsKeyPressed(ImGuiKey_UpArrow)) {
+            if (io.KeyShift && !has_selection_) {
+                SetSelection(cursor_);
+            }
+            MoveCursorUp();
+            if (!io.KeyShift) {
+                ClearSelection();
+            }
+        }
+        if (ImGui::IsKeyPressed(ImGuiKey_DownArrow)) {
+            if (io.KeyShift && !has_selection_) {
+                SetSelection(cursor_);
+            }
+            MoveCursorDown();
+            if (!io.KeyShift) {
+                ClearSelection();
+            }
+        }
+
+        // Home/End
+        if (ImGui::IsKeyPressed(ImGuiKey_Home)) {
+            if (io.KeyShift && !has_selection_) {
+                SetSelection(cursor_);
+            }
+            cursor_.column = 0;
+            if (!io.KeyShift) {
+                ClearSelection();
+            }
+        }
+        if (ImGui::IsKeyPressed(ImGuiKey_End)) {
+            if (io.KeyShift && !has_selection_) {
+                SetSelection(cursor_);
+            }
+            cursor_.column = lines_.View(cursor_.line).length();
+            if (!io.KeyShift) {
+                ClearSelection();
+            }
+        }
+
+        // Editing
+        if (ImGui::IsKeyPressed(ImGuiKey_Tab)) {
+            // If you want a single undo‐step for the whole tab:
+            SaveUndo();
+            InsertTextAtCursor("    ");
+        }
+        if (ImGui::IsKeyPressed(ImGuiKey_Enter)) {
+            RecordInput(InputEvent::Kind::Enter);
+            InsertNewLine();
+        }
+        if (ImGui::IsKeyPressed(ImGuiKey_Backspace)) {
+            RecordInput(InputEvent::Kind::Backspace);
+            DeleteChar();
+        }
+        if (ImGui::IsKeyPressed(ImGuiKey_Delete)) {
+            if (has_selection_) {
+                DeleteSelectedText();
+            }
+            else if (cursor_.column < static_cast<int>(lines_.View(cursor_.line).length())) {
+                SaveUndo();
+                const size_t next = Utf8NextBoundary(lines_.View(cursor_.line), cursor_.column);
+                lines_[cursor_.line].erase(cursor_.column, next - cursor_.column);
+                UpdateContentFromLines(cursor_.line, cursor_.line);
+            }
+            else if (cursor_.line < static_cast<int>(lines_.size()) - 1) {
+                SaveUndo();
+                auto& line = lines_[cursor_.line];
+                line += lines_.View(cursor_.line + 1);
+                lines_.erase(cursor_.line + 1);
+                UpdateContentFromLines(cursor_.line, lines_.size() - 1);
+            }
+        }
+
+        // Text input: everything typed this frame (key repeat, fast typing,
+        // IME commits) goes in as one edit with one highlight request.
+        if (io.InputQueueCharacters.Size > 0) {
+            std::string typed;
+            for (int n = 0; n < io.InputQueueCharacters.Size; n++) {
+                auto c = io.InputQueueCharacters[n];
+                if (c != 0 && c != '\n' && c != '\r') {
+                    char utf8[4];
+                    typed.append(utf8, Utf8Encode(c, utf8));
+                }
+            }
+            if (!typed.empty()) {
+                RecordInput(InputEvent::Kind::Type, 0, typed);
+                InsertTyped(typed);
+            }
+            io.InputQueueCharacters.resize(0);
+        }
+    }
+
+    // Handle mouse input
+    if (ImGui::IsWindowHovered()) {
+        if (ImGui::IsMouseClicked(0)) {
+            // 1) Update click count based on timing
+            double now = ImGui::GetTime();
+            if (now - lastClickTime_ < ImGui::GetIO().MouseDoubleClickTime) {
+                clickCount_ = std::min(clickCount_ + 1, 3);
+            }
+            else {
+                clickCount_ = 1;
+            }
+            lastClickTime_ = now;
+
+            // 2) Figure out which line/column was clicked
+            ImVec2 mouse_pos = ImGui::GetMousePos();
+            ImVec2 window_pos = ImGui::GetWindowPos();
+            float  line_h = ImGui::GetTextLineHeightWithSpacing();
+            int    clickedLine = static_cast<int>((mouse_pos.y - window_pos.y + ImGui::GetScrollY()) / line_h);
+            clickedLine = std::clamp(clickedLine, 0, (int)lines_.size() - 1);
+
+            float x_offset = mouse_pos.x - window_pos.x - gutterWidth;
+            int   clickedCol = ColumnFromX(lines_.View(clickedLine), x_offset + ImGui::GetScrollX());
+
+            // 3) Dispatch based on clickCount_
+            if (clickCount_ == 2) {
+                // double-click → select word
+                cursor_ = { clickedLine, clickedCol };
+                SelectWordAt(cursor_);
+            }
+            else if (clickCount_ >= 3) {
+                // triple-click → select entire line
+                SelectLineAt(clickedLine);
+            }
+            else {
+                // single-click → move cursor & start/cancel selection
+                cursor_ = { clickedLine, clickedCol };
+                if (ImGui::GetIO().KeyShift) {
+                    if (!has_selection_) SetSelection(cursor_);
+                }
+                else {
+                    ClearSelection();
+                }
+                is_selecting_with_mouse_ = true;
+            }
+        }
+
+        if (ImGui::IsMouseDragging(0) && is_selecting_with_mouse_) {
+            if (!has_selection_) {
+                SetSelection(cursor_);
+            }
+
+            ImVec2 mouse_pos = ImGui::GetMousePos();
+            ImVec2 window_pos = ImGui::GetWindowPos();
+            float line_height = ImGui::GetTextLineHeightWithSpacing();
+
+            // Corrected: subtract scroll Y
+            int clicked_line = static_cast<int>((mouse_pos.y - window_pos.y + ImGui::GetScrollY()) / line_height);
+            clicked_line = std::clamp(clicked_line, 0, static_cast<int>(lines_.size()) - 1);
+
+            float x_offset = mouse_pos.x - window_pos.x - gutterWidth;
+            int column = 0;
+            if (clicked_line < static_cast<int>(lines_.size()))
+                column = ColumnFromX(lines_.View(clicked_line), x_offset + ImGui::GetScrollX());
+
+            cursor_ = { clicked_line, column };
+        }
+
+        if (ImGui::IsMouseClicked(ImGuiMouseButton_Right)) {
+            ImVec2 mouse_pos = ImGui::GetMousePos();
+            ImVec2 window_pos = ImGui::GetWindowPos();
+            float line_h = ImGui::GetTextLineHeightWithSpacing();
+            int clicked_line = static_cast<int>((mouse_pos.y - window_pos.y + ImGui::GetScrollY()) / line_h);
+            clicked_line = std::clamp(clicked_line, 0, (int)lines_.size() - 1);
+
+            float x_offset = mouse_pos.x - window_pos.x - gutterWidth;
+            int clicked_col = ColumnFromX(lines_.View(clicked_line), x_offset + ImGui::GetScrollX());
+
+            // If no selection, move cursor to click location
+            if (!has_selection_) {
+                cursor_ = { clicked_line, clicked_col };
+                ClearSelection();
+            }
+
+            // Open context menu popup
+            ImGui::OpenPopup("TextEditorContextMenu");
+        }
+
+        if (ImGui::IsMouseReleased(0)) {
+            is_selecting_with_mouse_ = false;
+        }
+    }
+
+    if (ImGui::BeginPopup("TextEditorContextMenu")) {
+        if (has_selection_) {
+            if (ImGui::MenuItem("Copy", "Ctrl+C")) {
+                ImGui::SetClipboardText(GetSelectedText().c_str());
+            }
+
+            if (ImGui::MenuItem("Paste", "Ctrl+V")) {
+                if (const char* cb = ImGui::GetClipboardText()) {
+                    RecordInput(InputEvent::Kind::Paste, 0, cb);
+                    PasteText(cb);
+                }
+            }
+
+            if (ImGui::MenuItem("Cut", "Ctrl+X")) {
+                ImGui::SetClipboardText(GetSelectedText().c_str());
+                DeleteSelectedText();
+            }
+        }
+        else {
+            if (ImGui::MenuItem("Copy Line")) {
+                ImGui::SetClipboardText(std::string(lines_.View(cursor_.line)).c_str());
+            }
+
+            if (ImGui::MenuItem("Paste", "Ctrl+V")) {
+                if (const char* cb = ImGui::GetClipboardText()) {
+                    RecordInput(InputEvent::Kind::Paste, 0, cb);
+                    PasteText(cb);
+                }
+            }
+
+            if (ImGui::MenuItem("Cut Line")) {
+                SaveUndo();
+                ImGui::SetClipboardText(std::string(lines_.View(cursor_.line)).c_str());
+                lines_.erase(cursor_.line);
+                if (lines_.empty()) lines_.push_back("");
+                cursor_.line = std::min(cursor_.line, (int)lines_.size() - 1);
+                cursor_.column = std::min(cursor_.column, (int)lines_.View(cursor_.line).size());
+                UpdateContentFromLines();
+            }
+
+            ImGui::Separator();
+
+            if (ImGui::MenuItem("Undo", "Ctrl+Z", false, !undo_stack_.empty())) {
+                Undo();
+            }
+
+            if (ImGui::MenuItem("Redo", "Ctrl+Y", false, !redo_stack_.empty())) {
+                Redo();
+            }
+
+            ImGui::Separator();
+
+            if (ImGui::MenuItem("Select All", "Ctrl+A")) {
+                selection_start_ = { 0, 0 };
+                cursor_ = { static_cast<int>(lines_.size() - 1), static_cast<int>(lines_.View(lines_.size() - 1).length()) };
+                has_selection_ = true;
+            }
+        }
+
+        ImGui::EndPopup();
+    }
+    input.end();
+
+    FrameProfiler::Scope visible("Text editor: lines");
+    if (scrollToCursor_) {
+        // Vertical scroll only if cursor is off-screen
+        if (cursor_.line < visible_line_start_ ||
+            cursor_.line >= visible_line_start_ + visible_line_count_)
+        {
+            float lineH = ImGui::GetTextLineHeightWithSpacing();
+            // center cursor line in view
+            float targetY = cursor_.line * lineH - (visible_line_count_ / 2) * lineH;
+            ImGui::SetScrollY(std::max(0.0f, targetY));
+        }
+
+        // Horizontal scroll only if cursor column is off-screen
+        float scrollX = ImGui::GetScrollX();
+        float availW = ImGui::GetContentRegionAvail().x;
+        // measure the width of all text up to the cursor
+        std::string_view line = lines_.View(cursor_.line);
+        std::string  before = SafeSubstr(line, 0, cursor_.column);
+        float cursorPx = ImGui::CalcTextSize(before.c_str()).x;
+
+        // if the cursor is left of scroll or right of visible area, recenter it
+        if (cursorPx < scrollX || cursorPx > scrollX + availW) {
+            float targetX = cursorPx - (availW * 0.5f);
+            ImGui::SetScrollX(std::max(0.0f, targetX));
+        }
+        scrollToCursor_ = false;
+    }
+
+    ImVec2 window_pos = ImGui::GetWindowPos();
+    float window_width = ImGui::GetWindowWidth();
+
+    int end_line = std::min(visible_line_start_ + visible_line_count_,
+        static_cast<int>(lines_.size()));
+
+    if (visible_line_start_ > 0) {
+        float skip_height = visible_line_start_ * ImGui::GetTextLineHeightWithSpacing();
+        ImGui::SetCursorPosY(ImGui::GetCursorPosY() + skip_height);
+    }
+
+    // Semantic tokens of the visible lines only; merged into the syntax
+    // tokens below by column.
+    SemanticLines visible_sem(std::max(0, end_line - visible_line_start_));
+    {
+        std::lock_guard<std::mutex> lock(semantic_mutex_);
+        for (int l = visible_line_start_; l < end_line && l < static_cast<int>(sem_lines_.size()); ++l)
+            visible_sem[l - visible_line_start_] = sem_lines_[l];
+    }
+
+    for (int lineNo = visible_line_start_; lineNo < end_line; ++lineNo) {
+        char buf[32];
+        sprintf(buf, "%4d | ", lineNo + 1);
+        ImGui::TextUnformatted(buf);
+        ImGui::SameLine(0, 0);
+        float line_height = ImGui::GetTextLineHeightWithSpacing();
+        ImVec2 text_start = ImGui::GetCursorScreenPos();
+
+        if (!find_results_.empty()) {
+            // Highlight matched lines and matches
+            for (const auto& match : find_results_) {
+                if (match.line == lineNo) {
+                    // Highlight the entire line (dim background)
+                    ImVec2 highlight_start = ImVec2(window_pos.x, text_start.y);
+                    ImVec2 highlight_end = ImVec2(window_pos.x + window_width, text_start.y + line_height);
+                    ImGui::GetWindowDrawList()->AddRectFilled(highlight_start, highlight_end, IM_COL32(60, 80, 20, 60));
+
+                    // Highlight the matched substring (stronger highlight)
+                    int match_col = match.column;
+                    std::string match_text = SafeSubstr(lines_.View(lineNo), match_col, find_query_.length());
+
+                    ImVec2 match_start = text_start;
+                    match_start.x += ImGui::CalcTextSize(SafeSubstr(lines_.View(lineNo), 0, match_col).c_str()).x;
+
+                    ImVec2 match_end = match_start;
+                    match_end.x += ImGui::CalcTextSize(match_text.c_str()).x;
+                    match_end.y += line_height;
+
+                    ImGui::GetWindowDrawList()->AddRectFilled(match_start, match_end, IM_COL32(200, 200, 0, 100));
+                }
+            }
+        }
+
+        std::string_view line = lines_.View(lineNo);
+
+        bool is_cursor_line = (cursor_.line == lineNo);
+        if (is_cursor_line) {
+            ImVec2 highlight_start = ImVec2(window_pos.x, text_start.y);
+            ImVec2 highlight_end = ImVec2(window_pos.x + window_width, text_start.y + line_height);
+            ImGui::GetWindowDrawList()->AddRectFilled(highlight_start, highlight_end,
+                IM_COL32(60, 60, 120, 60));
+        }
+
+        static float blink_timer = 0.0f;
+        static bool blink_on = true;
+
+        blink_timer += io.DeltaTime;
+        if (blink_timer >= 15) {
+            blink_timer = 0.0f;
+            blink_on = !blink_on;
+        }
+
+        if (is_cursor_line && blink_on && ImGui::IsWindowFocused()) {
+            float x = text_start.x + ImGui::CalcTextSize(SafeSubstr(line, 0, cursor_.column).c_str()).x;
+            float y = text_start.y;
+            ImGui::GetWindowDrawList()->AddLine(
+                ImVec2(x, y), ImVec2(x, y + line_height),
+                IM_COL32(255, 255, 255, 255), 1.5f
+            );
+        }
+
+        if (has_selection_) {
+            CursorPosition sel_start = std::min(cursor_, selection_start_);
+            CursorPosition sel_end = std::max(cursor_, selection_start_);
+
+            if (lineNo >= sel_start.line && lineNo <= sel_end.line) {
+                int begin_col = (lineNo == sel_start.line) ? sel_start.column : 0;
+                int end_col = (lineNo == sel_end.line) ? sel_end.column : static_cast<int>(line.size());
+
+                if (begin_col < end_col) {
+                    std::string segment = SafeSubstr(line, begin_col, end_col - begin_col);
+
+                    ImVec2 sel_start_pos = text_start;
+                    sel_start_pos.x += ImGui::CalcTextSize(SafeSubstr(line, 0, begin_col).c_str()).x;
+
+                    ImVec2 sel_end_pos = sel_start_pos;
+                    sel_end_pos.x += ImGui::CalcTextSize(segment.c_str()).x;
+                    sel_end_pos.y += line_height;
+
+                    ImGui::GetWindowDrawList()->AddRectFilled(sel_start_pos, sel_end_pos,
+                        IM_COL32(100, 100, 255, 80));
+                }
+            }
+        }
+
+        auto lineTokens = GetVisibleTokensForLine(lineNo);
+        const auto& line_sem = visible_sem[lineNo - visible_line_start_];
+        auto sem_it = line_sem.begin();
+
+        int col = 0;
+        for (const auto& tok : lineTokens) {
+            if (tok.column < col) continue;
+
+            if (tok.column > col) {
+                std::string text = SafeSubstr(line, col, tok.column - col);
+                ImGui::TextUnformatted(text.c_str());
+                ImGui::SameLine(0, 0);
+            }
+
+            ImVec4 color = tok.color;
+            while (sem_it != line_sem.end() && sem_it->column < tok.column)
+                ++sem_it;
+            if (sem_it != line_sem.end() && sem_it->column == tok.column && sem_it->length == tok.length)
+                color = GetSemanticColor(sem_it->kind);
+
+            int tok_end = tok.column + tok.length;
+            if (tok_end > visible_column_start_ && tok.column < visible_column_start_ + visible_column_width_) {
+                ImGui::PushStyleColor(ImGuiCol_Text, color);
+                ImGui::TextUnformatted(SafeSubstr(line, tok.column, tok.length).c_str());
+                ImGui::PopStyleColor();
+                ImGui::SameLine(0, 0);
+            }
+
+            col = tok_end;
+        }
+
+        if (col < static_cast<int>(line.size())) {
+            ImGui::TextUnformatted(SafeSubstr(line, col).c_str());
+            ImGui::SameLine(0, 0);
+        }
+
+        ImGui::NewLine();
+    }
+
+    int remaining_lines = static_cast<int>(lines_.size()) - end_line;
+    if (remaining_lines > 0) {
+        float skip_height = remaining_lines * ImGui::GetTextLineHeightWithSpacing();
+        ImGui::SetCursorPosY(ImGui::GetCursorPosY() + skip_height);
+    }
+    ImGui::SetWindowFontScale(1.0f);
+    ImGui::EndChild();
+    visible.end();
+
+    FrameProfiler::Scope minimap("Text editor: minimap");
+    ImGui::SameLine();
+    ImGui::BeginChild("Minimap", ImVec2(minimapW, 0), false,
+        ImGuiWindowFlags_NoScrollbar | ImGuiWindowFlags_NoScrollWithMouse);
+    DrawMinimap();
+    
+    ImGui::EndChild();
+}
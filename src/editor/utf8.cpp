@@ -0,0 +1,187 @@
+#include "utf8.h"
+
+#include <algorithm>
+#include <bit>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define MUT_HAS_SSE2 1
+#endif
+
+/*──────────────────────────────────────────────────────────*/
+/*                       validation                         */
+bool Utf8Validate(std::string_view text, size_t* error_offset)
+{
+    const auto*  p = reinterpret_cast<const unsigned char*>(text.data());
+    const size_t n = text.size();
+    size_t       i = 0;
+
+    auto fail = [&](size_t at) {
+        if (error_offset) *error_offset = at;
+        return false;
+    };
+
+    while (i < n) {
+#ifdef MUT_HAS_SSE2
+        // Source code is overwhelmingly ASCII: a chunk with no high bit set
+        // needs no further look.
+        while (i + 16 <= n) {
+            __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p + i));
+            unsigned mask = static_cast<unsigned>(_mm_movemask_epi8(chunk));
+            if (mask) {
+                i += std::countr_zero(mask);
+                break;
+            }
+            i += 16;
+        }
+        if (i >= n) break;
+#endif
+        const unsigned char c = p[i];
+        if (c < 0x80) {
+            ++i;
+            continue;
+        }
+
+        size_t   len;
+        uint32_t cp, min;
+        if      ((c & 0xE0) == 0xC0) { len = 2; cp = c & 0x1F; min = 0x80; }
+        else if ((c & 0xF0) == 0xE0) { len = 3; cp = c & 0x0F; min = 0x800; }
+        else if ((c & 0xF8) == 0xF0) { len = 4; cp = c & 0x07; min = 0x10000; }
+        else return fail(i);
+
+        if (i + len > n) return fail(i);
+        for (size_t k = 1; k < len; ++k) {
+            if ((p[i + k] & 0xC0) != 0x80) return fail(i);
+            cp = (cp << 6) | (p[i + k] & 0x3F);
+        }
+        if (cp < min || cp > 0x10FFFF || (cp >= 0xD800 && cp <= 0xDFFF))
+            return fail(i);
+
+        i += len;
+    }
+    return true;
+}
+
+bool Utf8IsAscii(std::string_view text)
+{
+    const char* p = text.data();
+    size_t      n = text.size();
+    size_t      i = 0;
+
+#ifdef MUT_HAS_SSE2
+    __m128i acc = _mm_setzero_si128();
+    for (; i + 16 <= n; i += 16)
+        acc = _mm_or_si128(acc, _mm_loadu_si128(reinterpret_cast<const __m128i*>(p + i)));
+    if (_mm_movemask_epi8(acc)) return false;
+#endif
+
+    for (; i < n; ++i)
+        if (static_cast<unsigned char>(p[i]) >= 0x80) return false;
+    return true;
+}
+
+size_t Utf8CountCodepoints(std::string_view text)
+{
+    const char* p = text.data();
+    size_t      n = text.size();
+    size_t      i = 0;
+    size_t      count = 0;
+
+#ifdef MUT_HAS_SSE2
+    // Continuation bytes are 0x80..0xBF, i.e. -128..-65 as signed bytes;
+    // everything greater starts a code point.
+    const __m128i limit = _mm_set1_epi8(-65);
+    for (; i + 16 <= n; i += 16) {
+        __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p + i));
+        unsigned mask = static_cast<unsigned>(_mm_movemask_epi8(_mm_cmpgt_epi8(chunk, limit)));
+        count += std::popcount(mask);
+    }
+#endif
+
+    for (; i < n; ++i)
+        if (!Utf8IsContinuation(p[i])) ++count;
+    return count;
+}
+
+/*──────────────────────────────────────────────────────────*/
+/*                  boundaries & mapping                    */
+size_t Utf8NextBoundary(std::string_view text, size_t byte)
+{
+    if (byte >= text.size()) return text.size();
+    size_t i = byte + 1;
+    while (i < text.size() && i - byte < 4 && Utf8IsContinuation(text[i]))
+        ++i;
+    return i;
+}
+
+size_t Utf8PrevBoundary(std::string_view text, size_t byte)
+{
+    if (byte == 0) return 0;
+    if (byte > text.size()) return text.size();
+    size_t i = byte - 1;
+    while (i > 0 && byte - i < 4 && Utf8IsContinuation(text[i]))
+        --i;
+    return i;
+}
+
+size_t Utf8ByteToCodepoint(std::string_view text, size_t byte)
+{
+    return Utf8CountCodepoints(text.substr(0, std::min(byte, text.size())));
+}
+
+size_t Utf8CodepointToByte(std::string_view text, size_t codepoint)
+{
+    size_t byte = 0;
+    while (codepoint > 0 && byte < text.size()) {
+        byte = Utf8NextBoundary(text, byte);
+        --codepoint;
+    }
+    return byte;
+}
+
+int Utf8Encode(uint32_t cp, char out[4])
+{
+    if (cp > 0x10FFFF || (cp >= 0xD800 && cp <= 0xDFFF))
+        cp = 0xFFFD;
+
+    if (cp < 0x80) {
+        out[0] = static_cast<char>(cp);
+        return 1;
+    }
+    if (cp < 0x800) {
+        out[0] = static_cast<char>(0xC0 | (cp >> 6));
+        out[1] = static_cast<char>(0x80 | (cp & 0x3F));
+        return 2;
+    }
+    if (cp < 0x10000) {
+        out[0] = static_cast<char>(0xE0 | (cp >> 12));
+        out[1] = static_cast<char>(0x80 | ((cp >> 6) & 0x3F));
+        out[2] = static_cast<char>(0x80 | (cp & 0x3F));
+        return 3;
+    }
+    out[0] = static_cast<char>(0xF0 | (cp >> 18));
+    out[1] = static_cast<char>(0x80 | ((cp >> 12) & 0x3F));
+    out[2] = static_cast<char>(0x80 | ((cp >> 6) & 0x3F));
+    out[3] = static_cast<char>(0x80 | (cp & 0x3F));
+    return 4;
+}
+
+uint32_t Utf8Decode(std::string_view text, size_t byte)
+{
+    if (byte >= text.size()) return 0xFFFD;
+    const size_t   end = Utf8NextBoundary(text, byte);
+    const uint32_t lead = static_cast<unsigned char>(text[byte]);
+    const size_t   len = end - byte;
+
+    if (lead < 0x80) return lead;
+    uint32_t cp;
+    size_t   want;
+    if ((lead & 0xE0) == 0xC0)      { cp = lead & 0x1F; want = 2; }
+    else if ((lead & 0xF0) == 0xE0) { cp = lead & 0x0F; want = 3; }
+    else if ((lead & 0xF8) == 0xF0) { cp = lead & 0x07; want = 4; }
+    else return 0xFFFD;
+    if (len != want) return 0xFFFD;
+    for (size_t i = 1; i < len; ++i)
+        cp = (cp << 6) | (static_cast<unsigned char>(text[byte + i]) & 0x3F);
+    return cp;
+}
@@ -0,0 +1,50 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+/*---------------------------------------------------------------------------
+    UTF-8 helpers for the editor.
+
+    Columns stay byte offsets throughout the editor (tokens, cursor, libclang
+    locations); these helpers keep cursor movement, deletion and hit-testing
+    on code point boundaries and map between byte offsets and display
+    columns (one column per code point).
+
+    Invalid input never fails here: a byte that does not start a valid
+    sequence is treated as a single code point, which is also how ImGui
+    renders it (as U+FFFD).
+---------------------------------------------------------------------------*/
+
+/// Validate `text` as UTF-8 (no overlongs, surrogates or values past
+/// U+10FFFF).  ASCII runs are skipped 16 bytes at a time with SSE2.
+/// On failure `error_offset` (if given) receives the offending byte offset.
+bool Utf8Validate(std::string_view text, size_t* error_offset = nullptr);
+
+/// True if every byte is < 0x80.
+bool Utf8IsAscii(std::string_view text);
+
+/// Number of code points (non-continuation bytes) in `text`.
+size_t Utf8CountCodepoints(std::string_view text);
+
+/// Byte offset of the next / previous code point boundary.  Both clamp to
+/// [0, text.size()].
+size_t Utf8NextBoundary(std::string_view text, size_t byte);
+size_t Utf8PrevBoundary(std::string_view text, size_t byte);
+
+/// Byte offset <-> code point index within one line.
+size_t Utf8ByteToCodepoint(std::string_view text, size_t byte);
+size_t Utf8CodepointToByte(std::string_view text, size_t codepoint);
+
+/// Encode `codepoint` into `out`; returns the byte count (1-4).  Invalid
+/// code points are encoded as U+FFFD.
+int Utf8Encode(uint32_t codepoint, char out[4]);
+
+/// Code point starting at `byte` (which should be a boundary).  A sequence
+/// that is truncated or does not start there decodes as U+FFFD.
+uint32_t Utf8Decode(std::string_view text, size_t byte);
+
+inline bool Utf8IsContinuation(char c)
+{
+    return (static_cast<unsigned char>(c) & 0xC0) == 0x80;
+}
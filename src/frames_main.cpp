@@ -0,0 +1,355 @@
+// frames_main.cpp
+//
+// mut_frames: runs the whole GUI (GuiLayer::render()) on the null backend –
+// no window, no GPU – and reports frame-time distributions per scripted
+// scenario and per panel, plus draw list / draw call / vertex counts.
+//
+//   mut_frames [--frames N] [--size WxH] [--file source.cpp] [--lines N]
+//              [--scenario NAME] [--out frames.json]
+//
+// Scenarios, in run order (the GUI's panels are process-wide, so later
+// scenarios see the state earlier ones left behind):
+//   file_tree       expand a generated folder tree and scroll through it
+//   filter_symbols  type and erase queries in a populated Symbols panel
+//   scroll_file     open a large C++ file and wheel-scroll the editor
+//
+// Inputs are generated (or --file), ImGuiIO gets a fixed size and frame
+// delta and no .ini file is read, so runs lay out identically everywhere.
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <map>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <imgui.h>
+#include <imgui_internal.h>
+
+#include "editor/clang_indexer.h"
+#include "editor/editor_window.h"
+#include "editor/text_editor.h"
+#include "gui/filemanager_panel.h"
+#include "gui/frame_profiler.h"
+#include "gui/gui_layer.h"
+#include "gui/symbols_panel.h"
+#include "platform/null_backend.h"
+#include "platform/trace.h"
+
+namespace fs = std::filesystem;
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+double msSince(Clock::time_point start)
+{
+    return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+}
+
+/*──────────────────────── inputs ────────────────────────*/
+
+std::string generateSource(size_t lines)
+{
+    std::string out = "#include <vector>\n\n";
+    for (size_t i = 0; out.size() < lines * 40 || i < lines / 8; ++i) {
+        out += "// block " + std::to_string(i) + "\n";
+        out += "int compute" + std::to_string(i) + "(const std::vector<int>& v, int limit)\n{\n";
+        out += "    int total = 0; /* running sum */\n";
+        out += "    for (int k = 0; k < limit; ++k) total += v[k] * " + std::to_string(i % 97) + ";\n";
+        out += "    return total > 0x" + std::to_string(i % 4096) + " ? total : -1;\n}\n\n";
+    }
+    return out;
+}
+
+// dirs x subdirs x files, named so the sort order is stable.
+void generateTree(const fs::path& root, int dirs, int subdirs, int files)
+{
+    char name[64];
+    for (int d = 0; d < dirs; ++d) {
+        std::snprintf(name, sizeof name, "module_%03d", d);
+        const fs::path dir = root / name;
+        for (int s = 0; s < subdirs; ++s) {
+            std::snprintf(name, sizeof name, "part_%03d", s);
+            const fs::path sub = dir / name;
+            fs::create_directories(sub);
+            for (int f = 0; f < files; ++f) {
+                std::snprintf(name, sizeof name, "file_%03d.cpp", f);
+                std::ofstream(sub / name) << "// " << f << "\n";
+            }
+        }
+    }
+}
+
+SymbolList generateSymbols(size_t count)
+{
+    static const SymbolKind kKinds[] = { SymbolKind::Function, SymbolKind::Variable, SymbolKind::Field, SymbolKind::Method, SymbolKind::Class };
+    static const char* const kWords[] = { "widget", "buffer", "node", "cache", "index", "layout", "render", "parse" };
+    SymbolList out;
+    out.symbols.reserve(count);
+    for (size_t i = 0; i < count; ++i) {
+        std::string name = std::string(kWords[i % 8]) + "_" + kWords[(i / 8) % 8] + std::to_string(i);
+        out.symbols.push_back({ out.Intern(name), {}, static_cast<int>(i + 1), 1, kKinds[i % 5], true });
+    }
+    return out;
+}
+
+/*──────────────────────── frame loop ────────────────────────*/
+
+struct FrameSample {
+    double                     ms = 0;
+    NullBackend::DrawCounts    counts;
+    std::map<std::string, double> panels;
+};
+
+struct Scenario {
+    const char*                      name;
+    std::function<void(GuiLayer&)>   setup;
+    std::function<void(GuiLayer&, int frame)> step;   // before each measured frame
+};
+
+class FrameRunner {
+public:
+    FrameRunner(GuiLayer& gui, NullBackend& backend) : gui_(gui), backend_(backend) {}
+
+    // `inFrame` runs between NewFrame() and render(), for window focus etc.
+    FrameSample frame(const std::function<void()>& inFrame = {})
+    {
+        FrameSample s;
+        const auto start = Clock::now();
+        FrameProfiler& prof = FrameProfiler::instance();
+        prof.beginFrame();
+        backend_.newFrame();
+        ImGui::NewFrame();
+        if (inFrame) inFrame();
+        gui_.render();
+        ImGui::Render();
+        prof.endFrame(ImGui::GetDrawData());
+        s.counts = backend_.render(ImGui::GetDrawData());
+        s.ms = msSince(start);
+        for (const auto& t : prof.lastFrame())   // panels and editor draw phases
+            s.panels[t.name] += t.ms;
+        return s;
+    }
+
+private:
+    GuiLayer&    gui_;
+    NullBackend& backend_;
+};
+
+// Centre of a top-level panel window, once it has been laid out.
+ImVec2 windowCenter(const char* name)
+{
+    if (ImGuiWindow* w = ImGui::FindWindowByName(name))
+        return ImVec2(w->Pos.x + w->Size.x * 0.5f, w->Pos.y + w->Size.y * 0.5f);
+    return ImVec2(0, 0);
+}
+
+void scrollOver(const char* window, float wheel)
+{
+    ImGuiIO& io = ImGui::GetIO();
+    const ImVec2 at = windowCenter(window);
+    io.AddMousePosEvent(at.x, at.y);
+    io.AddMouseWheelEvent(0.0f, wheel);
+}
+
+/*──────────────────────── report ────────────────────────*/
+
+struct Stats {
+    double p50 = 0, p90 = 0, p99 = 0, max = 0, mean = 0;
+};
+
+Stats stats(std::vector<double> v)
+{
+    Stats s;
+    if (v.empty()) return s;
+    std::sort(v.begin(), v.end());
+    auto at = [&](double p) { return v[std::min(v.size() - 1, static_cast<size_t>(std::ceil(p * v.size())) - 1)]; };
+    s.p50 = at(0.50);
+    s.p90 = at(0.90);
+    s.p99 = at(0.99);
+    s.max = v.back();
+    for (double x : v) s.mean += x;
+    s.mean /= static_cast<double>(v.size());
+    return s;
+}
+
+std::string statsJson(const Stats& s)
+{
+    char buf[192];
+    std::snprintf(buf, sizeof buf, "{\"p50\": %.4f, \"p90\": %.4f, \"p99\": %.4f, \"max\": %.4f, \"mean\": %.4f}",
+        s.p50, s.p90, s.p99, s.max, s.mean);
+    return buf;
+}
+
+std::string report(const char* name, const std::vector<FrameSample>& samples)
+{
+    std::vector<double> total;
+    std::map<std::string, std::vector<double>> panels;
+    NullBackend::DrawCounts sum;
+    for (const auto& s : samples) {
+        total.push_back(s.ms);
+        for (const auto& [panel, ms] : s.panels) panels[panel].push_back(ms);
+        sum.drawLists += s.counts.drawLists;
+        sum.drawCalls += s.counts.drawCalls;
+        sum.vertices += s.counts.vertices;
+        sum.indices += s.counts.indices;
+    }
+    const size_t n = std::max<size_t>(1, samples.size());
+    const Stats frame = stats(total);
+
+    std::fprintf(stderr, "\n%s (%zu frames)\n", name, samples.size());
+    std::fprintf(stderr, "  %-22s p50 %8.3f  p90 %8.3f  p99 %8.3f  max %8.3f ms\n", "frame", frame.p50, frame.p90, frame.p99, frame.max);
+    for (const auto& [panel, v] : panels) {
+        const Stats p = stats(v);
+        std::fprintf(stderr, "  %-22s p50 %8.3f  p90 %8.3f  p99 %8.3f  max %8.3f ms\n", panel.c_str(), p.p50, p.p90, p.p99, p.max);
+    }
+    std::fprintf(stderr, "  per frame: %zu draw lists, %zu draw calls, %zu vertices, %zu indices\n",
+        sum.drawLists / n, sum.drawCalls / n, sum.vertices / n, sum.indices / n);
+
+    char buf[256];
+    std::string out = "    {\"name\": \"" + std::string(name) + "\", \"frames\": " + std::to_string(samples.size())
+        + ", \"frame_ms\": " + statsJson(frame) + ",\n     \"panels_ms\": {";
+    bool first = true;
+    for (const auto& [panel, v] : panels) {
+        out += (first ? "\"" : ", \"") + panel + "\": " + statsJson(stats(v));
+        first = false;
+    }
+    std::snprintf(buf, sizeof buf,
+        "},\n     \"per_frame\": {\"draw_lists\": %zu, \"draw_calls\": %zu, \"vertices\": %zu, \"indices\": %zu}}",
+        sum.drawLists / n, sum.drawCalls / n, sum.vertices / n, sum.indices / n);
+    return out + buf;
+}
+
+int usage()
+{
+    std::fprintf(stderr, "usage: mut_frames [--frames N] [--size WxH] [--file source.cpp] [--lines N] [--scenario NAME] [--out frames.json]\n");
+    return 2;
+}
+
+} // namespace
+
+int main(int argc, char** argv)
+{
+    trace::setThreadName("main");
+    trace::setLevel(trace::Level::Off);
+
+    int frames = 300;
+    float width = 1600, height = 900;
+    size_t lines = 20000;
+    std::string filePath, only, outPath;
+    for (int i = 1; i < argc; ++i) {
+        const bool hasValue = i + 1 < argc;
+        if (!std::strcmp(argv[i], "--frames") && hasValue)        frames = std::max(1, std::atoi(argv[++i]));
+        else if (!std::strcmp(argv[i], "--size") && hasValue) {
+            if (std::sscanf(argv[++i], "%fx%f", &width, &height) != 2 || width < 64 || height < 64) return usage();
+        }
+        else if (!std::strcmp(argv[i], "--file") && hasValue)     filePath = argv[++i];
+        else if (!std::strcmp(argv[i], "--lines") && hasValue)    lines = std::strtoull(argv[++i], nullptr, 10);
+        else if (!std::strcmp(argv[i], "--scenario") && hasValue) only = argv[++i];
+        else if (!std::strcmp(argv[i], "--out") && hasValue)      outPath = argv[++i];
+        else return usage();
+    }
+
+    const fs::path work = fs::temp_directory_path() / "mut_frames";
+    std::error_code ec;
+    fs::remove_all(work, ec);
+    fs::create_directories(work / "tree");
+    if (filePath.empty()) {
+        filePath = (work / "large.cpp").string();
+        std::ofstream(filePath, std::ios::binary) << generateSource(lines);
+    }
+
+    GuiLayer    gui;
+    NullBackend backend;
+    gui.initHeadless();
+    backend.init(width, height);
+    FrameRunner runner(gui, backend);
+
+    const std::vector<Scenario> scenarios = {
+        { "file_tree",
+          [&](GuiLayer& g) {
+              generateTree(work / "tree", 20, 10, 20);
+              g.fileManager().setRoot(work / "tree");
+              // Expand level by level as the background listings land.
+              int idle = 0;
+              const auto deadline = Clock::now() + std::chrono::seconds(60);
+              while (idle < 10 && Clock::now() < deadline) {
+                  runner.frame();
+                  idle = g.fileManager().expandLoaded() ? 0 : idle + 1;
+                  std::this_thread::sleep_for(std::chrono::milliseconds(1));
+              }
+          },
+          [](GuiLayer&, int) { scrollOver("File Manager", -2.0f); } },
+        { "filter_symbols",
+          [&](GuiLayer& g) {
+              g.symbolsPanel().setSymbols(generateSymbols(20000).symbols);
+              // Symbols shares a dock node with Inspector: bring its tab up.
+              runner.frame([] { ImGui::SetWindowFocus("Symbols"); });
+          },
+          [](GuiLayer& g, int frame) {
+              // type "render_cache1", then erase it, one key per frame
+              static const std::string query = "render_cache1";
+              const int cycle = static_cast<int>(query.size()) * 2;
+              const int k = frame % cycle;
+              const int len = k < static_cast<int>(query.size()) ? k + 1 : cycle - k - 1;
+              g.symbolsPanel().setFilter(std::string_view(query).substr(0, len));
+          } },
+        { "scroll_file",
+          [&](GuiLayer& g) {
+              g.editorWindow().OpenFile(filePath);
+              // Start from a highlighted buffer: frames keep applying results.
+              const auto deadline = Clock::now() + std::chrono::seconds(60);
+              while (Clock::now() < deadline) {
+                  runner.frame();
+                  TextEditor* ed = g.editorWindow().ActiveEditor();
+                  if (!ed || !ed->HasPendingWork()) break;
+                  std::this_thread::sleep_for(std::chrono::milliseconds(1));
+              }
+          },
+          [](GuiLayer&, int) { scrollOver("Editor", -2.0f); } },
+    };
+
+    // One warm-up frame lays out the dock space and builds the font atlas.
+    runner.frame();
+
+    std::string json = "{\n  \"size\": [" + std::to_string(static_cast<int>(width)) + ", "
+        + std::to_string(static_cast<int>(height)) + "],\n  \"scenarios\": [\n";
+    bool first = true;
+    for (const auto& sc : scenarios) {
+        if (!only.empty() && only != sc.name) continue;
+        sc.setup(gui);
+        std::vector<FrameSample> samples;
+        samples.reserve(frames);
+        for (int f = 0; f < frames; ++f) {
+            sc.step(gui, f);
+            samples.push_back(runner.frame());
+        }
+        json += (first ? "" : ",\n") + report(sc.name, samples);
+        first = false;
+    }
+    json += "\n  ]\n}\n";
+
+    backend.shutdown();
+    gui.shutdownHeadless();
+    ClangIndexer::Cleanup();
+    fs::remove_all(work, ec);
+
+    if (outPath.empty()) {
+        std::fwrite(json.data(), 1, json.size(), stdout);
+        return 0;
+    }
+    std::ofstream out(outPath, std::ios::binary);
+    if (!(out << json)) {
+        std::fprintf(stderr, "[Frames] Cannot write '%s'\n", outPath.c_str());
+        return 1;
+    }
+    return 0;
+}
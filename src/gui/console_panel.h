@@ -1,30 +1,71 @@
 ﻿#pragma once
 #include <imgui.h>
+#include <cctype>
+#include <cstdint>
+#include <cstring>
 #include <deque>
+#include <memory>
 #include <string>
+#include <string_view>
 
+#include <platform/log_ring.h>
+
+/*---------------------------------------------------------------------------
+    ConsolePanel – scrollback for everything the IDE logs.
+
+    addLine() may be called from any thread: messages go through a lock-free
+    LogRing and are pulled into the scrollback once per frame.  Scrollback
+    text lives in 1 MiB blocks (oldest block dropped past kMaxBytes), lines
+    are offsets into it, and only the rows on screen are submitted, so
+    millions of lines cost the same per frame as ten.  The filter result is
+    kept and extended as lines arrive instead of being recomputed.
+---------------------------------------------------------------------------*/
 class ConsolePanel
 {
 public:
-    void addLine(std::string msg)          // call from your log system
+    ConsolePanel()
+    {
+        addLine("[info] Console ready.");
+        addLine("[info] Build succeeded (0.123 s).");
+    }
+
+    void addLine(std::string_view msg)     // call from your log system, any thread
     {
-        lines_.emplace_back(std::move(msg));
-        if (lines_.size() > kMaxLines) lines_.pop_front();
+        ring_.push(msg);
     }
 
     void draw(const char* title = "Console")
     {
+        ingest();   // even when hidden, so the ring never fills up
+
         if (!ImGui::Begin(title)) { ImGui::End(); return; }
 
 
-        if (ImGui::Button("Clear")) lines_.clear();
+        if (ImGui::Button("Clear")) clear();
         ImGui::SameLine();
         ImGui::Checkbox("Auto‑scroll", &autoScroll_);
+        ImGui::SameLine();
+        if (filter_.Draw("Filter", 200.0f)) refilter();
+        ImGui::SameLine();
+        if (ring_.dropped())
+            ImGui::TextDisabled("%zu lines (%llu dropped)", lines_.size(), (unsigned long long)ring_.dropped());
+        else
+            ImGui::TextDisabled("%zu lines", lines_.size());
         ImGui::Separator();
 
         ImGui::BeginChild("##scroll", ImVec2(0, 0), false,
             ImGuiWindowFlags_HorizontalScrollbar);
-        for (auto& l : lines_) ImGui::TextUnformatted(l.c_str());
+        const bool   filtering = filter_.IsActive();
+        const size_t rows = filtering ? matches_.size() : lines_.size();
+        ImGuiListClipper clipper;
+        clipper.Begin(static_cast<int>(rows));
+        while (clipper.Step()) {
+            for (int r = clipper.DisplayStart; r < clipper.DisplayEnd; ++r) {
+                std::string_view l = filtering ? lineText(matches_[r]) : lineText(firstLine_ + r);
+                ImGui::TextUnformatted(l.data(), l.data() + l.size());
+            }
+        }
+        clipper.End();
         if (autoScroll_ && ImGui::GetScrollY() >= ImGui::GetScrollMaxY())
             ImGui::SetScrollHereY(1.0f);
         ImGui::EndChild();
@@ -33,10 +74,153 @@ public:
     }
 
 private:
-    static constexpr size_t kMaxLines = 500;
-    std::deque<std::string> lines_ = {
-        "[info] Console ready.",
-        "[info] Build succeeded (0.123 s)."
+    static constexpr size_t kBlockSize = 1u << 20;
+    static constexpr size_t kMaxBytes = 256u << 20;   // ~ a few million typical lines
+
+    struct Line {
+        uint64_t offset;   // into the logical byte stream, see blocks_
+        uint32_t length;
     };
+
+    /*——— ingestion (UI thread) ———*/
+    void ingest()
+    {
+        ring_.drain([this](std::string_view msg) {
+            // one message may carry several lines
+            size_t start = 0;
+            while (start <= msg.size()) {
+                size_t nl = msg.find('\n', start);
+                if (nl == std::string_view::npos) nl = msg.size();
+                std::string_view line = msg.substr(start, nl - start);
+                if (!line.empty() && line.back() == '\r') line.remove_suffix(1);
+                if (nl < msg.size() || !line.empty() || start == 0) appendLine(line);
+                start = nl + 1;
+            }
+        });
+    }
+
+    void appendLine(std::string_view text)
+    {
+        text = text.substr(0, kBlockSize);
+        if (blocks_.empty() || blockUsed_ + text.size() > kBlockSize) {
+            blocks_.push_back(std::make_unique<char[]>(kBlockSize));
+            blockUsed_ = 0;
+            if (blocks_.size() * kBlockSize > kMaxBytes) dropOldestBlock();
+        }
+        const uint64_t offset = (firstBlock_ + blocks_.size() - 1) * kBlockSize + blockUsed_;
+        if (!text.empty()) std::memcpy(blocks_.back().get() + blockUsed_, text.data(), text.size());
+        blockUsed_ += text.size();
+
+        lines_.push_back({ offset, static_cast<uint32_t>(text.size()) });
+        const uint64_t number = firstLine_ + lines_.size() - 1;
+        if (filter_.IsActive() && passes(text))
+            matches_.push_back(number);
+    }
+
+    void dropOldestBlock()
+    {
+        blocks_.pop_front();
+        ++firstBlock_;
+        const uint64_t cut = firstBlock_ * kBlockSize;
+        while (!lines_.empty() && lines_.front().offset < cut) {
+            lines_.pop_front();
+            ++firstLine_;
+        }
+        while (!matches_.empty() && matches_.front() < firstLine_)
+            matches_.pop_front();
+    }
+
+    std::string_view lineText(uint64_t number) const
+    {
+        const Line& l = lines_[static_cast<size_t>(number - firstLine_)];
+        const char* block = blocks_[static_cast<size_t>(l.offset / kBlockSize - firstBlock_)].get();
+        return std::string_view(block + l.offset % kBlockSize, l.length);
+    }
+
+    // Same answer as ImGuiTextFilter::PassFilter; a single plain term (the
+    // common case) skips its per-position case folding and jumps between
+    // candidate first bytes with memchr.
+    bool passes(std::string_view line) const
+    {
+        if (!lastFilterSimple_ || needle_.empty())
+            return filter_.PassFilter(line.data(), line.data() + line.size());
+        if (line.size() < needle_.size()) return false;
+
+        const char  lo = needle_[0];
+        const char  up = static_cast<char>(std::toupper(static_cast<unsigned char>(lo)));
+        const char* p = line.data();
+        const char* end = line.data() + line.size() - needle_.size() + 1;
+        while (p < end) {
+            const char* a = static_cast<const char*>(std::memchr(p, lo, end - p));
+            const char* b = up != lo ? static_cast<const char*>(std::memchr(p, up, (a ? a : end) - p)) : nullptr;
+            const char* c = b ? b : a;
+            if (!c) return false;
+            size_t i = 1;
+            while (i < needle_.size() && std::tolower(static_cast<unsigned char>(c[i])) == needle_[i]) ++i;
+            if (i == needle_.size()) return true;
+            p = c + 1;
+        }
+        return false;
+    }
+
+    // A filter that only grew a plain term can only match fewer lines:
+    // narrow the previous result instead of rescanning the scrollback.
+    void refilter()
+    {
+        const std::string text = filter_.InputBuf;
+        const bool simple = text.find_first_of(",-") == std::string::npos;
+        const bool narrowing = simple && lastFilterSimple_ && !needle_.empty()
+            && text.find(lastFilter_) != std::string::npos;
+
+        lastFilter_ = text;
+        lastFilterSimple_ = simple;
+        needle_.clear();
+        if (simple && filter_.Filters.Size == 1) {
+            const ImGuiTextFilter::ImGuiTextRange& r = filter_.Filters[0];
+            for (const char* c = r.b; c != r.e; ++c)
+                needle_ += static_cast<char>(std::tolower(static_cast<unsigned char>(*c)));
+        }
+
+        if (narrowing) {
+            std::deque<uint64_t> kept;
+            for (uint64_t n : matches_) {
+                std::string_view l = lineText(n);
+                if (passes(l)) kept.push_back(n);
+            }
+            matches_.swap(kept);
+        }
+        else {
+            matches_.clear();
+            if (filter_.IsActive()) {
+                for (uint64_t n = firstLine_; n < firstLine_ + lines_.size(); ++n) {
+                    std::string_view l = lineText(n);
+                    if (passes(l)) matches_.push_back(n);
+                }
+            }
+        }
+    }
+
+    void clear()
+    {
+        blocks_.clear();
+        blockUsed_ = 0;
+        firstBlock_ = 0;
+        lines_.clear();
+        firstLine_ = 0;
+        matches_.clear();
+    }
+
+    LogRing                             ring_;
+    std::deque<std::unique_ptr<char[]>> blocks_;
+    size_t                              blockUsed_ = 0;
+    uint64_t                            firstBlock_ = 0;   // number of blocks_[0]
+    std::deque<Line>                    lines_;
+    uint64_t                            firstLine_ = 0;    // number of lines_[0]
+
+    ImGuiTextFilter                     filter_;
+    std::deque<uint64_t>                matches_;          // line numbers passing filter_
+    std::string                         lastFilter_;
+    bool                                lastFilterSimple_ = false;
+    std::string                         needle_;           // lowered term when lastFilterSimple_
     bool autoScroll_ = true;
 };
@@ -0,0 +1,172 @@
+// directory_model.cpp
+#include "directory_model.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+
+namespace fs = std::filesystem;
+
+namespace {
+    // `p` is `dir` or lies below it.
+    bool isWithin(const fs::path& p, const fs::path& dir)
+    {
+        return std::mismatch(dir.begin(), dir.end(), p.begin(), p.end()).first == dir.end();
+    }
+}
+
+DirectoryModel::DirectoryModel()
+{
+    m_watcher = std::make_unique<FsWatcher>([this](const fs::path& dir) {
+        std::lock_guard<std::mutex> lock(m_dirtyMutex);
+        m_dirty.insert(dir);
+    });
+}
+
+DirectoryModel::~DirectoryModel()
+{
+    m_watcher.reset();   // no more callbacks into a half-destroyed model
+}
+
+std::vector<DirEntry> DirectoryModel::list(const fs::path& dir)
+{
+    std::vector<DirEntry> out;
+    try {
+        for (auto& e : fs::directory_iterator(dir, fs::directory_options::skip_permission_denied)) {
+            std::error_code ec;
+            DirEntry entry;
+            entry.path = e.path();
+            entry.label = pathToUtf8(e.path().filename());
+            entry.isDir = e.is_directory(ec);
+            entry.id = fs::hash_value(entry.path);
+            out.push_back(std::move(entry));
+        }
+    }
+    catch (const fs::filesystem_error& err) {
+        std::fprintf(stderr, "[DirectoryModel] directory_iterator error: %s\n", err.what());
+    }
+
+    std::sort(out.begin(), out.end(), [](const DirEntry& a, const DirEntry& b)
+        {
+            if (a.isDir != b.isDir) return a.isDir;
+            return a.path.filename() < b.path.filename();
+        });
+    return out;
+}
+
+void DirectoryModel::request(const fs::path& dir, Node& node)
+{
+    if (node.pending.valid()) {          // already running: re-list once it lands
+        node.stale = true;
+        return;
+    }
+    node.stale = false;
+    node.pending = std::async(std::launch::async, [dir] { return list(dir); });
+}
+
+const std::vector<DirEntry>* DirectoryModel::children(const fs::path& dir)
+{
+    auto [it, inserted] = m_nodes.try_emplace(dir);
+    Node& node = it->second;
+    if (inserted) {
+        m_watcher->watch(dir);
+        request(dir, node);
+    }
+    return node.loaded ? &node.entries : nullptr;
+}
+
+DirectoryModel::NodeMap::iterator DirectoryModel::forget(NodeMap::iterator it)
+{
+    m_watcher->unwatch(it->first);
+    if (it->second.pending.valid())
+        m_reaper.push_back(std::move(it->second.pending));
+    return m_nodes.erase(it);
+}
+
+void DirectoryModel::release(const fs::path& dir)
+{
+    // Paths compare element by element, so `dir` and everything below it
+    // form one run of the map.
+    auto it = m_nodes.lower_bound(dir);
+    if (it == m_nodes.end() || !isWithin(it->first, dir)) return;
+    while (it != m_nodes.end() && isWithin(it->first, dir))
+        it = forget(it);
+    ++m_generation;
+}
+
+void DirectoryModel::invalidate(const fs::path& dir)
+{
+    if (auto it = m_nodes.find(dir); it != m_nodes.end())
+        request(dir, it->second);
+}
+
+void DirectoryModel::setExpanded(const fs::path& dir, bool open)
+{
+    if (open) {
+        if (m_expanded.insert(dir).second) ++m_generation;   // listed by the next flatten()
+        return;
+    }
+    // Collapsed: the subtree is gone from view, expanded descendants
+    // included; stop watching it and drop the listings.
+    for (auto it = m_expanded.lower_bound(dir); it != m_expanded.end() && isWithin(*it, dir);) {
+        it = m_expanded.erase(it);
+        ++m_generation;
+    }
+    release(dir);
+}
+
+void DirectoryModel::appendRows(const DirEntry& entry, int depth, std::vector<TreeRow>& rows)
+{
+    rows.push_back({ &entry, depth });
+    if (!entry.isDir || !isExpanded(entry.path)) return;
+
+    const std::vector<DirEntry>* kids = children(entry.path);
+    if (!kids) {
+        rows.push_back({ nullptr, depth + 1 });
+        return;
+    }
+    for (const DirEntry& kid : *kids)
+        appendRows(kid, depth + 1, rows);
+}
+
+void DirectoryModel::flatten(const DirEntry& root, std::vector<TreeRow>& rows)
+{
+    rows.clear();
+    appendRows(root, 0, rows);
+}
+
+void DirectoryModel::clear()
+{
+    for (auto it = m_nodes.begin(); it != m_nodes.end();)
+        it = forget(it);
+    m_expanded.clear();
+    ++m_generation;
+}
+
+void DirectoryModel::poll()
+{
+    // 1) change notifications from the watcher thread
+    std::set<fs::path> dirty;
+    {
+        std::lock_guard<std::mutex> lock(m_dirtyMutex);
+        dirty.swap(m_dirty);
+    }
+    for (auto& dir : dirty)
+        invalidate(dir);
+
+    // 2) finished listings nobody wants any more
+    std::erase_if(m_reaper, [](const auto& pending) {
+        return pending.wait_for(std::chrono::seconds(0)) == std::future_status::ready; });
+
+    // 3) finished listings
+    for (auto& [dir, node] : m_nodes) {
+        if (!node.pending.valid() ||
+            node.pending.wait_for(std::chrono::seconds(0)) != std::future_status::ready)
+            continue;
+
+        node.entries = node.pending.get();
+        node.loaded = true;
+        ++m_generation;
+        if (node.stale)
+            request(dir, node);
+    }
+}
@@ -0,0 +1,110 @@
+// directory_model.h
+#pragma once
+#include <filesystem>
+#include <future>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <string>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include <platform/fs_watcher.h>
+
+inline std::string pathToUtf8(const std::filesystem::path& p)
+{
+#if defined(__cpp_char8_t)
+    std::u8string tmp = p.u8string();
+    return std::string(tmp.begin(), tmp.end());
+#else
+    return p.u8string();
+#endif
+}
+
+// One child of a listed directory, ready to draw.
+struct DirEntry {
+    std::filesystem::path path;
+    std::string           label;    // UTF-8 file name
+    bool                  isDir = false;
+    std::size_t           id = 0;   // fs::hash_value(path), a stable ImGui ID
+};
+
+// One visible line of the flattened tree.  `entry` points into the model's
+// cache and stays valid until generation() changes; nullptr marks the
+// "Loading..." placeholder under a directory whose listing is pending.
+struct TreeRow {
+    const DirEntry* entry = nullptr;
+    int             depth = 0;
+};
+
+// Cached, sorted directory listings for the file tree.
+//
+// Listings are produced on a background task and kept current by an
+// FsWatcher; the UI thread only ever reads the cache.  Call poll() once a
+// frame to pick up finished listings and change notifications.
+class DirectoryModel {
+public:
+    DirectoryModel();
+    ~DirectoryModel();
+
+    // Cached children of `dir` (directories first, then by name), or
+    // nullptr while the first listing is still running.  Requests a
+    // listing and starts watching `dir` on first use; never blocks.
+    const std::vector<DirEntry>* children(const std::filesystem::path& dir);
+
+    // Forget `dir` and every directory listed below it (e.g. its tree node
+    // was collapsed) and stop watching them.  Never blocks.
+    void release(const std::filesystem::path& dir);
+
+    // Re-list `dir` in the background; the old listing stays visible
+    // until the new one arrives.
+    void invalidate(const std::filesystem::path& dir);
+
+    // Expansion state lives here rather than in ImGui's tree storage so
+    // the tree can be flattened without submitting collapsed nodes.
+    bool isExpanded(const std::filesystem::path& dir) const { return m_expanded.contains(dir); }
+    void setExpanded(const std::filesystem::path& dir, bool open);
+
+    // Rebuild `rows` as the depth-first list of everything visible under
+    // `root` (root included).  Cheap enough to redo whenever generation()
+    // moves, far too slow to redo every frame for a 100k-entry folder.
+    void flatten(const DirEntry& root, std::vector<TreeRow>& rows);
+
+    // Bumped whenever a listing or the expansion state changes.
+    std::uint64_t generation() const { return m_generation; }
+
+    void clear();
+    void poll();
+
+private:
+    struct Node {
+        std::vector<DirEntry>              entries;
+        bool                               loaded = false;
+        bool                               stale = false;   // re-list when the running job lands
+        std::future<std::vector<DirEntry>> pending;
+    };
+
+    using NodeMap = std::map<std::filesystem::path, Node>;
+
+    static std::vector<DirEntry> list(const std::filesystem::path& dir);
+    void request(const std::filesystem::path& dir, Node& node);
+    NodeMap::iterator forget(NodeMap::iterator it);
+    void appendRows(const DirEntry& entry, int depth, std::vector<TreeRow>& rows);
+
+    NodeMap                               m_nodes;
+    std::set<std::filesystem::path>       m_expanded;
+    std::uint64_t                         m_generation = 0;
+
+    // Listings still running for forgotten directories.  Destroying a
+    // std::async future waits for its task, and listing a huge or remote
+    // directory takes a while, so poll() drops them once they finish.
+    std::vector<std::future<std::vector<DirEntry>>> m_reaper;
+
+    // Written by the watcher thread, drained by poll().
+    std::mutex                         m_dirtyMutex;
+    std::set<std::filesystem::path>    m_dirty;
+
+    std::unique_ptr<FsWatcher>         m_watcher;   // last: stops before the rest goes away
+};
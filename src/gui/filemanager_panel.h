@@ -11,31 +11,28 @@
 #include <cstdio>
 #include <fstream>
 #include <cstring>
+#include <cstdint>
+#include <vector>
 #include <imgui.h>
+#include <gui/directory_model.h>
+#include <platform/file_ops.h>
 
 namespace fs = std::filesystem;
 
-inline std::string pathToUtf8(const fs::path& p)
-{
-#if defined(_MSC_VER) && defined(__cpp_char8_t)
-    std::u8string tmp = p.u8string();
-    return std::string(tmp.begin(), tmp.end());
-#else
-    return p.u8string();
-#endif
-}
-
 class FileManagerPanel
 {
 public:
     explicit FileManagerPanel(const fs::path& root = fs::current_path())
         : m_root(fs::absolute(root)), m_selectedPath(m_root) {
+        m_rootEntry = { m_root, rootLabel(), true, fs::hash_value(m_root) };
     }
 
     void setRoot(const fs::path& root)
     {
         m_root = fs::absolute(root);
         m_selectedPath = m_root;
+        m_model.clear();
+        m_rootEntry = { m_root, rootLabel(), true, fs::hash_value(m_root) };
     }
 
 	void GetRoot(fs::path& root) const
@@ -45,15 +42,52 @@ public:
 
     void setOpenFileCallback(std::function<void(const fs::path&)> cb) { m_openFileCB = std::move(cb); }
 
+    // Expand every directory listed so far; returns false once nothing was
+    // left to expand.  Listings arrive in the background, so scripted runs
+    // call this once a frame until it settles.
+    bool expandLoaded()
+    {
+        bool expanded = false;
+        for (const TreeRow& row : m_rows)
+        {
+            if (row.entry && row.entry->isDir && !m_model.isExpanded(row.entry->path))
+            {
+                m_model.setExpanded(row.entry->path, true);
+                expanded = true;
+            }
+        }
+        return expanded;
+    }
+
     // -----------------------------------------------------------------------------
     void draw(const char* title = "File Manager")
     {
         if (!ImGui::Begin(title)) { ImGui::End(); return; }
 
-        ImGui::BeginChild("##file_tree", ImVec2(0, 0), true,
+        m_model.poll();
+
+        if (m_rowsGeneration != m_model.generation())
+        {
+            m_model.flatten(m_rootEntry, m_rows);
+            m_rowsGeneration = m_model.generation();
+        }
+
+        collectFinishedOps();
+        std::vector<FileOperationQueue::Status> ops = m_fileOps.active();
+        float footer = ops.empty() ? 0.0f : -ImGui::GetFrameHeightWithSpacing() * static_cast<float>(ops.size());
+
+        ImGui::BeginChild("##file_tree", ImVec2(0, footer), true,
             ImGuiWindowFlags_HorizontalScrollbar);
-        drawDirectory(m_root);
+        drawTree();
         ImGui::EndChild();
+        drawFileOps(ops);
+
+        // Applied after drawing: collapsing frees listings m_rows points into.
+        if (!m_toggledPath.empty())
+        {
+            m_model.setExpanded(m_toggledPath, !m_model.isExpanded(m_toggledPath));
+            m_toggledPath.clear();
+        }
 
         if (ImGui::IsWindowHovered() && ImGui::IsMouseClicked(ImGuiMouseButton_Left)
             && !ImGui::IsAnyItemHovered())
@@ -75,6 +109,12 @@ public:
 
 private:
     fs::path                         m_root;
+    DirectoryModel                   m_model;      // cached listings, the only fs access while drawing
+    DirEntry                         m_rootEntry;
+    std::vector<TreeRow>             m_rows;       // flattened tree, rebuilt when the model changes
+    std::uint64_t                    m_rowsGeneration = ~std::uint64_t(0);
+    fs::path                         m_toggledPath;
+    FileOperationQueue               m_fileOps;    // copy / move / delete, off the UI thread
     fs::path                         m_selectedPath;
     fs::path                         m_clipboardPath;
     fs::path                         m_pasteTargetDir;
@@ -99,22 +139,7 @@ private:
             if (ImGui::Button("Copy here", ImVec2(120, 0)))
             {
                 fs::path dest = m_pasteTargetDir / m_inputBuffer;
-
-                try {
-                    if (m_clipboardCut)
-                        fs::rename(m_clipboardPath, dest);
-                    else if (fs::is_directory(m_clipboardPath))
-                        fs::copy(m_clipboardPath, dest,
-                            fs::copy_options::recursive |
-                            fs::copy_options::overwrite_existing);
-                    else
-                        fs::copy_file(m_clipboardPath, dest,
-                            fs::copy_options::overwrite_existing);
-                }
-                catch (const fs::filesystem_error& err) {
-                    std::fprintf(stderr, "[FileManager] paste‑rename error: %s\n",
-                        err.what());
-                }
+                startPaste(dest);
 
                 m_activeModal = Modal::None;
                 ImGui::CloseCurrentPopup();
@@ -129,85 +154,89 @@ private:
         }
     }
 
-    void drawDirectory(const fs::path& dir)
+    std::string rootLabel() const
     {
-        if (!fs::exists(dir)) return;
+        std::string label = pathToUtf8(m_root.filename());
+        if (label.empty()) label = pathToUtf8(m_root.root_name().empty() ? m_root : m_root.root_name());
+        return label;
+    }
 
-        std::string label = pathToUtf8(dir.filename());
-        if (label.empty()) label = pathToUtf8(dir.root_name().empty() ? dir.string() : dir.root_name());
+    // Only the rows on screen are submitted; a folder with 100k entries
+    // costs the same per frame as one with ten.
+    void drawTree()
+    {
+        const float indent = ImGui::GetStyle().IndentSpacing;
 
-        ImGui::PushID(label.c_str());
-        bool isSelected = (dir == m_selectedPath);
-        ImGuiTreeNodeFlags flags = ImGuiTreeNodeFlags_OpenOnArrow | ImGuiTreeNodeFlags_SpanFullWidth;
+        ImGuiListClipper clipper;
+        clipper.Begin(static_cast<int>(m_rows.size()));
+        while (clipper.Step())
+        {
+            for (int i = clipper.DisplayStart; i < clipper.DisplayEnd; ++i)
+            {
+                const TreeRow& row = m_rows[i];
+                ImGui::SetCursorPosX(ImGui::GetCursorPosX() + row.depth * indent);
+
+                if (!row.entry)            ImGui::TextDisabled("Loading...");
+                else if (row.entry->isDir) drawDirectory(*row.entry);
+                else                       drawFile(*row.entry);
+            }
+        }
+        clipper.End();
+    }
+
+    void drawDirectory(const DirEntry& e)
+    {
+        ImGui::PushID(reinterpret_cast<const void*>(e.id));
+        bool isSelected = (e.path == m_selectedPath);
+        ImGuiTreeNodeFlags flags = ImGuiTreeNodeFlags_OpenOnArrow | ImGuiTreeNodeFlags_SpanFullWidth
+                                 | ImGuiTreeNodeFlags_NoTreePushOnOpen;
         if (isSelected) flags |= ImGuiTreeNodeFlags_Selected;
-        bool opened = ImGui::TreeNodeEx(label.c_str(), flags);
+        ImGui::SetNextItemOpen(m_model.isExpanded(e.path));
+        ImGui::TreeNodeEx(e.label.c_str(), flags);
+
+        if (ImGui::IsItemToggledOpen())
+            m_toggledPath = e.path;
 
         // Left click selects
         if (ImGui::IsItemClicked() && !ImGui::IsItemToggledOpen())
-            m_selectedPath = dir;
+            m_selectedPath = e.path;
 
-        // Double‑click for selection (and expansion handled by ImGui)
+        // Double‑click for selection
         if (ImGui::IsItemHovered() && ImGui::IsMouseDoubleClicked(0))
-            m_selectedPath = dir;
+            m_selectedPath = e.path;
 
         // Right‑click context menu – also selects
         if (ImGui::BeginPopupContextItem())
         {
-            m_selectedPath = dir;
-            directoryContextMenu(dir);
+            m_selectedPath = e.path;
+            directoryContextMenu(e.path);
             ImGui::EndPopup();
         }
-
-        if (opened)
-        {
-            try {
-                std::vector<fs::directory_entry> entries;
-                for (auto& e : fs::directory_iterator(dir, fs::directory_options::skip_permission_denied))
-                    entries.push_back(e);
-                std::sort(entries.begin(), entries.end(), [](const auto& a, const auto& b)
-                    {
-                        if (a.is_directory() != b.is_directory()) return a.is_directory();
-                        return a.path().filename() < b.path().filename();
-                    });
-
-                for (auto& e : entries)
-                {
-                    if (e.is_directory()) drawDirectory(e.path());
-                    else                  drawFile(e.path());
-                }
-            }
-            catch (const fs::filesystem_error& err)
-            {
-                std::fprintf(stderr, "[FileManager] directory_iterator error: %s\n", err.what());
-            }
-            ImGui::TreePop();
-        }
         ImGui::PopID();
     }
 
-    void drawFile(const fs::path& file)
+    void drawFile(const DirEntry& e)
     {
-        std::string label = pathToUtf8(file.filename());
-        ImGui::PushID(label.c_str());
+        ImGui::PushID(reinterpret_cast<const void*>(e.id));
 
-        bool isSelected = (file == m_selectedPath);
+        bool isSelected = (e.path == m_selectedPath);
         ImGuiTreeNodeFlags flags = ImGuiTreeNodeFlags_Leaf | ImGuiTreeNodeFlags_NoTreePushOnOpen | ImGuiTreeNodeFlags_SpanFullWidth;
         if (isSelected) flags |= ImGuiTreeNodeFlags_Selected;
-        ImGui::TreeNodeEx(label.c_str(), flags);
+        ImGui::TreeNodeEx(e.label.c_str(), flags);
 
         if (ImGui::IsItemClicked())
-            m_selectedPath = file;
+            m_selectedPath = e.path;
 
         if (ImGui::IsItemHovered() && ImGui::IsMouseDoubleClicked(0))
         {
-            m_selectedPath = file;
+            m_selectedPath = e.path;
             openInEditor();
         }
 
         if (ImGui::BeginPopupContextItem())
         {
-            m_selectedPath = file;
-            fileContextMenu(file);
+            m_selectedPath = e.path;
+            fileContextMenu(e.path);
             ImGui::EndPopup();
         }
 
@@ -215,7 +244,7 @@ private:
     }
 
     // -----------------------------------------------------------------------------
-    void directoryContextMenu(const fs::path& dir)
+    void directoryContextMenu(const fs::path& /*dir*/)
     {
         if (ImGui::MenuItem("New Folder")) openModal(Modal::NewFolder);
         if (ImGui::MenuItem("New File"))   openModal(Modal::NewFile);
@@ -232,7 +261,7 @@ private:
         if (ImGui::MenuItem("Open in Explorer")) openInOSExplorer();
     }
 
-    void fileContextMenu(const fs::path& file)
+    void fileContextMenu(const fs::path& /*file*/)
     {
         if (ImGui::MenuItem("Copy"))   startCopy(false);
         if (ImGui::MenuItem("Cut"))    startCopy(true);
@@ -248,6 +277,14 @@ private:
     }
 
     // -----------------------------------------------------------------------------
+    // Re-list the parents of paths we just touched.  The watcher would catch
+    // these too, but the polling fallback only looks once a second.
+    void refreshListings(const fs::path& a, const fs::path& b = {})
+    {
+        if (!a.empty()) m_model.invalidate(a.parent_path());
+        if (!b.empty()) m_model.invalidate(b.parent_path());
+    }
+
     void startCopy(bool cut)
     {
         if (m_selectedPath.empty()) return;
@@ -271,20 +308,56 @@ private:
             return;
         }
 
-        try {
-            if (m_clipboardCut)
-                fs::rename(m_clipboardPath, dest);
-            else if (fs::is_directory(m_clipboardPath))
-                fs::copy(m_clipboardPath, dest,
-                    fs::copy_options::recursive |
-                    fs::copy_options::overwrite_existing);
-            else
-                fs::copy_file(m_clipboardPath, dest,
-                    fs::copy_options::overwrite_existing);
+        startPaste(dest);
+    }
+
+    void startPaste(const fs::path& dest)
+    {
+        if (m_clipboardCut) m_fileOps.move(m_clipboardPath, dest);
+        else                m_fileOps.copy(m_clipboardPath, dest);
+    }
+
+    // Finished operations: refresh the listings they touched and report failures.
+    void collectFinishedOps()
+    {
+        for (const FileOperationQueue::Status& op : m_fileOps.takeFinished())
+        {
+            if (!op.error.empty())
+                std::fprintf(stderr, "[FileManager] %s error: %s\n", opVerb(op.kind), op.error.c_str());
+            refreshListings(op.source, op.kind == FileOperationQueue::Kind::Delete ? fs::path{} : op.dest);
+        }
+    }
+
+    void drawFileOps(const std::vector<FileOperationQueue::Status>& ops)
+    {
+        for (const FileOperationQueue::Status& op : ops)
+        {
+            ImGui::PushID(static_cast<int>(op.id));
+            std::string name = pathToUtf8(op.source.filename());
+            char overlay[300];
+            std::snprintf(overlay, sizeof(overlay), "%s %s%s", opVerb(op.kind), name.c_str(),
+                op.running ? "" : " (queued)");
+
+            // Moves within a volume and directory scans have no total yet.
+            float fraction = op.total ? static_cast<float>(double(op.done) / double(op.total)) : 0.0f;
+            ImGui::ProgressBar(fraction, ImVec2(-ImGui::CalcTextSize("Cancel").x - ImGui::GetStyle().FramePadding.x * 2
+                - ImGui::GetStyle().ItemSpacing.x, 0), overlay);
+            ImGui::SameLine();
+            if (ImGui::Button("Cancel"))
+                m_fileOps.cancel(op.id);
+            ImGui::PopID();
         }
-        catch (const fs::filesystem_error& err) {
-            std::fprintf(stderr, "[FileManager] paste error: %s\n", err.what());
+    }
+
+    static const char* opVerb(FileOperationQueue::Kind kind)
+    {
+        switch (kind)
+        {
+        case FileOperationQueue::Kind::Copy:   return "copy";
+        case FileOperationQueue::Kind::Move:   return "move";
+        case FileOperationQueue::Kind::Delete: return "delete";
         }
+        return "";
     }
 
 
@@ -405,15 +478,7 @@ void openInOSExplorer()
             ImGui::Separator();
             if (ImGui::Button("Yes", ImVec2(120, 0)))
             {
-                try {
-                    if (fs::is_directory(m_selectedPath))
-                        fs::remove_all(m_selectedPath);
-                    else
-                        fs::remove(m_selectedPath);
-                }
-                catch (const fs::filesystem_error& err) {
-                    std::fprintf(stderr, "[FileManager] delete error: %s\n", err.what());
-                }
+                m_fileOps.remove(m_selectedPath);
                 m_activeModal = Modal::None;
                 ImGui::CloseCurrentPopup();
             }
@@ -437,6 +502,7 @@ void openInOSExplorer()
                 fs::path newPath = m_selectedPath.parent_path() / m_inputBuffer;
                 try { fs::rename(m_selectedPath, newPath); }
                 catch (const fs::filesystem_error& err) { std::fprintf(stderr, "[FileManager] rename error: %s\n", err.what()); }
+                refreshListings(newPath);
                 m_selectedPath = newPath;
                 m_activeModal = Modal::None;
                 ImGui::CloseCurrentPopup();
@@ -462,6 +528,7 @@ void openInOSExplorer()
                 fs::path newDir = parent / m_inputBuffer;
                 try { fs::create_directory(newDir); }
                 catch (const fs::filesystem_error& err) { std::fprintf(stderr, "[FileManager] mkdir error: %s\n", err.what()); }
+                refreshListings(newDir);
                 m_activeModal = Modal::None;
                 ImGui::CloseCurrentPopup();
             }
@@ -491,6 +558,7 @@ void openInOSExplorer()
                 {
                     std::fprintf(stderr, "[FileManager] could not create file\n");
                 }
+                refreshListings(newFile);
                 m_activeModal = Modal::None;
                 ImGui::CloseCurrentPopup();
             }
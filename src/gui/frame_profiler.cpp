@@ -0,0 +1,75 @@
+// frame_profiler.cpp
+#include "frame_profiler.h"
+#include <imgui.h>
+
+namespace {
+    using Clock = std::chrono::steady_clock;
+
+    double msBetween(Clock::time_point a, Clock::time_point b)
+    {
+        return std::chrono::duration<double, std::milli>(b - a).count();
+    }
+}
+
+FrameProfiler& FrameProfiler::instance()
+{
+    static FrameProfiler profiler;
+    return profiler;
+}
+
+void FrameProfiler::beginFrame()
+{
+    const auto now = Clock::now();
+    if (m_started) {
+        const float interval = static_cast<float>(msBetween(m_prevFrameStart, now));
+        if (m_history.size() < kHistory)
+            m_history.push_back(interval);
+        else
+            m_history[m_historyNext] = interval;
+        m_historyNext = (m_historyNext + 1) % kHistory;
+    }
+    m_started = true;
+    m_prevFrameStart = now;
+    m_frameStart = now;
+    m_current.clear();
+    m_depth = 0;
+}
+
+void FrameProfiler::endFrame(const ImDrawData* drawData)
+{
+    m_lastCpuMs = msBetween(m_frameStart, Clock::now());
+    m_lastCounts = countDrawData(drawData);
+    m_last.swap(m_current);
+}
+
+FrameProfiler::DrawCounts FrameProfiler::countDrawData(const ImDrawData* drawData)
+{
+    DrawCounts counts;
+    if (!drawData) return counts;
+    counts.drawLists = static_cast<std::size_t>(drawData->CmdListsCount);
+    counts.vertices = static_cast<std::size_t>(drawData->TotalVtxCount);
+    counts.indices = static_cast<std::size_t>(drawData->TotalIdxCount);
+    for (const ImDrawList* list : drawData->CmdLists)
+        counts.drawCalls += static_cast<std::size_t>(list->CmdBuffer.Size);
+    return counts;
+}
+
+/*──────────────────────────────────────────────────────────*/
+/*                          scopes                          */
+FrameProfiler::Scope::Scope(const char* name)
+{
+    FrameProfiler& p = instance();
+    m_index = p.m_current.size();
+    p.m_current.push_back({ name, p.m_depth++, 0.0 });
+    m_start = Clock::now();
+}
+
+void FrameProfiler::Scope::end()
+{
+    if (!m_open) return;
+    m_open = false;
+    FrameProfiler& p = instance();
+    if (m_index < p.m_current.size())   // the frame may have been closed under us
+        p.m_current[m_index].ms = msBetween(m_start, Clock::now());
+    if (p.m_depth > 0) --p.m_depth;
+}
@@ -0,0 +1,77 @@
+// frame_profiler.h
+#pragma once
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+struct ImDrawData;
+
+// Per-frame CPU timings for the performance view in the Inspector.
+//
+// GuiLayer brackets every frame with beginFrame() / endFrame(); panels and
+// TextEditor::Draw phases open Scopes in between.  Only the last finished
+// frame's scopes and a short history of frame times are kept, so the cost
+// is two clock reads per scope and nothing is allocated once warm.  UI
+// thread only.
+class FrameProfiler {
+public:
+    struct Sample {
+        const char* name;    // string literal
+        int         depth;   // nesting level, 0 = panel
+        double      ms;
+    };
+
+    struct DrawCounts {
+        std::size_t drawLists = 0;
+        std::size_t drawCalls = 0;   // ImDrawCmd count
+        std::size_t vertices = 0;
+        std::size_t indices = 0;
+    };
+
+    static constexpr std::size_t kHistory = 240;   // frames (4 s at 60 Hz)
+
+    static FrameProfiler& instance();
+
+    void beginFrame();
+    // After ImGui::Render(): closes the frame and counts its draw data.
+    void endFrame(const ImDrawData* drawData);
+
+    const std::vector<Sample>& lastFrame() const { return m_last; }
+    const DrawCounts&          lastDrawCounts() const { return m_lastCounts; }
+    double                     lastCpuMs() const { return m_lastCpuMs; }
+
+    // Frame-to-frame intervals (what the user sees, vsync included), oldest
+    // first once the ring has wrapped; see historyOffset().
+    const std::vector<float>& history() const { return m_history; }
+    std::size_t               historyOffset() const { return m_historyNext; }
+
+    static DrawCounts countDrawData(const ImDrawData* drawData);
+
+    class Scope {
+    public:
+        explicit Scope(const char* name);
+        ~Scope() { end(); }
+        Scope(const Scope&) = delete;
+        Scope& operator=(const Scope&) = delete;
+
+        // Close early, for phases of a longer function.
+        void end();
+
+    private:
+        std::size_t                           m_index;
+        std::chrono::steady_clock::time_point m_start;
+        bool                                  m_open = true;
+    };
+
+private:
+    std::vector<Sample> m_current, m_last;
+    int                 m_depth = 0;
+    DrawCounts          m_lastCounts;
+    double              m_lastCpuMs = 0;
+
+    std::vector<float>                    m_history;
+    std::size_t                           m_historyNext = 0;
+    std::chrono::steady_clock::time_point m_frameStart, m_prevFrameStart;
+    bool                                  m_started = false;
+};
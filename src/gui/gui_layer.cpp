@@ -1,11 +1,8 @@
 ﻿// ─── gui_layer.cpp ────────────────────────────────────────────────────────────
-#include <glfw/glfw3.h>
 #include "gui_layer.h"
 
 #include <imgui.h>
 #include <imgui_internal.h>
-#include <imgui_impl_glfw.h>
-#include <imgui_impl_opengl3.h>
 
 #include <filesystem>
 #include <fstream>
@@ -16,6 +13,10 @@
 #include <gui/symbols_panel.h>
 #include <gui/inspector_panel.h>
 #include <gui/console_panel.h>
+#include <gui/quick_open_panel.h>
+#include <gui/symbol_search_panel.h>
+#include <gui/memory_panel.h>
+#include <gui/frame_profiler.h>
 
 namespace fs = std::filesystem;
 
@@ -26,6 +27,9 @@ TopBar           topBar{fm};
 SymbolsPanel     symbols;
 InspectorPanel   inspector;
 ConsolePanel     console;
+QuickOpenPanel   quickOpen;
+SymbolSearchPanel symbolSearch;
+MemoryPanel      memory;
 
 static struct _LinkSymbols {
     _LinkSymbols() { editor.SetSymbolsPanel(&symbols); }
@@ -34,29 +38,56 @@ static struct _LinkSymbols {
 /* ─── dock node tracking ───────────────────────────────────────────────────── */
 static std::unordered_map<std::string, ImGuiID> panelDockTargets;
 
-void GuiLayer::init(void* win)
+void GuiLayer::connectPanels()
 {
     fm.setOpenFileCallback([&](const fs::path& p) {
         editor.OpenFile(p.string());
         });
+    quickOpen.setOpenFileCallback([&](const fs::path& p) {
+        editor.OpenFile(p.string());
+        });
+    topBar.onGoToFile = [] {
+        fs::path root;
+        fm.GetRoot(root);
+        quickOpen.open(root);
+        };
+    symbolSearch.setIndex(&editor.WorkspaceSymbols());
+    symbolSearch.setJumpCallback([&](const std::string& path, int line, int column) {
+        editor.OpenFileAt(path, line, column);
+        });
+    topBar.onGoToSymbol = [] { symbolSearch.open(); };
+    topBar.onTogglePerformance = [] { inspector.togglePerformance(); };
+    inspector.setQueueSource([] { return editor.BackgroundQueue(); });
+    topBar.onToggleMemory = [] { memory.toggle(); };
+    memory.setReportSource([] { return editor.MemoryReport(); });
+}
 
-
+void GuiLayer::createContext(bool viewports)
+{
     IMGUI_CHECKVERSION();
     ImGui::CreateContext();
     ImGuiIO& io = ImGui::GetIO();
-    io.ConfigFlags |= ImGuiConfigFlags_DockingEnable | ImGuiConfigFlags_ViewportsEnable;
+    io.ConfigFlags |= ImGuiConfigFlags_DockingEnable;
+    if (viewports)   // needs a platform backend to create the extra windows
+        io.ConfigFlags |= ImGuiConfigFlags_ViewportsEnable;
+}
 
-    ImGui_ImplGlfw_InitForOpenGL(static_cast<GLFWwindow*>(win), true);
-    ImGui_ImplOpenGL3_Init();
+void GuiLayer::initHeadless()
+{
+    connectPanels();
+    createContext(false);
+    ImGui::GetIO().IniFilename = nullptr;   // same layout on every run
 }
 
-void GuiLayer::begin()
+void GuiLayer::shutdownHeadless()
 {
-    ImGui_ImplOpenGL3_NewFrame();
-    ImGui_ImplGlfw_NewFrame();
-    ImGui::NewFrame();
+    ImGui::DestroyContext();
 }
 
+FileManagerPanel& GuiLayer::fileManager()  { return fm; }
+EditorWindow&     GuiLayer::editorWindow() { return editor; }
+SymbolsPanel&     GuiLayer::symbolsPanel() { return symbols; }
+
 void GuiLayer::render()
 {
     // 1) full-screen host window
@@ -111,6 +142,7 @@ void GuiLayer::render()
         ImGui::DockBuilderDockWindow("Console", id_console);
         ImGui::DockBuilderDockWindow("Symbols", id_symbols);
         ImGui::DockBuilderDockWindow("Inspector", id_symbols);
+        ImGui::DockBuilderDockWindow("Memory", id_symbols);
 
         ImGui::DockBuilderFinish(dock_id);
     }
@@ -123,38 +155,25 @@ void GuiLayer::render()
         ImGuiDockNodeFlags_PassthruCentralNode
     );
 
-    // 4) draw your panels exactly as before
-    fm.draw("File Manager");
-    console.draw("Console");
-    editor.Draw();
-    symbols.draw("Symbols");
-    inspector.draw("Inspector");
-    topBar.draw(panelDockTargets, "MUT Demo (v1.5)");
+    // 4) draw your panels exactly as before, timing each one
+    using Scope = FrameProfiler::Scope;
+    { Scope s("File Manager"); fm.draw("File Manager"); }
+    { Scope s("Console");      console.draw("Console"); }
+    { Scope s("Editor");       editor.Draw(); }
+    { Scope s("Symbols");      symbols.draw("Symbols"); }
+    { Scope s("Inspector");    inspector.draw("Inspector"); }
+    { Scope s("Memory");       memory.draw("Memory"); }
+    { Scope s("Top Bar");      topBar.draw(panelDockTargets, "MUT Demo (v1.5)"); }
+
+    if (ImGui::GetIO().KeyCtrl && ImGui::IsKeyPressed(ImGuiKey_P, false))
+        topBar.onGoToFile();
+    if (ImGui::GetIO().KeyCtrl && ImGui::IsKeyPressed(ImGuiKey_T, false))
+        topBar.onGoToSymbol();
+    if (ImGui::IsKeyPressed(ImGuiKey_F12, false))
+        topBar.onTogglePerformance();
+    { Scope s("Go to File");   quickOpen.draw(); }
+    { Scope s("Go to Symbol"); symbolSearch.draw(); }
 
     ImGui::End();
 }
 
-
-
-
-void GuiLayer::end()
-{
-    ImGui::Render();
-    ImGui_ImplOpenGL3_RenderDrawData(ImGui::GetDrawData());
-
-    ImGuiIO& io = ImGui::GetIO();
-    if (io.ConfigFlags & ImGuiConfigFlags_ViewportsEnable)
-    {
-        GLFWwindow* backup = glfwGetCurrentContext();
-        ImGui::UpdatePlatformWindows();
-        ImGui::RenderPlatformWindowsDefault();
-        glfwMakeContextCurrent(backup);
-    }
-}
-
-void GuiLayer::shutdown()
-{
-    ImGui_ImplOpenGL3_Shutdown();
-    ImGui_ImplGlfw_Shutdown();
-    ImGui::DestroyContext();
-}
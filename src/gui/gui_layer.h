@@ -1,10 +1,32 @@
 // gui_layer.h
 #pragma once
+
+class FileManagerPanel;
+class EditorWindow;
+class SymbolsPanel;
+
 class GuiLayer {
 public:
+    // GLFW + OpenGL3 backends (gui_layer_glfw.cpp, Windows build only)
     void init(void* glfwWindow);
     void begin();
     void render();         // draw actual widgets
     void end();            // submit draw data
     void shutdown();
+
+    // No window and no backends: creates the ImGui context and wires the
+    // panels.  The caller fills ImGuiIO and brackets render() with
+    // ImGui::NewFrame() / ImGui::Render() itself (see NullBackend), and
+    // FrameProfiler::beginFrame() / endFrame() if it wants the timings.
+    void initHeadless();
+    void shutdownHeadless();
+
+    // Direct access for scripted scenarios (mut_frames).
+    FileManagerPanel& fileManager();
+    EditorWindow&     editorWindow();
+    SymbolsPanel&     symbolsPanel();
+
+private:
+    void connectPanels();
+    void createContext(bool viewports);
 };
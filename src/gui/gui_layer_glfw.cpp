@@ -0,0 +1,50 @@
+// ─── gui_layer_glfw.cpp ───────────────────────────────────────────────────────
+// GuiLayer on top of GLFW + OpenGL3.  Everything backend-independent lives
+// in gui_layer.cpp, so the panels also run headless (see initHeadless()).
+#include <glfw/glfw3.h>
+#include "gui_layer.h"
+#include "frame_profiler.h"
+
+#include <imgui.h>
+#include <imgui_impl_glfw.h>
+#include <imgui_impl_opengl3.h>
+
+void GuiLayer::init(void* win)
+{
+    connectPanels();
+    createContext(true);
+
+    ImGui_ImplGlfw_InitForOpenGL(static_cast<GLFWwindow*>(win), true);
+    ImGui_ImplOpenGL3_Init();
+}
+
+void GuiLayer::begin()
+{
+    FrameProfiler::instance().beginFrame();
+    ImGui_ImplOpenGL3_NewFrame();
+    ImGui_ImplGlfw_NewFrame();
+    ImGui::NewFrame();
+}
+
+void GuiLayer::end()
+{
+    ImGui::Render();
+    FrameProfiler::instance().endFrame(ImGui::GetDrawData());
+    ImGui_ImplOpenGL3_RenderDrawData(ImGui::GetDrawData());
+
+    ImGuiIO& io = ImGui::GetIO();
+    if (io.ConfigFlags & ImGuiConfigFlags_ViewportsEnable)
+    {
+        GLFWwindow* backup = glfwGetCurrentContext();
+        ImGui::UpdatePlatformWindows();
+        ImGui::RenderPlatformWindowsDefault();
+        glfwMakeContextCurrent(backup);
+    }
+}
+
+void GuiLayer::shutdown()
+{
+    ImGui_ImplOpenGL3_Shutdown();
+    ImGui_ImplGlfw_Shutdown();
+    ImGui::DestroyContext();
+}
@@ -1,6 +1,7 @@
 ﻿#pragma once
 #include <imgui.h>
 #include <string>
+#include <gui/performance_view.h>
 
 class InspectorPanel
 {
@@ -9,6 +10,14 @@ public:
     {
         if (!ImGui::Begin(title)) { ImGui::End(); return; }
 
+        ImGui::Checkbox("Performance", &showPerformance_);
+        ImGui::Separator();
+        if (showPerformance_) {
+            performance_.draw();
+            ImGui::End();
+            return;
+        }
+
         ImGui::Text("Object inspector (mock)");
         ImGui::Separator();
 
@@ -20,7 +29,12 @@ public:
         ImGui::End();
     }
 
+    void togglePerformance() { showPerformance_ = !showPerformance_; }
+    void setQueueSource(PerformanceView::QueueFn fn) { performance_.setQueueSource(std::move(fn)); }
+
 private:
+    bool            showPerformance_ = false;
+    PerformanceView performance_;
     char  name_[64] = "Cube";
     float pos_[3] = { 0.0f, 0.0f, 0.0f };
     float rot_[3] = { 0.0f, 0.0f, 0.0f };
@@ -0,0 +1,117 @@
+#pragma once
+#include <imgui.h>
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <filesystem>
+#include <functional>
+#include <string>
+#include <vector>
+
+#include <editor_window.h>   // EditorWindow::DocumentMemory
+
+/*---------------------------------------------------------------------------
+    MemoryPanel – bytes held per open document, split by structure.
+
+    One row per tab plus a totals row: text buffer, undo stack, token
+    storage and caches, semantic maps and the libclang TU, so it is obvious
+    which cache to trim.  Walking the caches is not free, so the report is
+    refreshed twice a second rather than every frame.  Hidden by default,
+    toggled from View > Memory.
+---------------------------------------------------------------------------*/
+class MemoryPanel
+{
+public:
+    using ReportFn = std::function<std::vector<EditorWindow::DocumentMemory>()>;
+
+    void setReportSource(ReportFn fn) { source_ = std::move(fn); }
+    void toggle() { open_ = !open_; }
+
+    void draw(const char* title = "Memory")
+    {
+        if (!open_) return;
+        if (!ImGui::Begin(title, &open_)) { ImGui::End(); return; }
+
+        refresh();
+        TextEditor::MemoryUsage total;
+        for (const auto& doc : report_) accumulate(total, doc.usage);
+
+        ImGui::Text("%zu documents, %s in use (+%s mapped)", report_.size(),
+            formatBytes(total.Total()).c_str(), formatBytes(total.mapped).c_str());
+        ImGui::Separator();
+
+        constexpr ImGuiTableFlags flags = ImGuiTableFlags_RowBg | ImGuiTableFlags_BordersInnerV
+            | ImGuiTableFlags_ScrollY | ImGuiTableFlags_ScrollX | ImGuiTableFlags_SizingFixedFit;
+        if (ImGui::BeginTable("##memory", kColumns, flags)) {
+            ImGui::TableSetupScrollFreeze(1, 1);
+            for (const char* name : kHeaders)
+                ImGui::TableSetupColumn(name);
+            ImGui::TableHeadersRow();
+
+            for (const auto& doc : report_) {
+                std::string name = std::filesystem::path(doc.path).filename().string();
+                if (doc.hibernated) name += " (hibernated)";
+                row(name.c_str(), doc.usage);
+            }
+            row("Total", total);
+            ImGui::EndTable();
+        }
+        ImGui::End();
+    }
+
+private:
+    static constexpr int kColumns = 10;
+    static constexpr const char* kHeaders[kColumns] = {
+        "Document", "Total", "Buffer", "Undo", "Tokens/line",
+        "Line cache", "Token cache", "Semantic", "Clang TU", "Mapped" };
+
+    bool                                        open_ = false;
+    ReportFn                                    source_;
+    std::vector<EditorWindow::DocumentMemory>   report_;
+    std::chrono::steady_clock::time_point       lastRefresh_{};
+
+    void refresh()
+    {
+        const auto now = std::chrono::steady_clock::now();
+        if (!source_ || now - lastRefresh_ < std::chrono::milliseconds(500)) return;
+        lastRefresh_ = now;
+        report_ = source_();
+        std::sort(report_.begin(), report_.end(), [](const auto& a, const auto& b) {
+            return a.usage.Total() > b.usage.Total(); });
+    }
+
+    static void accumulate(TextEditor::MemoryUsage& into, const TextEditor::MemoryUsage& m)
+    {
+        into.buffer += m.buffer;
+        into.undo += m.undo;
+        into.tokens_by_line += m.tokens_by_line;
+        into.line_token_cache += m.line_token_cache;
+        into.token_cache += m.token_cache;
+        into.semantic += m.semantic;
+        into.translation_unit += m.translation_unit;
+        into.mapped += m.mapped;
+    }
+
+    static void row(const char* name, const TextEditor::MemoryUsage& m)
+    {
+        const size_t cells[] = { m.Total(), m.buffer, m.undo, m.tokens_by_line,
+            m.line_token_cache, m.token_cache, m.semantic, m.translation_unit, m.mapped };
+        ImGui::TableNextRow();
+        ImGui::TableNextColumn();
+        ImGui::TextUnformatted(name);
+        for (size_t bytes : cells) {
+            ImGui::TableNextColumn();
+            ImGui::TextUnformatted(formatBytes(bytes).c_str());
+        }
+    }
+
+    static std::string formatBytes(size_t bytes)
+    {
+        char buf[32];
+        if (bytes >= (size_t(1) << 30))      std::snprintf(buf, sizeof buf, "%.2f GB", bytes / double(1 << 30));
+        else if (bytes >= (size_t(1) << 20)) std::snprintf(buf, sizeof buf, "%.1f MB", bytes / double(1 << 20));
+        else if (bytes >= (size_t(1) << 10)) std::snprintf(buf, sizeof buf, "%.1f KB", bytes / double(1 << 10));
+        else                                 std::snprintf(buf, sizeof buf, "%zu B", bytes);
+        return buf;
+    }
+};
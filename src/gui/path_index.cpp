@@ -0,0 +1,119 @@
+// path_index.cpp
+#include "path_index.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+
+#include <gui/directory_model.h>   // pathToUtf8
+#include <editor/fuzzy_match.h>
+
+namespace fs = std::filesystem;
+
+void PathIndex::rebuild(const fs::path& root)
+{
+    if (building()) return;   // the running walk is fresh enough
+    m_pending = std::async(std::launch::async, [root] { return build(root); });
+}
+
+bool PathIndex::poll()
+{
+    if (!m_pending.valid() ||
+        m_pending.wait_for(std::chrono::seconds(0)) != std::future_status::ready)
+        return false;
+    m_data = m_pending.get();
+    return true;
+}
+
+std::string_view PathIndex::path(std::uint32_t i) const
+{
+    return std::string_view(m_data.text).substr(m_data.offsets[i], m_data.offsets[i + 1] - m_data.offsets[i]);
+}
+
+fs::path PathIndex::absolute(std::uint32_t i) const
+{
+    std::string_view rel = path(i);
+#if defined(__cpp_char8_t)
+    return m_data.root / fs::path(std::u8string(rel.begin(), rel.end()));
+#else
+    return m_data.root / fs::u8path(rel);
+#endif
+}
+
+PathIndex::Data PathIndex::build(fs::path root)
+{
+    Data data;
+    data.root = root;
+    data.offsets.push_back(0);
+
+    std::error_code ec;
+    fs::recursive_directory_iterator it(root, fs::directory_options::skip_permission_denied, ec), end;
+    if (ec) {
+        std::fprintf(stderr, "[PathIndex] cannot walk %s: %s\n", pathToUtf8(root).c_str(), ec.message().c_str());
+        return data;
+    }
+
+    for (; it != end; it.increment(ec)) {
+        if (ec) { ec.clear(); continue; }
+
+        const fs::path& p = it->path();
+        std::string name = pathToUtf8(p.filename());
+        if (it->is_directory(ec)) {
+            // .git, .vs, .cache and friends are never what you are looking for
+            if (!name.empty() && name[0] == '.') it.disable_recursion_pending();
+            continue;
+        }
+        if (!it->is_regular_file(ec)) continue;
+
+        std::string rel = pathToUtf8(p.lexically_relative(root));
+        std::replace(rel.begin(), rel.end(), '\\', '/');
+        data.nameStart.push_back(static_cast<std::uint32_t>(rel.size() - name.size()));
+        data.text += rel;
+        data.offsets.push_back(static_cast<std::uint32_t>(data.text.size()));
+    }
+
+    data.lowered = fuzzyLower(data.text);
+    data.masks.reserve(data.nameStart.size());
+    for (std::size_t i = 0; i + 1 < data.offsets.size(); ++i)
+        data.masks.push_back(fuzzyMask(std::string_view(data.lowered)
+            .substr(data.offsets[i], data.offsets[i + 1] - data.offsets[i])));
+    return data;
+}
+
+std::vector<PathIndex::Match> PathIndex::query(std::string_view text, std::size_t limit) const
+{
+    std::vector<Match> out;
+    const std::uint32_t n = static_cast<std::uint32_t>(size());
+
+    std::string q = fuzzyLower(text);
+    q.erase(std::remove(q.begin(), q.end(), ' '), q.end());
+    std::replace(q.begin(), q.end(), '\\', '/');
+
+    if (q.empty()) {
+        for (std::uint32_t i = 0; i < n && out.size() < limit; ++i)
+            out.push_back({ i, 0 });
+        return out;
+    }
+
+    const std::uint64_t qmask = fuzzyMask(q);
+    const std::string_view all(m_data.text), allLowered(m_data.lowered);
+    for (std::uint32_t i = 0; i < n; ++i) {
+        if (!fuzzyMaskCovers(m_data.masks[i], qmask)) continue;
+
+        const std::uint32_t off = m_data.offsets[i], len = m_data.offsets[i + 1] - off;
+        int score = fuzzyScore(q, all.substr(off, len), allLowered.substr(off, len), m_data.nameStart[i]);
+        if (score != kFuzzyNoMatch) out.push_back({ i, score });
+    }
+
+    auto better = [this](const Match& a, const Match& b) {
+        if (a.score != b.score) return a.score > b.score;
+        return path(a.index).size() < path(b.index).size();
+    };
+    if (out.size() > limit) {
+        std::partial_sort(out.begin(), out.begin() + limit, out.end(), better);
+        out.resize(limit);
+    }
+    else {
+        std::sort(out.begin(), out.end(), better);
+    }
+    return out;
+}
@@ -0,0 +1,50 @@
+// path_index.h
+#pragma once
+#include <cstdint>
+#include <filesystem>
+#include <future>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// Every file under a workspace root, flattened for the "Go to File"
+// palette.  Paths are stored relative to the root, UTF-8, '/'-separated,
+// back to back in one arena with a lowered copy and a fuzzyMask() per
+// entry, so a query over 200k paths is a linear scan of two arrays.
+//
+// rebuild() walks the tree on a background task; the previous index keeps
+// answering queries until poll() swaps the new one in.
+class PathIndex {
+public:
+    struct Match {
+        std::uint32_t index;
+        int           score;
+    };
+
+    void rebuild(const std::filesystem::path& root);
+    bool poll();                          // true when a new index was adopted
+    bool building() const { return m_pending.valid(); }
+
+    std::size_t size() const { return m_data.masks.size(); }
+    std::string_view path(std::uint32_t i) const;
+    std::filesystem::path absolute(std::uint32_t i) const;
+
+    // Best `limit` matches, best first; ties go to the shorter path.  An
+    // empty query lists the first `limit` paths.
+    std::vector<Match> query(std::string_view text, std::size_t limit) const;
+
+private:
+    struct Data {
+        std::filesystem::path      root;
+        std::string                text;       // all paths, back to back
+        std::string                lowered;    // fuzzyLower(text)
+        std::vector<std::uint32_t> offsets;    // size()+1 entries into text
+        std::vector<std::uint32_t> nameStart;  // offset of the file name within each path
+        std::vector<std::uint64_t> masks;
+    };
+
+    static Data build(std::filesystem::path root);
+
+    Data              m_data;
+    std::future<Data> m_pending;
+};
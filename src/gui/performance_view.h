@@ -0,0 +1,103 @@
+#pragma once
+#include <imgui.h>
+#include <algorithm>
+#include <cstdio>
+#include <functional>
+#include <unordered_map>
+#include <vector>
+
+#include <gui/frame_profiler.h>
+#include <text_editor.h>   // TextEditor::BackgroundWork
+
+/*---------------------------------------------------------------------------
+    PerformanceView – what the last frames cost, drawn inside the Inspector.
+
+    Frame-time histogram over the FrameProfiler history, CPU time of every
+    panel and TextEditor::Draw phase (last frame and a smoothed average),
+    draw list / draw call / vertex counts and the background highlight /
+    semantic queues of the open documents.
+---------------------------------------------------------------------------*/
+class PerformanceView
+{
+public:
+    using QueueFn = std::function<TextEditor::BackgroundWork()>;
+
+    void setQueueSource(QueueFn fn) { queues_ = std::move(fn); }
+
+    void draw()
+    {
+        const FrameProfiler& prof = FrameProfiler::instance();
+        drawFrameTimes(prof);
+        ImGui::Separator();
+        drawScopes(prof);
+        ImGui::Separator();
+
+        const auto& c = prof.lastDrawCounts();
+        ImGui::Text("Draw lists %zu   draw calls %zu", c.drawLists, c.drawCalls);
+        ImGui::Text("Vertices %zu   indices %zu", c.vertices, c.indices);
+
+        if (queues_) {
+            const auto q = queues_();
+            ImGui::Separator();
+            ImGui::Text("Highlight queue: %d running, %d queued", q.highlight_running, q.highlight_queued);
+            ImGui::Text("Semantic queue:  %d running, %d queued", q.semantic_running, q.semantic_queued);
+        }
+    }
+
+private:
+    QueueFn                                 queues_;
+    std::unordered_map<const char*, float>  smoothed_;   // keyed by the scope's literal
+    std::vector<float>                      sorted_;
+
+    void drawFrameTimes(const FrameProfiler& prof)
+    {
+        const auto& h = prof.history();
+        if (h.empty()) { ImGui::TextDisabled("collecting frames…"); return; }
+
+        sorted_.assign(h.begin(), h.end());
+        std::sort(sorted_.begin(), sorted_.end());
+        auto pct = [&](float p) { return sorted_[std::min(sorted_.size() - 1, static_cast<size_t>(p * sorted_.size()))]; };
+
+        char overlay[96];
+        std::snprintf(overlay, sizeof overlay, "p50 %.1f  p99 %.1f  max %.1f ms", pct(0.5f), pct(0.99f), sorted_.back());
+        const int offset = h.size() < FrameProfiler::kHistory ? 0 : static_cast<int>(prof.historyOffset());
+        ImGui::PlotHistogram("##frames", h.data(), static_cast<int>(h.size()), offset, overlay,
+            0.0f, std::max(33.4f, sorted_.back()), ImVec2(-1, 80));
+
+        // Share of frames per budget bucket
+        static constexpr float kEdges[] = { 8.4f, 16.7f, 33.4f, 50.0f };
+        int buckets[5] = {};
+        for (float ms : h)
+            ++buckets[std::upper_bound(std::begin(kEdges), std::end(kEdges), ms) - std::begin(kEdges)];
+        const float n = static_cast<float>(h.size());
+        ImGui::Text("<8ms %.0f%%  <17ms %.0f%%  <33ms %.0f%%  <50ms %.0f%%  slower %.0f%%",
+            100 * buckets[0] / n, 100 * buckets[1] / n, 100 * buckets[2] / n, 100 * buckets[3] / n, 100 * buckets[4] / n);
+        ImGui::Text("CPU this frame: %.2f ms", prof.lastCpuMs());
+    }
+
+    void drawScopes(const FrameProfiler& prof)
+    {
+        constexpr ImGuiTableFlags flags = ImGuiTableFlags_RowBg | ImGuiTableFlags_BordersInnerV;
+        if (!ImGui::BeginTable("##scopes", 3, flags)) return;
+        ImGui::TableSetupColumn("Scope", ImGuiTableColumnFlags_WidthStretch);
+        ImGui::TableSetupColumn("ms", ImGuiTableColumnFlags_WidthFixed, 60.0f);
+        ImGui::TableSetupColumn("avg", ImGuiTableColumnFlags_WidthFixed, 60.0f);
+        ImGui::TableHeadersRow();
+
+        const float indent = ImGui::GetStyle().IndentSpacing;
+        for (const auto& s : prof.lastFrame()) {
+            float& avg = smoothed_[s.name];
+            avg += (static_cast<float>(s.ms) - avg) * 0.05f;
+
+            ImGui::TableNextRow();
+            ImGui::TableNextColumn();
+            ImGui::SetCursorPosX(ImGui::GetCursorPosX() + indent * s.depth);
+            ImGui::TextUnformatted(s.name);
+            ImGui::TableNextColumn();
+            ImGui::Text("%.3f", s.ms);
+            ImGui::TableNextColumn();
+            ImGui::Text("%.3f", avg);
+        }
+        ImGui::EndTable();
+    }
+};
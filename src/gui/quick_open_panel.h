@@ -0,0 +1,114 @@
+#pragma once
+
+// ---------------------------------------------------------------------------------------------------------------------
+// "Go to File" palette (Ctrl+P): fuzzy search over every file under the workspace root
+// ---------------------------------------------------------------------------------------------------------------------
+
+#include <algorithm>
+#include <filesystem>
+#include <functional>
+#include <string>
+#include <vector>
+#include <imgui.h>
+#include <gui/path_index.h>
+
+class QuickOpenPanel
+{
+public:
+    void setOpenFileCallback(std::function<void(const std::filesystem::path&)> cb) { m_openFileCB = std::move(cb); }
+
+    // Show the palette and refresh the index in the background; until the
+    // walk finishes the previous index keeps answering.
+    void open(const std::filesystem::path& root)
+    {
+        m_openRequested = true;
+        m_index.rebuild(root);
+    }
+
+    void draw()
+    {
+        if (m_index.poll()) m_dirty = true;
+
+        if (m_openRequested)
+        {
+            m_openRequested = false;
+            m_query[0] = '\0';
+            m_dirty = true;
+            m_focusInput = true;
+            ImGui::OpenPopup(kTitle);
+        }
+
+        const ImGuiViewport* vp = ImGui::GetMainViewport();
+        ImGui::SetNextWindowPos(ImVec2(vp->WorkPos.x + vp->WorkSize.x * 0.5f, vp->WorkPos.y + vp->WorkSize.y * 0.1f),
+            ImGuiCond_Always, ImVec2(0.5f, 0.0f));
+        ImGui::SetNextWindowSize(ImVec2(std::min(700.0f, vp->WorkSize.x * 0.8f), 0.0f));
+        if (!ImGui::BeginPopup(kTitle)) return;
+
+        if (m_focusInput) { ImGui::SetKeyboardFocusHere(); m_focusInput = false; }
+        if (ImGui::InputTextWithHint("##query", "Search files by name", m_query, sizeof(m_query)))
+            m_dirty = true;
+        ImGui::SameLine();
+        if (m_index.building()) ImGui::TextDisabled("indexing...");
+        else                    ImGui::TextDisabled("%zu files", m_index.size());
+
+        if (m_dirty)
+        {
+            m_results = m_index.query(m_query, kMaxResults);
+            m_selected = 0;
+            m_dirty = false;
+        }
+
+        const int count = static_cast<int>(m_results.size());
+        bool moved = false;
+        if (count > 0 && ImGui::IsKeyPressed(ImGuiKey_DownArrow)) { m_selected = std::min(m_selected + 1, count - 1); moved = true; }
+        if (count > 0 && ImGui::IsKeyPressed(ImGuiKey_UpArrow))   { m_selected = std::max(m_selected - 1, 0);         moved = true; }
+        bool accept = count > 0 && (ImGui::IsKeyPressed(ImGuiKey_Enter) || ImGui::IsKeyPressed(ImGuiKey_KeypadEnter));
+
+        const float rowHeight = ImGui::GetTextLineHeightWithSpacing();
+        ImGui::BeginChild("##results", ImVec2(0, rowHeight * kVisibleRows), false);
+        ImGuiListClipper clipper;
+        clipper.Begin(count);
+        if (moved) clipper.IncludeItemByIndex(m_selected);   // so it can scroll into view
+        while (clipper.Step())
+        {
+            for (int i = clipper.DisplayStart; i < clipper.DisplayEnd; ++i)
+            {
+                std::string_view rel = m_index.path(m_results[i].index);
+                ImGui::PushID(i);
+                if (ImGui::Selectable("##row", i == m_selected))
+                {
+                    m_selected = i;
+                    accept = true;
+                }
+                if (moved && i == m_selected)
+                    ImGui::SetScrollHereY();
+                ImGui::SameLine(0, 0);
+                ImGui::TextUnformatted(rel.data(), rel.data() + rel.size());
+                ImGui::PopID();
+            }
+        }
+        ImGui::EndChild();
+
+        if (accept && m_selected < count)
+        {
+            std::filesystem::path target = m_index.absolute(m_results[m_selected].index);
+            ImGui::CloseCurrentPopup();
+            if (m_openFileCB) m_openFileCB(target);
+        }
+        ImGui::EndPopup();
+    }
+
+private:
+    static constexpr const char* kTitle = "Go to File";
+    static constexpr std::size_t kMaxResults = 500;
+    static constexpr float       kVisibleRows = 15.0f;
+
+    PathIndex                              m_index;
+    std::vector<PathIndex::Match>          m_results;
+    std::function<void(const std::filesystem::path&)> m_openFileCB;
+    char                                   m_query[260]{};
+    int                                    m_selected = 0;
+    bool                                   m_dirty = true;
+    bool                                   m_openRequested = false;
+    bool                                   m_focusInput = false;
+};
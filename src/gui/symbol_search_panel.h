@@ -0,0 +1,119 @@
+#pragma once
+
+// ---------------------------------------------------------------------------------------------------------------------
+// "Go to Symbol in Workspace" palette (Ctrl+T): fuzzy search over every symbol indexed so far
+// ---------------------------------------------------------------------------------------------------------------------
+
+#include <algorithm>
+#include <filesystem>
+#include <functional>
+#include <string>
+#include <vector>
+#include <imgui.h>
+#include <symbol_index.h>
+
+class SymbolSearchPanel
+{
+public:
+    using JumpFn = std::function<void(const std::string& path, int line, int column)>;
+
+    void setIndex(const SymbolIndex* index) { m_index = index; }
+    void setJumpCallback(JumpFn cb) { m_jumpCB = std::move(cb); }
+
+    void open() { m_openRequested = true; }
+
+    void draw()
+    {
+        if (!m_index) return;
+
+        if (m_openRequested)
+        {
+            m_openRequested = false;
+            m_query[0] = '\0';
+            m_results.clear();
+            m_focusInput = true;
+            ImGui::OpenPopup(kTitle);
+        }
+
+        const ImGuiViewport* vp = ImGui::GetMainViewport();
+        ImGui::SetNextWindowPos(ImVec2(vp->WorkPos.x + vp->WorkSize.x * 0.5f, vp->WorkPos.y + vp->WorkSize.y * 0.1f),
+            ImGuiCond_Always, ImVec2(0.5f, 0.0f));
+        ImGui::SetNextWindowSize(ImVec2(std::min(800.0f, vp->WorkSize.x * 0.8f), 0.0f));
+        if (!ImGui::BeginPopup(kTitle)) return;
+
+        if (m_focusInput) { ImGui::SetKeyboardFocusHere(); m_focusInput = false; }
+        // Re-run on edits, and whenever a reindex has invalidated the hits.
+        if (ImGui::InputTextWithHint("##query", "Search symbols in workspace", m_query, sizeof(m_query))
+            || m_generation != m_index->Generation())
+        {
+            m_results = m_index->Query(m_query, kMaxResults);
+            m_generation = m_index->Generation();
+            m_selected = 0;
+        }
+        ImGui::SameLine();
+        ImGui::TextDisabled("%zu symbols", m_index->size());
+
+        const int count = static_cast<int>(m_results.size());
+        bool moved = false;
+        if (count > 0 && ImGui::IsKeyPressed(ImGuiKey_DownArrow)) { m_selected = std::min(m_selected + 1, count - 1); moved = true; }
+        if (count > 0 && ImGui::IsKeyPressed(ImGuiKey_UpArrow))   { m_selected = std::max(m_selected - 1, 0);         moved = true; }
+        bool accept = count > 0 && (ImGui::IsKeyPressed(ImGuiKey_Enter) || ImGui::IsKeyPressed(ImGuiKey_KeypadEnter));
+
+        const float rowHeight = ImGui::GetTextLineHeightWithSpacing();
+        const float kindX = ImGui::GetContentRegionAvail().x * 0.45f;
+        ImGui::BeginChild("##results", ImVec2(0, rowHeight * kVisibleRows), false);
+        ImGuiListClipper clipper;
+        clipper.Begin(count);
+        if (moved) clipper.IncludeItemByIndex(m_selected);   // so it can scroll into view
+        while (clipper.Step())
+        {
+            for (int i = clipper.DisplayStart; i < clipper.DisplayEnd; ++i)
+            {
+                const SymbolIndex::Hit& hit = m_results[i];
+                std::string_view name = m_index->QualifiedName(hit);
+                std::string_view kind = m_index->Kind(hit);
+                std::string where = std::filesystem::path(m_index->File(hit)).filename().string()
+                    + ":" + std::to_string(m_index->Line(hit));
+
+                ImGui::PushID(i);
+                if (ImGui::Selectable("##row", i == m_selected))
+                {
+                    m_selected = i;
+                    accept = true;
+                }
+                if (moved && i == m_selected)
+                    ImGui::SetScrollHereY();
+                ImGui::SameLine(0, 0);
+                ImGui::TextUnformatted(name.data(), name.data() + name.size());
+                ImGui::SameLine(kindX);
+                ImGui::TextDisabled("%.*s  %s", static_cast<int>(kind.size()), kind.data(), where.c_str());
+                ImGui::PopID();
+            }
+        }
+        ImGui::EndChild();
+
+        if (accept && m_selected < count)
+        {
+            const SymbolIndex::Hit& hit = m_results[m_selected];
+            std::string path = m_index->File(hit);
+            int line = m_index->Line(hit), column = m_index->Column(hit);
+            ImGui::CloseCurrentPopup();
+            if (m_jumpCB) m_jumpCB(path, line, column);
+        }
+        ImGui::EndPopup();
+    }
+
+private:
+    static constexpr const char* kTitle = "Go to Symbol in Workspace";
+    static constexpr std::size_t kMaxResults = 200;
+    static constexpr float       kVisibleRows = 15.0f;
+
+    const SymbolIndex*             m_index = nullptr;
+    std::vector<SymbolIndex::Hit>  m_results;
+    JumpFn                         m_jumpCB;
+    uint64_t                       m_generation = 0;
+    char                           m_query[256]{};
+    int                            m_selected = 0;
+    bool                           m_openRequested = false;
+    bool                           m_focusInput = false;
+};
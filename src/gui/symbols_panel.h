@@ -2,7 +2,10 @@
 #include <imgui.h>
 
 #include <algorithm>
+#include <cassert>
 #include <cctype>
+#include <cstdint>
+#include <cstring>
 #include <functional>
 #include <string>
 #include <string_view>
@@ -17,7 +20,7 @@
       • Hierarchical tree built from fully-qualified names (split on "::").
       • Search-as-you-type filter (fuzzy substring, case-insensitive).
       • Double-click leaf or container to jump to definition (first child if container).
-      • Column with kind string; resizable; scrollable.
+      • Column with the declaration kind; resizable; scrollable.
 
     **Safety notes**
       • A dummy root node is now created in the constructor so the panel is
@@ -28,36 +31,40 @@
 ---------------------------------------------------------------------------*/
 
 struct DisplaySymbol {
-    std::string name;   // unqualified part
-    std::string kind;   // "class", "method", …
-    int         line;   // 1-based; 0 = container / unknown
-    int         column; // 1-based; 0 = container / unknown
+    std::string      name;   // unqualified part
+    std::string_view kind;   // "class", "method", … (SymbolKindName); empty for scopes
+    int              line;   // 1-based; 0 = container / unknown
+    int              column; // 1-based; 0 = container / unknown
 };
 
 class SymbolsPanel {
 public:
     using ActivateFn = std::function<void(int /*line*/, int /*column*/)>;
 
-    SymbolsPanel() { initRoot(); }
+    SymbolsPanel() { initRoot(); updateMatches(); }
 
     /*-----------------------------  Data feed  -----------------------------*/
+    // Patches the existing tree instead of rebuilding it: nodes are matched
+    // by qualified name, kind and location are diffed, vanished subtrees
+    // are dropped and only the child lists that changed are re-sorted.
+    // Open state survives, so a background reindex never resets the view.
     void setSymbols(const std::vector<Symbol>& syms)
     {
-        initRoot();               // wipe & recreate the root (index 0)
-        pathIndex_.clear();
-        pathIndex_["<file-scope>"] = 0;
+        ++stamp_;
+        nodes_[0].seen = stamp_;
+        bool changed = false;
 
         // Build a tree using the fully-qualified name (split on "::").
         for (const auto& s : syms) {
-            const std::string& full = s.name; // already owns its memory – safe for views
+            std::string_view full = s.name;   // valid for this call; nodes copy
 
             // Split qualified name
             std::vector<std::string_view> parts;
             size_t pos = 0;
             while (true) {
                 size_t next = full.find("::", pos);
-                parts.emplace_back(full.data() + pos, next == std::string::npos ? full.size() - pos : next - pos);
-                if (next == std::string::npos) break;
+                parts.emplace_back(full.data() + pos, next == std::string_view::npos ? full.size() - pos : next - pos);
+                if (next == std::string_view::npos) break;
                 pos = next + 2;
             }
 
@@ -73,32 +80,75 @@ public:
                     size_t idx = nodes_.size();
                     DisplaySymbol ds;
                     ds.name = std::string(parts[i]);
-                    ds.kind = (i + 1 == parts.size()) ? s.kind : "";
-                    ds.line = (i + 1 == parts.size()) ? s.line : 0;
-                    ds.column = (i + 1 == parts.size()) ? s.column : 0;
-                    nodes_.push_back({ std::move(ds), {} });
+                    ds.line = 0;
+                    ds.column = 0;
+                    std::string lower = toLower(ds.name);
+                    nodes_.push_back({ std::move(ds), {}, parent, std::move(lower) });
                     nodes_[parent].children.push_back(idx);
+                    nodes_[parent].sortDirty = true;
                     it->second = idx;
+                    changed = true;
+                }
+                Node& n = nodes_[it->second];
+                n.seen = stamp_;
+
+                // First declaration of a name wins, as it always has.
+                if (i + 1 == parts.size() && n.symbolSeen != stamp_) {
+                    n.symbolSeen = stamp_;
+                    const std::string_view kind = SymbolKindName(s.kind);
+                    if (n.sym.kind != kind || n.sym.line != s.line || n.sym.column != s.column) {
+                        n.sym.kind = kind;
+                        n.sym.line = s.line;
+                        n.sym.column = s.column;
+                        nodes_[n.parent].sortDirty = true;
+                        changed = true;
+                    }
                 }
                 parent = it->second;
             }
         }
 
+        // Still referenced as a scope, but its own declaration is gone.
+        for (size_t i = 1; i < nodes_.size(); ++i) {
+            Node& n = nodes_[i];
+            if (n.seen == stamp_ && n.symbolSeen != stamp_ && (!n.sym.kind.empty() || n.sym.line != 0)) {
+                n.sym.kind = {};
+                n.sym.line = 0;
+                n.sym.column = 0;
+                nodes_[n.parent].sortDirty = true;
+                changed = true;
+            }
+        }
+
+        if (removeUnseen()) changed = true;
+
         // Stable sort children by source location so tree follows file order.
         auto byLocation = [&](size_t a, size_t b) {
             const auto& sa = nodes_[a].sym;
             const auto& sb = nodes_[b].sym;
             return std::tie(sa.line, sa.column, sa.name) < std::tie(sb.line, sb.column, sb.name);
             };
-        std::function<void(size_t)> sortRec = [&](size_t n) {
-            std::sort(nodes_[n].children.begin(), nodes_[n].children.end(), byLocation);
-            for (size_t c : nodes_[n].children) sortRec(c);
-            };
-        sortRec(0);
+        for (Node& n : nodes_) {
+            if (!n.sortDirty) continue;
+            std::sort(n.children.begin(), n.children.end(), byLocation);
+            n.sortDirty = false;
+        }
+
+        if (changed) updateMatches();
     }
 
     void setActivateCallback(ActivateFn fn) { onActivate_ = std::move(fn); }
 
+    // Same as typing `text` into the filter box (scripted runs).
+    void setFilter(std::string_view text)
+    {
+        const size_t n = std::min(text.size(), sizeof(filterBuf_) - 1);
+        std::memcpy(filterBuf_, text.data(), n);
+        filterBuf_[n] = '\0';
+        filter_ = toLower(filterBuf_);
+        updateMatches();
+    }
+
     /*------------------------------  Render  -------------------------------*/
     void draw(const char* title = "Symbols")
     {
@@ -107,11 +157,11 @@ public:
         // Early-out if there’s nothing to show yet (shouldn’t happen, but safe)
         if (nodes_.empty()) { ImGui::TextUnformatted("<no symbols>"); ImGui::End(); return; }
 
-        // Search bar
-        static char filterBuf[128] = "";
-        ImGui::InputTextWithHint("##filter", "Filter symbols…", filterBuf, sizeof(filterBuf));
-        std::string filter = filterBuf;
-        std::transform(filter.begin(), filter.end(), filter.begin(), [](unsigned char c) { return (char)std::tolower(c); });
+        // Search bar: matches are recomputed only when the text changes
+        if (ImGui::InputTextWithHint("##filter", "Filter symbols…", filterBuf_, sizeof(filterBuf_))) {
+            filter_ = toLower(filterBuf_);
+            updateMatches();
+        }
 
         ImGui::Separator();
 
@@ -126,7 +176,8 @@ public:
             ImGui::TableSetupColumn("Kind", ImGuiTableColumnFlags_WidthFixed, 120.0f);
             ImGui::TableHeadersRow();
 
-            drawNodeRecursive(0, filter);
+            if (rowsDirty_) rebuildRows();
+            drawRows();
             ImGui::EndTable();
         }
 
@@ -137,31 +188,133 @@ private:
     struct Node {
         DisplaySymbol        sym;       // data for this node
         std::vector<size_t>  children;  // indices into nodes_
+        size_t               parent = 0;
+        std::string          lower;     // sym.name, lower-cased once in setSymbols
+        bool                 open = false;
+        bool                 sortDirty = false;   // children need re-sorting
+        uint32_t             seen = 0;            // last setSymbols that reached this node
+        uint32_t             symbolSeen = 0;      // ... that declared it (not just a scope)
     };
 
+    // One visible table row; rebuilt only when the filter, the symbol set
+    // or a node's open state changes.
+    struct Row {
+        size_t node;
+        int    depth;
+    };
+
+    static std::string toLower(std::string_view s)
+    {
+        std::string low(s);
+        std::transform(low.begin(), low.end(), low.begin(), [](unsigned char c) { return (char)std::tolower(c); });
+        return low;
+    }
+
     void initRoot()
     {
         nodes_.clear();
-        nodes_.push_back({ {"<file-scope>", "", 0, 0}, {} }); // root (index 0)
+        nodes_.push_back({ {"<file-scope>", "", 0, 0}, {}, 0, "<file-scope>" }); // root (index 0)
+        pathIndex_.clear();
+        pathIndex_["<file-scope>"] = 0;
+    }
+
+    // Drop nodes the last setSymbols did not reach.  Their ancestors were
+    // reached whenever they were, so whole subtrees go at once; survivors
+    // keep their relative order, which keeps children sorted and every
+    // child after its parent.
+    bool removeUnseen()
+    {
+        constexpr size_t kGone = static_cast<size_t>(-1);
+        std::vector<size_t> remap(nodes_.size(), kGone);
+        size_t alive = 0;
+        for (size_t i = 0; i < nodes_.size(); ++i)
+            if (nodes_[i].seen == stamp_) remap[i] = alive++;
+        if (alive == nodes_.size()) return false;
+
+        for (size_t i = 0; i < nodes_.size(); ++i) {
+            if (remap[i] == kGone) continue;
+            Node& n = nodes_[i];
+            n.parent = remap[n.parent];
+            size_t w = 0;
+            for (size_t c : n.children)
+                if (remap[c] != kGone) n.children[w++] = remap[c];
+            n.children.resize(w);
+            if (remap[i] != i) nodes_[remap[i]] = std::move(n);
+        }
+        nodes_.resize(alive);
+
+        for (auto it = pathIndex_.begin(); it != pathIndex_.end();) {
+            if (remap[it->second] == kGone) it = pathIndex_.erase(it);
+            else { it->second = remap[it->second]; ++it; }
+        }
+        return true;
     }
 
-    void drawNodeRecursive(size_t idx, const std::string& filter)
+    // A node is shown if it or any descendant matches.  Children always
+    // have larger indices than their parent, so one backward pass settles
+    // every subtree in O(n).
+    void updateMatches()
+    {
+        visible_.assign(nodes_.size(), filter_.empty() ? 1 : 0);
+        if (!filter_.empty()) {
+            for (size_t i = nodes_.size(); i-- > 0;) {
+                if (!visible_[i] && nodes_[i].lower.find(filter_) != std::string::npos)
+                    visible_[i] = 1;
+                if (visible_[i] && i != 0)
+                    visible_[nodes_[i].parent] = 1;
+            }
+        }
+        rowsDirty_ = true;
+    }
+
+    void rebuildRows()
+    {
+        rows_.clear();
+        if (!nodes_.empty() && visible_[0]) appendRows(0, 0);
+        rowsDirty_ = false;
+    }
+
+    void appendRows(size_t idx, int depth)
+    {
+        rows_.push_back({ idx, depth });
+        if (!nodes_[idx].open) return;
+        for (size_t c : nodes_[idx].children)
+            if (visible_[c]) appendRows(c, depth + 1);
+    }
+
+    void drawRows()
+    {
+        const float indent = ImGui::GetStyle().IndentSpacing;
+
+        ImGuiListClipper clipper;
+        clipper.Begin(static_cast<int>(rows_.size()));
+        while (clipper.Step()) {
+            for (int r = clipper.DisplayStart; r < clipper.DisplayEnd; ++r)
+                drawNode(rows_[r].node, rows_[r].depth * indent);
+        }
+        clipper.End();
+    }
+
+    void drawNode(size_t idx, float indent)
     {
         assert(idx < nodes_.size());
-        const Node& n = nodes_[idx];
+        Node& n = nodes_[idx];
         const bool isLeaf = n.children.empty();
 
-        // Filter: skip subtrees that don’t match.
-        if (!filter.empty() && !nodeMatches(idx, filter))
-            return;
-
         ImGui::TableNextRow();
         ImGui::TableNextColumn();
+        ImGui::SetCursorPosX(ImGui::GetCursorPosX() + indent);
 
-        ImGuiTreeNodeFlags flags = ImGuiTreeNodeFlags_SpanFullWidth | ImGuiTreeNodeFlags_FramePadding;
-        if (isLeaf) flags |= ImGuiTreeNodeFlags_Leaf | ImGuiTreeNodeFlags_NoTreePushOnOpen;
+        ImGuiTreeNodeFlags flags = ImGuiTreeNodeFlags_SpanFullWidth | ImGuiTreeNodeFlags_FramePadding
+                                 | ImGuiTreeNodeFlags_NoTreePushOnOpen;
+        if (isLeaf) flags |= ImGuiTreeNodeFlags_Leaf;
 
-        bool open = ImGui::TreeNodeEx((void*)(intptr_t)idx, flags, "%s", n.sym.name.c_str());
+        if (!isLeaf) ImGui::SetNextItemOpen(n.open);
+        ImGui::TreeNodeEx((void*)(intptr_t)idx, flags, "%s", n.sym.name.c_str());
+        if (!isLeaf && ImGui::IsItemToggledOpen()) {
+            n.open = !n.open;
+            rowsDirty_ = true;      // takes effect next frame; rows_ stays valid for this one
+        }
 
         if (ImGui::IsItemHovered() && ImGui::IsMouseDoubleClicked(ImGuiMouseButton_Left) && onActivate_) {
             const DisplaySymbol* target = &n.sym;
@@ -175,29 +328,17 @@ private:
         }
 
         ImGui::TableNextColumn();
-        ImGui::TextUnformatted(n.sym.kind.c_str());
-
-        if (!isLeaf && open) {
-            for (size_t c : n.children) drawNodeRecursive(c, filter);
-            ImGui::TreePop();
-        }
-    }
-
-    bool nodeMatches(size_t idx, const std::string& filter) const
-    {
-        const auto& name = nodes_[idx].sym.name;
-        std::string low;
-        low.resize(name.size());
-        std::transform(name.begin(), name.end(), low.begin(), [](unsigned char c) { return (char)std::tolower(c); });
-        if (low.find(filter) != std::string::npos)
-            return true;
-        for (size_t c : nodes_[idx].children)
-            if (nodeMatches(c, filter))
-                return true;
-        return false;
+        ImGui::TextUnformatted(n.sym.kind.data(), n.sym.kind.data() + n.sym.kind.size());
     }
 
     std::vector<Node>                       nodes_;      // flat storage (0 = root)
     std::unordered_map<std::string, size_t> pathIndex_;
+    uint32_t                                stamp_ = 0;  // bumped by every setSymbols
     ActivateFn                               onActivate_{};
-};
\ No newline at end of file
+
+    char                                    filterBuf_[128] = "";
+    std::string                             filter_;     // lower-cased filterBuf_
+    std::vector<uint8_t>                    visible_;    // per node: it or a descendant matches
+    std::vector<Row>                        rows_;
+    bool                                    rowsDirty_ = true;
+};
@@ -16,15 +16,19 @@ public:
 	{
 	}
     std::function<void()> onNewProject;
+    std::function<void()> onGoToFile;
+    std::function<void()> onGoToSymbol;
     std::function<void()> onSaveAll;
     std::function<void()> onExit;
     std::function<void()> onUndo;
     std::function<void()> onRedo;
+    std::function<void()> onTogglePerformance;
+    std::function<void()> onToggleMemory;
 
     // New: pending dock requests (pop back)
     std::vector<std::pair<std::string, ImGuiID>> pendingRedocks;
 
-    void draw(const std::unordered_map<std::string, ImGuiID>& dockTargets,
+    void draw(const std::unordered_map<std::string, ImGuiID>& /*dockTargets*/,
         const char* titleText = "My IDE (v1.5)")
     {
         if (!ImGui::BeginMainMenuBar())
@@ -37,6 +41,8 @@ public:
         {
             if (ImGui::MenuItem("New Project\tCtrl+Shift+N")) if (onNewProject) onNewProject();
 			if (ImGui::MenuItem("Open Folder\tCtrl+O"))           onOpenFolder();
+            if (ImGui::MenuItem("Go to File...\tCtrl+P"))  if (onGoToFile)   onGoToFile();
+            if (ImGui::MenuItem("Go to Symbol...\tCtrl+T")) if (onGoToSymbol) onGoToSymbol();
             ImGui::Separator();
             if (ImGui::MenuItem("Save All\tCtrl+Shift+S")) if (onSaveAll)    onSaveAll();
             ImGui::Separator();
@@ -51,6 +57,13 @@ public:
             ImGui::EndMenu();
         }
 
+        if (ImGui::BeginMenu("View"))
+        {
+            if (ImGui::MenuItem("Performance\tF12")) if (onTogglePerformance) onTogglePerformance();
+            if (ImGui::MenuItem("Memory"))           if (onToggleMemory)      onToggleMemory();
+            ImGui::EndMenu();
+        }
+
         ImGui::EndMainMenuBar();
     }
 private:
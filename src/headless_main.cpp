@@ -0,0 +1,121 @@
+// headless_main.cpp
+//
+// mut_headless: drives the editor core (mut_core) without a window or an
+// ImGui context, so the buffer, highlighting and indexing paths can be run
+// and timed on any platform.
+//
+//   mut_headless <file> [--type TEXT] [--repeat N] [--trace out.json]
+//
+// Opens <file> the way a tab does, waits for the first highlight and
+// semantic pass, then optionally types TEXT at the start of the file N
+// times (one keystroke per code point) and waits for the editor to settle.
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <memory>
+#include <string>
+#include <thread>
+
+#include "editor/clang_indexer.h"
+#include "editor/syntax_highlighter.h"
+#include "editor/text_editor.h"
+#include "editor/utf8.h"
+#include "platform/trace.h"
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+double msSince(Clock::time_point start)
+{
+    return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+}
+
+// Pump the editor like the frame loop would until no job is in flight.
+void settle(TextEditor& editor)
+{
+    editor.Update();
+    while (editor.HasPendingWork()) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        editor.Update();
+    }
+}
+
+int usage()
+{
+    std::fprintf(stderr, "usage: mut_headless <file> [--type TEXT] [--repeat N] [--trace out.json]\n");
+    return 2;
+}
+
+} // namespace
+
+int main(int argc, char** argv)
+{
+    trace::setThreadName("main");
+
+    std::string path, typed, tracePath;
+    int repeat = 1;
+    for (int i = 1; i < argc; ++i) {
+        const bool hasValue = i + 1 < argc;
+        if (!std::strcmp(argv[i], "--type") && hasValue)        typed = argv[++i];
+        else if (!std::strcmp(argv[i], "--repeat") && hasValue) repeat = std::max(1, std::atoi(argv[++i]));
+        else if (!std::strcmp(argv[i], "--trace") && hasValue)  tracePath = argv[++i];
+        else if (argv[i][0] != '-' && path.empty())             path = argv[i];
+        else return usage();
+    }
+    if (path.empty()) return usage();
+
+    std::error_code ec;
+    if (!std::filesystem::is_regular_file(path, ec)) {
+        std::fprintf(stderr, "[Headless] '%s' is not a readable file\n", path.c_str());
+        return 1;
+    }
+
+    const std::string ext = std::filesystem::path(path).extension().string();
+    SyntaxHighlighter highlighter(ext == ".c" ? "c" : "cpp");
+    ClangIndexer      indexer;
+
+    auto start = Clock::now();
+    auto editor = std::make_unique<TextEditor>(path, highlighter, indexer);
+    const double openMs = msSince(start);
+    settle(*editor);
+    const double readyMs = msSince(start);
+
+    std::printf("file:            %s\n", path.c_str());
+    std::printf("lines:           %zu%s\n", editor->LineCount(), editor->IsLargeFile() ? " (large-file mode)" : "");
+    std::printf("open:            %.3f ms\n", openMs);
+    std::printf("first pass:      %.3f ms\n", readyMs);
+    std::printf("tokens:          %zu\n", editor->TokenCount());
+    std::printf("semantic kinds:  %zu\n", editor->SemanticKindCount());
+
+    if (!typed.empty()) {
+        editor->MoveCursorTo(0, 0);
+        size_t keystrokes = 0;
+        double typingMs = 0;
+        start = Clock::now();
+        for (int r = 0; r < repeat; ++r) {
+            auto t = Clock::now();
+            editor->TypeText(typed);
+            typingMs += msSince(t);
+            keystrokes += Utf8CountCodepoints(typed);
+            editor->Update();
+        }
+        settle(*editor);
+        const double totalMs = msSince(start);
+
+        std::printf("keystrokes:      %zu\n", keystrokes);
+        std::printf("edit paths:      %.3f ms (%.3f us/keystroke)\n", typingMs, typingMs * 1000.0 / keystrokes);
+        std::printf("until settled:   %.3f ms\n", totalMs);
+        std::printf("tokens:          %zu\n", editor->TokenCount());
+    }
+
+    editor.reset();
+    ClangIndexer::Cleanup();
+
+    if (!tracePath.empty() && !trace::writeChromeJson(tracePath))
+        return 1;
+    return 0;
+}
@@ -5,11 +5,19 @@
 #include <shellscalingapi.h>
 #include "platform/platform_window.h"
 #include "platform/dpi_manager.h"
+#include "platform/trace.h"
+#include "editor/input_trace.h"
 #include "gui/gui_layer.h"
 #include <imgui.h>
+#include <cstdlib>
 
 int main()
 {
+    trace::setThreadName("main");
+    // MUT_INPUT_TRACE=keys.trace records the first edited document for mut_replay
+    const char* inputTracePath = std::getenv("MUT_INPUT_TRACE");
+    if (inputTracePath)
+        InputRecorder::Start();
     SetProcessDpiAwarenessContext(DPI_AWARENESS_CONTEXT_PER_MONITOR_AWARE_V2);
     if (!glfwInit()) return -1;
 
@@ -42,6 +50,12 @@ int main()
     gui.shutdown();
     delete dpi;
     glfwTerminate();
+
+    // MUT_TRACE_FILE=trace.json keeps the session's trace for chrome://tracing / Perfetto
+    if (const char* tracePath = std::getenv("MUT_TRACE_FILE"))
+        trace::writeChromeJson(tracePath);
+    if (inputTracePath)
+        InputRecorder::Stop(inputTracePath);
     return 0;
 }
 
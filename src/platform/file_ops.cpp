@@ -0,0 +1,373 @@
+// file_ops.cpp
+#include "file_ops.h"
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+
+#if defined(_WIN32)
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#elif defined(__linux__)
+#include <fcntl.h>
+#include <sys/sendfile.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace fs = std::filesystem;
+
+namespace {
+    constexpr std::size_t kChunk = 8u << 20;   // cancellation / progress granularity
+
+#if !defined(_WIN32)
+    // Copies land here and are renamed over the target once complete: an
+    // existing target is never truncated in place, which would pull the
+    // bytes out from under anyone mapping it (an open editor tab), and a
+    // failed copy leaves it untouched.  Windows refuses to truncate a
+    // mapped file, so CopyFileEx writes the target directly.
+    fs::path partialPath(const fs::path& to)
+    {
+        return to.parent_path() / ("." + to.filename().string() + ".part");
+    }
+#endif
+}
+
+FileOperationQueue::FileOperationQueue(unsigned workers)
+{
+    for (unsigned i = 0; i < std::max(1u, workers); ++i)
+        m_workers.emplace_back(&FileOperationQueue::run, this);
+}
+
+FileOperationQueue::~FileOperationQueue()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stopping = true;
+        m_queue.clear();
+        for (auto& op : m_active) op->cancel = true;
+    }
+    m_wake.notify_all();
+    for (auto& t : m_workers) t.join();
+}
+
+std::uint64_t FileOperationQueue::enqueue(Kind kind, const fs::path& from, const fs::path& to)
+{
+    auto op = std::make_shared<Op>();
+    op->kind = kind;
+    op->source = from;
+    op->dest = to;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        op->id = m_nextId++;
+        m_queue.push_back(op);
+        m_active.push_back(op);
+    }
+    m_wake.notify_one();
+    return op->id;
+}
+
+std::uint64_t FileOperationQueue::copy(const fs::path& from, const fs::path& to) { return enqueue(Kind::Copy, from, to); }
+std::uint64_t FileOperationQueue::move(const fs::path& from, const fs::path& to) { return enqueue(Kind::Move, from, to); }
+std::uint64_t FileOperationQueue::remove(const fs::path& path)                   { return enqueue(Kind::Delete, path, {}); }
+
+void FileOperationQueue::cancel(std::uint64_t id)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    auto it = std::find_if(m_active.begin(), m_active.end(),
+        [id](const std::shared_ptr<Op>& op) { return op->id == id; });
+    if (it == m_active.end()) return;
+
+    Op& op = **it;
+    op.cancel = true;
+    if (op.running) return;   // the worker notices between chunks
+
+    // Still queued: never started, report it right away.
+    m_queue.erase(std::find(m_queue.begin(), m_queue.end(), *it));
+    Status s = statusOf(op);
+    s.cancelled = true;
+    m_finished.push_back(std::move(s));
+    m_active.erase(it);
+}
+
+FileOperationQueue::Status FileOperationQueue::statusOf(const Op& op)
+{
+    Status s;
+    s.id = op.id;
+    s.kind = op.kind;
+    s.source = op.source;
+    s.dest = op.dest;
+    s.done = op.done;
+    s.total = op.total;
+    s.running = op.running;
+    return s;
+}
+
+std::vector<FileOperationQueue::Status> FileOperationQueue::active() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    std::vector<Status> out;
+    out.reserve(m_active.size());
+    for (auto& op : m_active)
+        out.push_back(statusOf(*op));
+    return out;
+}
+
+std::vector<FileOperationQueue::Status> FileOperationQueue::takeFinished()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    std::vector<Status> out;
+    out.swap(m_finished);
+    return out;
+}
+
+void FileOperationQueue::run()
+{
+    for (;;) {
+        std::shared_ptr<Op> op;
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_wake.wait(lock, [this] { return m_stopping || !m_queue.empty(); });
+            if (m_stopping) return;
+            op = m_queue.front();
+            m_queue.pop_front();
+            op->running = true;
+        }
+
+        try {
+            switch (op->kind) {
+            case Kind::Copy:   runCopy(*op);   break;
+            case Kind::Move:   runMove(*op);   break;
+            case Kind::Delete: runDelete(*op); break;
+            }
+        }
+        catch (const fs::filesystem_error& err) {
+            op->error = err.what();
+        }
+        std::lock_guard<std::mutex> lock(m_mutex);
+        op->running = false;
+        Status s = statusOf(*op);
+        s.cancelled = op->error.empty() && op->cancel;
+        s.error = op->error;
+        m_finished.push_back(std::move(s));
+        m_active.erase(std::find(m_active.begin(), m_active.end(), op));
+    }
+}
+
+// ───────────────────────────── operations ─────────────────────────────
+
+void FileOperationQueue::runCopy(Op& op)
+{
+    if (!fs::is_directory(op.source)) {
+        op.total = fs::file_size(op.source);
+        copyFile(op, op.source, op.dest);
+        return;
+    }
+
+    std::uint64_t total = 0;
+    for (auto& e : fs::recursive_directory_iterator(op.source)) {
+        if (op.cancel) return;
+        std::error_code ec;
+        if (!e.is_symlink(ec) && e.is_regular_file(ec)) total += e.file_size(ec);
+    }
+    op.total = total;
+    copyTree(op, op.source, op.dest);
+}
+
+void FileOperationQueue::copyTree(Op& op, const fs::path& from, const fs::path& to)
+{
+    fs::create_directories(to);
+    for (auto& e : fs::directory_iterator(from)) {
+        if (op.cancel || !op.error.empty()) return;
+
+        fs::path target = to / e.path().filename();
+        if (e.is_symlink()) {
+            if (fs::exists(fs::symlink_status(target))) fs::remove(target);
+            fs::copy_symlink(e.path(), target);
+        }
+        else if (e.is_directory()) copyTree(op, e.path(), target);
+        else if (e.is_regular_file()) copyFile(op, e.path(), target);
+    }
+}
+
+void FileOperationQueue::runMove(Op& op)
+{
+    std::error_code ec;
+    fs::rename(op.source, op.dest, ec);
+    if (!ec) return;
+    if (ec != std::errc::cross_device_link) {
+        op.error = "rename " + op.source.string() + ": " + ec.message();
+        return;
+    }
+
+    // Different volume: copy, and only drop the source once the copy is whole.
+    runCopy(op);
+    if (op.cancel || !op.error.empty()) return;
+    fs::remove_all(op.source);
+}
+
+void FileOperationQueue::runDelete(Op& op)
+{
+    if (!fs::is_directory(fs::symlink_status(op.source))) {
+        op.total = 1;
+        fs::remove(op.source);
+        op.done = 1;
+        return;
+    }
+
+    // Children come after their parents, so deleting back to front never
+    // meets a non-empty directory.
+    std::vector<fs::path> entries;
+    for (auto& e : fs::recursive_directory_iterator(op.source)) {
+        if (op.cancel) return;
+        entries.push_back(e.path());
+    }
+    op.total = entries.size() + 1;
+
+    for (auto it = entries.rbegin(); it != entries.rend(); ++it) {
+        if (op.cancel) return;
+        fs::remove(*it);
+        ++op.done;
+    }
+    fs::remove(op.source);
+    ++op.done;
+}
+
+// ─────────────────────────── single file copy ──────────────────────────
+
+#if defined(_WIN32)
+
+namespace {
+    struct CopyProgress {
+        std::atomic<std::uint64_t>* done;
+        std::uint64_t               base;
+        std::atomic<bool>*          cancel;
+    };
+
+    DWORD CALLBACK onCopyProgress(LARGE_INTEGER, LARGE_INTEGER transferred, LARGE_INTEGER, LARGE_INTEGER,
+                                  DWORD, DWORD, HANDLE, HANDLE, LPVOID data)
+    {
+        auto* p = static_cast<CopyProgress*>(data);
+        *p->done = p->base + static_cast<std::uint64_t>(transferred.QuadPart);
+        return *p->cancel ? PROGRESS_CANCEL : PROGRESS_CONTINUE;
+    }
+}
+
+bool FileOperationQueue::copyFile(Op& op, const fs::path& from, const fs::path& to)
+{
+    CopyProgress progress{ &op.done, op.done.load(), &op.cancel };
+    if (CopyFileExW(from.c_str(), to.c_str(), onCopyProgress, &progress, nullptr, 0))
+        return true;
+
+    DWORD err = GetLastError();
+    if (err != ERROR_REQUEST_ABORTED)
+        op.error = "copy " + from.string() + ": " + std::system_category().message(static_cast<int>(err));
+    return false;
+}
+
+#elif defined(__linux__)
+
+bool FileOperationQueue::copyFile(Op& op, const fs::path& from, const fs::path& to)
+{
+    auto fail = [&](const char* what) {
+        op.error = std::string(what) + " " + from.string() + ": " + std::strerror(errno);
+        return false;
+    };
+
+    int in = ::open(from.c_str(), O_RDONLY | O_CLOEXEC);
+    if (in < 0) return fail("open");
+    struct stat st {};
+    ::fstat(in, &st);
+    const fs::path part = partialPath(to);
+    int out = ::open(part.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, st.st_mode & 07777);
+    if (out < 0) { int e = errno; ::close(in); errno = e; return fail("create"); }
+
+    // In-kernel copies first; each step down keeps the file offsets where
+    // the previous one stopped.
+    enum { kRange, kSendfile, kReadWrite } mode = kRange;
+    std::vector<char> buffer;
+    bool ok = true;
+
+    while (!op.cancel) {
+        ssize_t n = 0;
+        if (mode == kRange) {
+            n = ::copy_file_range(in, nullptr, out, nullptr, kChunk, 0);
+            if (n < 0 && (errno == ENOSYS || errno == EXDEV || errno == EINVAL || errno == EOPNOTSUPP)) {
+                mode = kSendfile;
+                continue;
+            }
+        }
+        else if (mode == kSendfile) {
+            n = ::sendfile(out, in, nullptr, kChunk);
+            if (n < 0 && (errno == ENOSYS || errno == EINVAL)) {
+                mode = kReadWrite;
+                continue;
+            }
+        }
+        else {
+            if (buffer.empty()) buffer.resize(1u << 20);
+            n = ::read(in, buffer.data(), buffer.size());
+            for (ssize_t off = 0; n > 0 && off < n;) {
+                ssize_t w = ::write(out, buffer.data() + off, static_cast<std::size_t>(n - off));
+                if (w < 0) { if (errno == EINTR) continue; n = -1; break; }
+                off += w;
+            }
+        }
+
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            ok = fail("copy");
+            break;
+        }
+        if (n == 0) break;   // EOF
+        op.done += static_cast<std::uint64_t>(n);
+    }
+
+    ::close(in);
+    if (::close(out) != 0 && ok) ok = fail("close");
+    if (op.cancel) ok = false;
+    if (ok && ::rename(part.c_str(), to.c_str()) != 0) ok = fail("rename");
+    if (!ok) {
+        std::error_code ec;
+        fs::remove(part, ec);   // no half-written files left behind
+    }
+    return ok;
+}
+
+#else
+
+bool FileOperationQueue::copyFile(Op& op, const fs::path& from, const fs::path& to)
+{
+    std::FILE* in = std::fopen(from.c_str(), "rb");
+    if (!in) { op.error = "open " + from.string() + ": " + std::strerror(errno); return false; }
+    const fs::path part = partialPath(to);
+    std::FILE* out = std::fopen(part.c_str(), "wb");
+    if (!out) { op.error = "create " + to.string() + ": " + std::strerror(errno); std::fclose(in); return false; }
+
+    std::vector<char> buffer(1u << 20);
+    bool ok = true;
+    while (!op.cancel) {
+        std::size_t n = std::fread(buffer.data(), 1, buffer.size(), in);
+        if (n == 0) { ok = !std::ferror(in); break; }
+        if (std::fwrite(buffer.data(), 1, n, out) != n) { ok = false; break; }
+        op.done += n;
+    }
+    if (!ok) op.error = "copy " + from.string() + ": " + std::strerror(errno);
+
+    std::fclose(in);
+    if (std::fclose(out) != 0 && ok) { ok = false; op.error = "close " + to.string(); }
+    if (op.cancel) ok = false;
+    if (ok) {
+        std::error_code ec;
+        fs::rename(part, to, ec);
+        if (ec) { ok = false; op.error = "rename " + to.string() + ": " + ec.message(); }
+    }
+    if (!ok) {
+        std::error_code ec;
+        fs::remove(part, ec);
+    }
+    return ok;
+}
+
+#endif
@@ -0,0 +1,82 @@
+// file_ops.h
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <filesystem>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Copies, moves and deletes files off the UI thread.
+//
+// Operations run on a small pool of workers, report progress through
+// active(), can be cancelled between chunks, and are handed back through
+// takeFinished() so the caller can refresh whatever views they touched.
+// Regular files are copied in chunks with copy_file_range / sendfile on
+// Linux and CopyFileExW on Windows; other platforms use read/write.
+class FileOperationQueue {
+public:
+    enum class Kind { Copy, Move, Delete };
+
+    struct Status {
+        std::uint64_t         id = 0;
+        Kind                  kind = Kind::Copy;
+        std::filesystem::path source;
+        std::filesystem::path dest;       // empty for Delete
+        std::uint64_t         done = 0;   // bytes for Copy/Move, entries for Delete
+        std::uint64_t         total = 0;
+        bool                  running = false;
+        bool                  cancelled = false;
+        std::string           error;      // empty on success
+    };
+
+    explicit FileOperationQueue(unsigned workers = 2);
+    ~FileOperationQueue();   // cancels whatever is left and joins the workers
+    FileOperationQueue(const FileOperationQueue&) = delete;
+    FileOperationQueue& operator=(const FileOperationQueue&) = delete;
+
+    // Existing destinations are overwritten, like fs::copy_options::overwrite_existing.
+    std::uint64_t copy(const std::filesystem::path& from, const std::filesystem::path& to);
+    std::uint64_t move(const std::filesystem::path& from, const std::filesystem::path& to);
+    std::uint64_t remove(const std::filesystem::path& path);
+
+    void cancel(std::uint64_t id);
+
+    std::vector<Status> active() const;    // queued and running, oldest first
+    std::vector<Status> takeFinished();    // completed since the last call
+
+private:
+    struct Op {
+        std::uint64_t              id = 0;
+        Kind                       kind = Kind::Copy;
+        std::filesystem::path      source, dest;
+        std::atomic<std::uint64_t> done{ 0 };
+        std::atomic<std::uint64_t> total{ 0 };
+        std::atomic<bool>          cancel{ false };
+        bool                       running = false;    // guarded by m_mutex
+        std::string                error;              // worker-only until it reports
+    };
+
+    std::uint64_t enqueue(Kind kind, const std::filesystem::path& from, const std::filesystem::path& to);
+    void run();
+    static Status statusOf(const Op& op);
+
+    static void runCopy(Op& op);
+    static void runMove(Op& op);
+    static void runDelete(Op& op);
+    static void copyTree(Op& op, const std::filesystem::path& from, const std::filesystem::path& to);
+    static bool copyFile(Op& op, const std::filesystem::path& from, const std::filesystem::path& to);
+
+    mutable std::mutex                m_mutex;
+    std::condition_variable           m_wake;
+    std::deque<std::shared_ptr<Op>>   m_queue;
+    std::vector<std::shared_ptr<Op>>  m_active;      // queued + running
+    std::vector<Status>               m_finished;
+    std::uint64_t                     m_nextId = 1;
+    bool                              m_stopping = false;
+    std::vector<std::thread>          m_workers;
+};
@@ -0,0 +1,176 @@
+// fs_watcher.cpp
+#include "fs_watcher.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <vector>
+
+#ifdef __linux__
+#include <poll.h>
+#include <sys/inotify.h>
+#include <unistd.h>
+#endif
+
+namespace fs = std::filesystem;
+
+FsWatcher::FsWatcher(Callback onChange)
+    : m_onChange(std::move(onChange))
+{
+#ifdef __linux__
+    m_fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    m_native = (m_fd >= 0);
+    if (!m_native)
+        std::fprintf(stderr, "[FsWatcher] inotify unavailable, directories will not refresh\n");
+#endif
+    m_thread = std::thread(&FsWatcher::run, this);
+}
+
+FsWatcher::~FsWatcher()
+{
+    m_running = false;
+    if (m_thread.joinable()) m_thread.join();
+#ifdef __linux__
+    if (m_fd >= 0) ::close(m_fd);
+#endif
+}
+
+void FsWatcher::notifyAll()
+{
+    std::vector<fs::path> dirs;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+#ifdef __linux__
+        for (auto& [path, wd] : m_byPath) dirs.push_back(path);
+#else
+        for (auto& [path, stamp] : m_stamps) dirs.push_back(path);
+#endif
+    }
+    for (auto& d : dirs) m_onChange(d);
+}
+
+#ifdef __linux__
+// ───────────────────────────── inotify ──────────────────────────────
+
+void FsWatcher::watch(const fs::path& dir)
+{
+    if (m_fd < 0) return;
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (m_byPath.contains(dir)) return;
+
+    int wd = inotify_add_watch(m_fd, dir.c_str(),
+        IN_CREATE | IN_DELETE | IN_MOVED_FROM | IN_MOVED_TO |
+        IN_DELETE_SELF | IN_MOVE_SELF | IN_ONLYDIR);
+    if (wd < 0) {
+        std::fprintf(stderr, "[FsWatcher] cannot watch %s\n", dir.c_str());
+        return;
+    }
+    m_byWatch[wd] = dir;
+    m_byPath[dir] = wd;
+}
+
+void FsWatcher::unwatch(const fs::path& dir)
+{
+    if (m_fd < 0) return;
+    std::lock_guard<std::mutex> lock(m_mutex);
+    auto it = m_byPath.find(dir);
+    if (it == m_byPath.end()) return;
+    inotify_rm_watch(m_fd, it->second);
+    m_byWatch.erase(it->second);
+    m_byPath.erase(it);
+}
+
+void FsWatcher::run()
+{
+    if (m_fd < 0) return;
+
+    alignas(inotify_event) char buf[16 * 1024];
+    while (m_running) {
+        pollfd pfd{ m_fd, POLLIN, 0 };
+        if (::poll(&pfd, 1, 200) <= 0) continue;   // wake up to check m_running
+
+        ssize_t len = ::read(m_fd, buf, sizeof(buf));
+        if (len <= 0) continue;
+
+        // Coalesce: one callback per directory per read() batch.
+        std::vector<fs::path> changed;
+        bool overflow = false;
+        for (char* p = buf; p < buf + len;) {
+            auto* ev = reinterpret_cast<inotify_event*>(p);
+            p += sizeof(inotify_event) + ev->len;
+
+            if (ev->mask & IN_Q_OVERFLOW) { overflow = true; continue; }
+
+            std::lock_guard<std::mutex> lock(m_mutex);
+            auto it = m_byWatch.find(ev->wd);
+            if (it == m_byWatch.end()) continue;
+
+            fs::path dir = it->second;
+            if (ev->mask & IN_IGNORED) {          // watch removed by the kernel
+                m_byPath.erase(dir);
+                m_byWatch.erase(it);
+            }
+            // A vanished directory changes its parent's listing as well.
+            if (ev->mask & (IN_DELETE_SELF | IN_MOVE_SELF))
+                changed.push_back(dir.parent_path());
+            if (std::find(changed.begin(), changed.end(), dir) == changed.end())
+                changed.push_back(dir);
+        }
+
+        if (overflow) notifyAll();
+        for (auto& d : changed) m_onChange(d);
+    }
+}
+
+#else
+// ───────────────────────── polling fallback ─────────────────────────
+
+void FsWatcher::watch(const fs::path& dir)
+{
+    std::error_code ec;
+    auto stamp = fs::last_write_time(dir, ec);
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_stamps.emplace(dir, ec ? fs::file_time_type{} : stamp);
+}
+
+void FsWatcher::unwatch(const fs::path& dir)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_stamps.erase(dir);
+}
+
+void FsWatcher::run()
+{
+    using namespace std::chrono_literals;
+    while (m_running) {
+        // Sleep in short steps so the destructor never waits long.
+        for (int i = 0; i < 10 && m_running; ++i)
+            std::this_thread::sleep_for(100ms);
+
+        std::vector<fs::path> dirs;
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            for (auto& [path, stamp] : m_stamps) dirs.push_back(path);
+        }
+
+        // A directory's mtime moves whenever an entry is added, removed or
+        // renamed, which is all the file tree cares about.
+        for (auto& d : dirs) {
+            std::error_code ec;
+            auto now = fs::last_write_time(d, ec);
+            if (ec) now = fs::file_time_type{};
+
+            bool changed = false;
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                auto it = m_stamps.find(d);
+                if (it != m_stamps.end() && it->second != now) {
+                    it->second = now;
+                    changed = true;
+                }
+            }
+            if (changed) m_onChange(d);
+        }
+    }
+}
+
+#endif
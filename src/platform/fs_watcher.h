@@ -0,0 +1,44 @@
+// fs_watcher.h
+#pragma once
+#include <atomic>
+#include <filesystem>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <thread>
+
+// Watches individual directories (non-recursive) for entries being added,
+// removed or renamed.  Linux uses inotify; everywhere else a background
+// thread polls each watched directory's modification time.  The callback
+// runs on the watcher thread and receives the directory that changed.
+class FsWatcher {
+public:
+    using Callback = std::function<void(const std::filesystem::path& dir)>;
+
+    explicit FsWatcher(Callback onChange);
+    ~FsWatcher();
+    FsWatcher(const FsWatcher&) = delete;
+    FsWatcher& operator=(const FsWatcher&) = delete;
+
+    void watch(const std::filesystem::path& dir);
+    void unwatch(const std::filesystem::path& dir);
+    bool isNative() const { return m_native; }
+
+private:
+    void run();
+    void notifyAll();
+
+    Callback          m_onChange;
+    std::atomic<bool> m_running{ true };
+    bool              m_native = false;
+    std::mutex        m_mutex;
+    std::thread       m_thread;
+
+#ifdef __linux__
+    int                                  m_fd = -1;
+    std::map<int, std::filesystem::path> m_byWatch;   // inotify wd -> dir
+    std::map<std::filesystem::path, int> m_byPath;
+#else
+    std::map<std::filesystem::path, std::filesystem::file_time_type> m_stamps;
+#endif
+};
@@ -0,0 +1,56 @@
+// log_ring.cpp
+#include "log_ring.h"
+#include <algorithm>
+#include <bit>
+#include <cstring>
+
+LogRing::LogRing(std::size_t cellCount)
+{
+    const std::size_t n = std::bit_ceil(std::max(cellCount, kMaxCells));
+    m_cells = std::make_unique<Cell[]>(n);
+    m_mask = n - 1;
+    for (std::size_t i = 0; i < n; ++i)
+        m_cells[i].seq.store(i, std::memory_order_relaxed);
+}
+
+bool LogRing::push(std::string_view message)
+{
+    message = message.substr(0, kMaxCells * kPayload);
+    const std::size_t cells = std::max<std::size_t>(1, (message.size() + kPayload - 1) / kPayload);
+
+    // Reserve `cells` consecutive cells (Vyukov's bounded queue, widened to
+    // a run of cells): all of them must be free on this lap.
+    std::uint64_t pos = m_head.load(std::memory_order_relaxed);
+    for (;;) {
+        bool full = false, raced = false;
+        for (std::size_t i = 0; i < cells; ++i) {
+            const std::uint64_t seq = m_cells[(pos + i) & m_mask].seq.load(std::memory_order_acquire);
+            const std::int64_t  dif = static_cast<std::int64_t>(seq - (pos + i));
+            if (dif < 0) { full = true; break; }     // consumer has not freed it yet
+            if (dif > 0) { raced = true; break; }    // another producer got here first
+        }
+        if (full) {
+            m_dropped.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+        if (raced) {
+            pos = m_head.load(std::memory_order_relaxed);
+            continue;
+        }
+        if (m_head.compare_exchange_weak(pos, pos + cells, std::memory_order_relaxed))
+            break;
+    }
+
+    // Fill, then publish last-to-first (see drain()).
+    for (std::size_t i = 0; i < cells; ++i) {
+        Cell& c = m_cells[(pos + i) & m_mask];
+        const std::size_t off = i * kPayload;
+        const std::size_t len = std::min(kPayload, message.size() - std::min(off, message.size()));
+        if (len) std::memcpy(c.data, message.data() + off, len);
+        c.length = static_cast<std::uint16_t>(len);
+        c.more = (i + 1 < cells);
+    }
+    for (std::size_t i = cells; i-- > 0;)
+        m_cells[(pos + i) & m_mask].seq.store(pos + i + 1, std::memory_order_release);
+    return true;
+}
@@ -0,0 +1,82 @@
+// log_ring.h
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <string_view>
+
+// Bounded multi-producer / single-consumer queue of log messages.
+//
+// Any thread may push(); it never blocks and never allocates.  A message
+// occupies one or more fixed-size cells reserved with a single CAS, so a
+// message is never interleaved with another.  When the ring is full the
+// message is dropped and counted instead of stalling the producer.  The
+// owner drains on its own thread (the UI thread, once per frame).
+class LogRing {
+public:
+    explicit LogRing(std::size_t cellCount = 16384);   // rounded up to a power of two
+    LogRing(const LogRing&) = delete;
+    LogRing& operator=(const LogRing&) = delete;
+
+    bool push(std::string_view message);   // false: dropped, the ring was full
+
+    // Hand every complete message to `sink(std::string_view)`, oldest
+    // first.  Consumer thread only.  Returns the number of messages.
+    template <class Sink>
+    std::size_t drain(Sink&& sink);
+
+    std::uint64_t dropped() const { return m_dropped.load(std::memory_order_relaxed); }
+
+private:
+    static constexpr std::size_t kCellSize = 128;
+    static constexpr std::size_t kMaxCells = 64;   // longer messages are cut
+
+    struct alignas(kCellSize) Cell {
+        std::atomic<std::uint64_t> seq;
+        std::uint16_t              length;
+        std::uint8_t               more;       // message continues in the next cell
+        char                       data[kCellSize - sizeof(std::atomic<std::uint64_t>) - 3];
+    };
+    static constexpr std::size_t kPayload = sizeof(Cell::data);
+
+    std::unique_ptr<Cell[]>    m_cells;
+    std::size_t                m_mask;
+    alignas(64) std::atomic<std::uint64_t> m_head{ 0 };   // next cell producers reserve
+    alignas(64) std::uint64_t  m_tail = 0;                // next cell the consumer reads
+    std::atomic<std::uint64_t> m_dropped{ 0 };
+    std::string                m_scratch;                 // reassembles multi-cell messages
+};
+
+template <class Sink>
+std::size_t LogRing::drain(Sink&& sink)
+{
+    std::size_t count = 0;
+    for (;;) {
+        // Producers publish a message's cells last-to-first, so once the
+        // first cell is visible the rest are too.
+        Cell& first = m_cells[m_tail & m_mask];
+        if (first.seq.load(std::memory_order_acquire) != m_tail + 1) break;
+
+        std::size_t cells = 1;
+        if (!first.more) {
+            sink(std::string_view(first.data, first.length));
+        }
+        else {
+            m_scratch.clear();
+            for (;; ++cells) {
+                Cell& c = m_cells[(m_tail + cells - 1) & m_mask];
+                m_scratch.append(c.data, c.length);
+                if (!c.more) break;
+            }
+            sink(std::string_view(m_scratch));
+        }
+
+        for (std::size_t i = 0; i < cells; ++i)
+            m_cells[(m_tail + i) & m_mask].seq.store(m_tail + i + m_mask + 1, std::memory_order_release);
+        m_tail += cells;
+        ++count;
+    }
+    return count;
+}
@@ -0,0 +1,50 @@
+// null_backend.cpp
+#include "null_backend.h"
+#include <imgui.h>
+
+void NullBackend::init(float width, float height, float frameSeconds)
+{
+    m_width = width;
+    m_height = height;
+    m_delta = frameSeconds;
+
+    ImGuiIO& io = ImGui::GetIO();
+    io.BackendPlatformName = "null";
+    io.BackendRendererName = "null";
+    // Like the OpenGL3 backend: draw lists may exceed 64k vertices.
+    io.BackendFlags |= ImGuiBackendFlags_RendererHasVtxOffset;
+
+    // The atlas still has to exist for layout; any non-zero id will do.
+    unsigned char* pixels = nullptr;
+    int w = 0, h = 0;
+    io.Fonts->GetTexDataAsRGBA32(&pixels, &w, &h);
+    io.Fonts->SetTexID(static_cast<ImTextureID>(1));
+}
+
+void NullBackend::shutdown()
+{
+    ImGuiIO& io = ImGui::GetIO();
+    io.BackendPlatformName = nullptr;
+    io.BackendRendererName = nullptr;
+    io.BackendFlags &= ~ImGuiBackendFlags_RendererHasVtxOffset;
+}
+
+void NullBackend::newFrame()
+{
+    ImGuiIO& io = ImGui::GetIO();
+    io.DisplaySize = ImVec2(m_width, m_height);
+    io.DisplayFramebufferScale = ImVec2(1.0f, 1.0f);
+    io.DeltaTime = m_delta;
+}
+
+NullBackend::DrawCounts NullBackend::render(const ImDrawData* data)
+{
+    DrawCounts counts;
+    if (!data) return counts;
+    counts.drawLists = static_cast<std::size_t>(data->CmdListsCount);
+    counts.vertices = static_cast<std::size_t>(data->TotalVtxCount);
+    counts.indices = static_cast<std::size_t>(data->TotalIdxCount);
+    for (const ImDrawList* list : data->CmdLists)
+        counts.drawCalls += static_cast<std::size_t>(list->CmdBuffer.Size);
+    return counts;
+}
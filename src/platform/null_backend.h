@@ -0,0 +1,31 @@
+// null_backend.h
+#pragma once
+#include <cstddef>
+
+struct ImDrawData;
+
+// ImGui platform + renderer backend that has no window and draws nothing.
+//
+// newFrame() feeds ImGuiIO a fixed display size and frame delta, so every
+// run lays out identically; render() walks the draw data and only counts
+// it.  Used by mut_frames to time GuiLayer::render() in CI.
+class NullBackend {
+public:
+    struct DrawCounts {
+        std::size_t drawLists = 0;
+        std::size_t drawCalls = 0;   // ImDrawCmd count
+        std::size_t vertices = 0;
+        std::size_t indices = 0;
+    };
+
+    // Call after ImGui::CreateContext().  Builds the font atlas in memory
+    // (nothing is uploaded) and claims the backend slots in ImGuiIO.
+    void init(float width, float height, float frameSeconds = 1.0f / 60.0f);
+    void shutdown();
+
+    void       newFrame();                        // before ImGui::NewFrame()
+    DrawCounts render(const ImDrawData* data);    // after ImGui::Render()
+
+private:
+    float m_width = 0, m_height = 0, m_delta = 0;
+};
@@ -2,6 +2,8 @@
 #pragma once
 #include <filesystem>
 #include <optional>
+
+#if defined(_WIN32)
 #include <shobjidl.h>   // IFileOpenDialog
 #include <windows.h>
 
@@ -44,3 +46,13 @@ inline std::optional<std::filesystem::path> PickFolder(HWND owner = nullptr)
     if (comInitHere) CoUninitialize();
     return std::nullopt;                                // user cancelled
 }
+
+#else
+
+// No native folder dialog off Windows yet; behaves like a cancelled dialog.
+inline std::optional<std::filesystem::path> PickFolder()
+{
+    return std::nullopt;
+}
+
+#endif
@@ -0,0 +1,384 @@
+// trace.cpp
+#include "trace.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+namespace trace {
+namespace {
+
+constexpr std::size_t kCapacity = 4096;   // events per thread ring, power of two
+constexpr unsigned    kMaxArgs = 8;
+
+// One slot of a thread ring.  Fixed size so recording is a single slot
+// write; string arguments are copied into `text`, truncated if need be.
+struct Event {
+    std::uint64_t start;
+    std::uint64_t duration;
+    const char*   category;
+    const char*   name;
+    const char*   fmt;
+    std::uint32_t tid;
+    std::uint16_t textUsed;
+    std::uint8_t  level;
+    char          phase;
+    std::uint8_t  argc;
+    std::uint8_t  types[kMaxArgs];
+    std::uint64_t args[kMaxArgs];     // kString: offset << 32 | length into text
+    char          text[256 - 64 - kMaxArgs * 8];
+};
+static_assert(sizeof(Event) == 256);
+
+// A ring is written only by the thread that holds it; the lock is taken
+// by the exporter, so recording only ever sees it uncontended.  Rings
+// outlive their threads and are handed to the next new thread, which keeps
+// short-lived workers (std::async, pools) from allocating one each.
+struct ThreadBuffer {
+    std::mutex         lock;
+    std::vector<Event> events = std::vector<Event>(kCapacity);
+    std::uint64_t      written = 0;
+};
+
+struct Registry {
+    std::mutex                                 lock;
+    std::vector<std::unique_ptr<ThreadBuffer>> buffers;
+    std::vector<ThreadBuffer*>                 idle;
+    std::unordered_map<std::uint32_t, std::string> names;
+    std::uint32_t                              nextTid = 1;
+};
+
+Registry& registry()
+{
+    static Registry* r = new Registry;   // leaked: threads may record during static destruction
+    return *r;
+}
+
+struct ThreadSlot {
+    ThreadBuffer* buffer = nullptr;
+    std::uint32_t tid = 0;
+
+    ~ThreadSlot()
+    {
+        if (!buffer) return;
+        Registry& r = registry();
+        std::lock_guard lock(r.lock);
+        r.idle.push_back(buffer);
+    }
+};
+
+thread_local ThreadSlot t_slot;
+
+std::uint32_t currentTid()
+{
+    if (!t_slot.tid) {
+        Registry& r = registry();
+        std::lock_guard lock(r.lock);
+        t_slot.tid = r.nextTid++;
+    }
+    return t_slot.tid;
+}
+
+ThreadBuffer& currentBuffer()
+{
+    if (!t_slot.buffer) {
+        currentTid();
+        Registry& r = registry();
+        std::lock_guard lock(r.lock);
+        if (!r.idle.empty()) {
+            t_slot.buffer = r.idle.back();
+            r.idle.pop_back();
+        }
+        else {
+            r.buffers.push_back(std::make_unique<ThreadBuffer>());
+            t_slot.buffer = r.buffers.back().get();
+        }
+    }
+    return *t_slot.buffer;
+}
+
+const std::chrono::steady_clock::time_point g_epoch = std::chrono::steady_clock::now();
+
+Level levelFromEnv()
+{
+    const char* v = std::getenv("MUT_TRACE");
+    if (!v) return Level::Info;
+    std::string s = v;
+    if (s == "off" || s == "0")     return Level::Off;
+    if (s == "error" || s == "1")   return Level::Error;
+    if (s == "info" || s == "2")    return Level::Info;
+    if (s == "debug" || s == "3")   return Level::Debug;
+    if (s == "verbose" || s == "4") return Level::Verbose;
+    std::fprintf(stderr, "[Trace] Unknown MUT_TRACE level '%s', using info\n", v);
+    return Level::Info;
+}
+
+/*──────────────────────── export ────────────────────────*/
+
+const char* levelName(std::uint8_t level)
+{
+    switch (static_cast<Level>(level)) {
+    case Level::Error:   return "error";
+    case Level::Info:    return "info";
+    case Level::Debug:   return "debug";
+    case Level::Verbose: return "verbose";
+    default:             return "off";
+    }
+}
+
+void appendJsonString(std::string& out, std::string_view s)
+{
+    out += '"';
+    for (unsigned char c : s) {
+        switch (c) {
+        case '"':  out += "\\\""; break;
+        case '\\': out += "\\\\"; break;
+        case '\n': out += "\\n"; break;
+        case '\r': out += "\\r"; break;
+        case '\t': out += "\\t"; break;
+        default:
+            if (c < 0x20) {
+                char buf[8];
+                std::snprintf(buf, sizeof buf, "\\u%04x", c);
+                out += buf;
+            }
+            else {
+                out += static_cast<char>(c);
+            }
+        }
+    }
+    out += '"';
+}
+
+// printf-style formatting over the recorded arguments.  Each conversion is
+// handed to snprintf on its own with the length modifier normalised to the
+// width the argument was stored at.
+std::string formatMessage(const Event& e)
+{
+    std::string out;
+    if (!e.fmt) return out;
+
+    unsigned next = 0;
+    auto takeInt = [&](long long& v) {
+        if (next >= e.argc) return false;
+        v = e.types[next] == detail::kDouble ? static_cast<long long>(std::bit_cast<double>(e.args[next]))
+                                             : static_cast<long long>(e.args[next]);
+        ++next;
+        return true;
+    };
+
+    char buf[512];
+    for (const char* p = e.fmt; *p; ++p) {
+        if (*p != '%') { out += *p; continue; }
+        if (p[1] == '%') { out += '%'; ++p; continue; }
+
+        std::string spec = "%";
+        const char* q = p + 1;
+        while (*q && std::strchr("-+ #0", *q)) spec += *q++;
+        auto number = [&] {
+            if (*q == '*') {
+                long long v = 0;
+                takeInt(v);
+                spec += std::to_string(v);
+                ++q;
+            }
+            while (*q >= '0' && *q <= '9') spec += *q++;
+        };
+        number();
+        if (*q == '.') { spec += *q++; number(); }
+        while (*q && std::strchr("hljztL", *q)) ++q;
+        const char conv = *q;
+        if (!conv) break;
+        p = q;
+
+        if (next >= e.argc) { out += "<?>"; continue; }
+        const std::uint8_t  type = e.types[next];
+        const std::uint64_t bits = e.args[next++];
+        switch (conv) {
+        case 'd': case 'i':
+            spec += "lld";
+            std::snprintf(buf, sizeof buf, spec.c_str(),
+                type == detail::kDouble ? static_cast<long long>(std::bit_cast<double>(bits)) : static_cast<long long>(bits));
+            break;
+        case 'u': case 'x': case 'X': case 'o':
+            spec += "ll";
+            spec += conv;
+            std::snprintf(buf, sizeof buf, spec.c_str(),
+                type == detail::kDouble ? static_cast<unsigned long long>(std::bit_cast<double>(bits)) : static_cast<unsigned long long>(bits));
+            break;
+        case 'f': case 'F': case 'e': case 'E': case 'g': case 'G': case 'a': case 'A':
+            spec += conv;
+            std::snprintf(buf, sizeof buf, spec.c_str(),
+                type == detail::kDouble ? std::bit_cast<double>(bits)
+                : type == detail::kInt ? static_cast<double>(static_cast<std::int64_t>(bits)) : static_cast<double>(bits));
+            break;
+        case 'c':
+            spec += 'c';
+            std::snprintf(buf, sizeof buf, spec.c_str(), static_cast<int>(bits));
+            break;
+        case 'p':
+            std::snprintf(buf, sizeof buf, "0x%llx", static_cast<unsigned long long>(bits));
+            break;
+        case 's': {
+            spec += 's';
+            std::string s = type == detail::kString
+                ? std::string(e.text + (bits >> 32), static_cast<std::size_t>(bits & 0xffffffffu))
+                : std::string("<?>");
+            std::snprintf(buf, sizeof buf, spec.c_str(), s.c_str());
+            break;
+        }
+        default:
+            std::snprintf(buf, sizeof buf, "%%%c", conv);
+            break;
+        }
+        out += buf;
+    }
+    return out;
+}
+
+} // namespace
+
+namespace detail {
+    std::atomic<std::uint8_t> g_level{ static_cast<std::uint8_t>(levelFromEnv()) };
+
+    void record(Level level, char phase, const char* category, const char* name,
+                std::uint64_t start, std::uint64_t duration,
+                const char* fmt, const Arg* args, unsigned argc)
+    {
+        ThreadBuffer& b = currentBuffer();
+        std::lock_guard lock(b.lock);
+        Event& e = b.events[b.written++ & (kCapacity - 1)];
+        e.start = start;
+        e.duration = duration;
+        e.category = category;
+        e.name = name;
+        e.fmt = fmt;
+        e.tid = t_slot.tid;
+        e.level = static_cast<std::uint8_t>(level);
+        e.phase = phase;
+        e.argc = static_cast<std::uint8_t>(std::min(argc, kMaxArgs));
+        e.textUsed = 0;
+        for (unsigned i = 0; i < e.argc; ++i) {
+            e.types[i] = args[i].type;
+            if (args[i].type != kString) {
+                e.args[i] = args[i].bits;
+                continue;
+            }
+            const std::size_t room = sizeof e.text - e.textUsed;
+            const std::size_t n = std::min<std::size_t>(args[i].length, room);
+            if (n) std::memcpy(e.text + e.textUsed, reinterpret_cast<const char*>(args[i].bits), n);
+            e.args[i] = (static_cast<std::uint64_t>(e.textUsed) << 32) | n;
+            e.textUsed = static_cast<std::uint16_t>(e.textUsed + n);
+        }
+    }
+}
+
+void setLevel(Level level)
+{
+    detail::g_level.store(static_cast<std::uint8_t>(level), std::memory_order_relaxed);
+}
+
+Level level()
+{
+    return static_cast<Level>(detail::g_level.load(std::memory_order_relaxed));
+}
+
+std::uint64_t now()
+{
+    return static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now() - g_epoch).count());
+}
+
+void setThreadName(std::string_view name)
+{
+    const std::uint32_t tid = currentTid();
+    Registry& r = registry();
+    std::lock_guard lock(r.lock);
+    r.names[tid] = std::string(name);
+}
+
+std::string exportChromeJson()
+{
+    std::vector<Event> events;
+    std::vector<std::pair<std::uint32_t, std::string>> names;
+    {
+        Registry& r = registry();
+        std::lock_guard lock(r.lock);
+        for (auto& b : r.buffers) {
+            std::lock_guard bufferLock(b->lock);
+            const std::uint64_t first = b->written > kCapacity ? b->written - kCapacity : 0;
+            for (std::uint64_t i = first; i < b->written; ++i)
+                events.push_back(b->events[i & (kCapacity - 1)]);
+        }
+        names.assign(r.names.begin(), r.names.end());
+    }
+    std::stable_sort(events.begin(), events.end(),
+        [](const Event& a, const Event& b) { return a.start < b.start; });
+
+    std::string out = "{\"traceEvents\":[\n";
+    char buf[128];
+    bool firstEvent = true;
+    auto separator = [&] { if (!firstEvent) out += ",\n"; firstEvent = false; };
+
+    for (const auto& [tid, name] : names) {
+        separator();
+        std::snprintf(buf, sizeof buf, "{\"ph\":\"M\",\"name\":\"thread_name\",\"pid\":1,\"tid\":%u,\"args\":{\"name\":", tid);
+        out += buf;
+        appendJsonString(out, name);
+        out += "}}";
+    }
+    for (const Event& e : events) {
+        separator();
+        out += "{\"name\":";
+        appendJsonString(out, e.name ? e.name : "");
+        out += ",\"cat\":";
+        appendJsonString(out, e.category ? e.category : "");
+        if (e.phase == 'X')
+            std::snprintf(buf, sizeof buf, ",\"ph\":\"X\",\"ts\":%.3f,\"dur\":%.3f", e.start / 1000.0, e.duration / 1000.0);
+        else
+            std::snprintf(buf, sizeof buf, ",\"ph\":\"i\",\"s\":\"t\",\"ts\":%.3f", e.start / 1000.0);
+        out += buf;
+        std::snprintf(buf, sizeof buf, ",\"pid\":1,\"tid\":%u,\"args\":{\"level\":\"%s\"", e.tid, levelName(e.level));
+        out += buf;
+        if (e.fmt) {
+            out += ",\"msg\":";
+            appendJsonString(out, formatMessage(e));
+        }
+        out += "}}";
+    }
+    out += "\n],\"displayTimeUnit\":\"ms\"}\n";
+    return out;
+}
+
+bool writeChromeJson(const std::string& path)
+{
+    const std::string json = exportChromeJson();
+    std::FILE* f = std::fopen(path.c_str(), "wb");
+    if (!f) {
+        std::fprintf(stderr, "[Trace] Cannot open '%s' for writing\n", path.c_str());
+        return false;
+    }
+    const bool ok = std::fwrite(json.data(), 1, json.size(), f) == json.size();
+    if (std::fclose(f) != 0 || !ok) {
+        std::fprintf(stderr, "[Trace] Failed to write '%s'\n", path.c_str());
+        return false;
+    }
+    return true;
+}
+
+void clear()
+{
+    Registry& r = registry();
+    std::lock_guard lock(r.lock);
+    for (auto& b : r.buffers) {
+        std::lock_guard bufferLock(b->lock);
+        b->written = 0;
+    }
+}
+
+} // namespace trace
@@ -0,0 +1,137 @@
+// trace.h
+#pragma once
+#include <atomic>
+#include <bit>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <type_traits>
+
+// Structured tracing into per-thread binary ring buffers.
+//
+// Recording an event stores a timestamp, static category / name / format
+// pointers and the raw argument values; nothing is formatted until the
+// trace is exported as Chrome trace JSON (chrome://tracing, ui.perfetto.dev).
+// Each thread owns its ring, so recording never contends with other
+// producers; the oldest events are overwritten when a ring wraps.
+//
+// Two gates keep disabled tracing close to free:
+//   MUT_TRACE_LEVEL  compile-time ceiling; events above it are not compiled
+//   setLevel()       runtime level (initially from the MUT_TRACE environment
+//                    variable: off, error, info, debug or verbose)
+// Arguments of a filtered-out event are not evaluated.
+//
+// The format string and category / name must be string literals (or
+// otherwise outlive the trace).  String arguments are copied into the event.
+
+#ifndef MUT_TRACE_LEVEL
+#define MUT_TRACE_LEVEL 4   // Verbose
+#endif
+
+namespace trace {
+
+enum class Level : std::uint8_t { Off = 0, Error = 1, Info = 2, Debug = 3, Verbose = 4 };
+
+namespace detail {
+    extern std::atomic<std::uint8_t> g_level;
+
+    enum ArgType : std::uint8_t { kInt, kUInt, kDouble, kString };
+
+    struct Arg {
+        ArgType       type;
+        std::uint64_t bits;      // value, or for kString the source pointer
+        std::uint32_t length;    // kString only
+    };
+
+    template <class T>
+    Arg makeArg(const T& v)
+    {
+        using U = std::decay_t<T>;
+        if constexpr (std::is_same_v<U, bool>)
+            return { kUInt, static_cast<std::uint64_t>(v), 0 };
+        else if constexpr (std::is_enum_v<U>)
+            return { kInt, static_cast<std::uint64_t>(static_cast<std::int64_t>(v)), 0 };
+        else if constexpr (std::is_integral_v<U> && std::is_signed_v<U>)
+            return { kInt, static_cast<std::uint64_t>(static_cast<std::int64_t>(v)), 0 };
+        else if constexpr (std::is_integral_v<U>)
+            return { kUInt, static_cast<std::uint64_t>(v), 0 };
+        else if constexpr (std::is_floating_point_v<U>)
+            return { kDouble, std::bit_cast<std::uint64_t>(static_cast<double>(v)), 0 };
+        else if constexpr (std::is_same_v<U, const char*> || std::is_same_v<U, char*>) {
+            const char* s = v;
+            return { kString, reinterpret_cast<std::uintptr_t>(s), s ? static_cast<std::uint32_t>(std::char_traits<char>::length(s)) : 0 };
+        }
+        else if constexpr (std::is_convertible_v<const U&, std::string_view>) {
+            std::string_view s = v;
+            return { kString, reinterpret_cast<std::uintptr_t>(s.data()), static_cast<std::uint32_t>(s.size()) };
+        }
+        else if constexpr (std::is_pointer_v<U>)
+            return { kUInt, static_cast<std::uint64_t>(reinterpret_cast<std::uintptr_t>(v)), 0 };
+        else
+            static_assert(sizeof(U) == 0, "unsupported trace argument type");
+    }
+
+    void record(Level level, char phase, const char* category, const char* name,
+                std::uint64_t start, std::uint64_t duration,
+                const char* fmt, const Arg* args, unsigned argc);
+}
+
+inline bool enabled(Level level)
+{
+    return static_cast<std::uint8_t>(level) <= detail::g_level.load(std::memory_order_relaxed);
+}
+void  setLevel(Level level);
+Level level();
+
+std::uint64_t now();                          // ns on the trace clock
+void setThreadName(std::string_view name);    // shown as the track name
+
+// A point event.  fmt uses printf conversions (%d %zu %s %x %f ...).
+template <class... Args>
+void instant(Level level, const char* category, const char* name, const char* fmt = nullptr, const Args&... args)
+{
+    const detail::Arg packed[sizeof...(Args) + 1] = { detail::makeArg(args)... };
+    detail::record(level, 'i', category, name, now(), 0, fmt, packed, sizeof...(Args));
+}
+
+// Records a duration event covering its own lifetime.
+class Scope {
+public:
+    Scope(Level level, const char* category, const char* name)
+        : m_level(level), m_category(category), m_name(name),
+          m_active(level != Level::Off && enabled(level)), m_start(m_active ? now() : 0) {}
+    ~Scope()
+    {
+        if (m_active)
+            detail::record(m_level, 'X', m_category, m_name, m_start, now() - m_start, nullptr, nullptr, 0);
+    }
+    Scope(const Scope&) = delete;
+    Scope& operator=(const Scope&) = delete;
+
+private:
+    Level         m_level;
+    const char*   m_category;
+    const char*   m_name;
+    bool          m_active;
+    std::uint64_t m_start;
+};
+
+// Every thread's surviving events as {"traceEvents":[...]}, oldest first.
+std::string exportChromeJson();
+bool        writeChromeJson(const std::string& path);   // false + stderr message on failure
+void        clear();
+
+} // namespace trace
+
+#define MUT_TRACE_CONCAT_(a, b) a##b
+#define MUT_TRACE_CONCAT(a, b)  MUT_TRACE_CONCAT_(a, b)
+
+#define MUT_TRACE(lvl, category, name, ...)                                            \
+    do {                                                                               \
+        if constexpr (static_cast<int>(lvl) <= MUT_TRACE_LEVEL)                        \
+            if (::trace::enabled(lvl)) ::trace::instant(lvl, category, name, ##__VA_ARGS__); \
+    } while (0)
+
+#define MUT_TRACE_SCOPE(lvl, category, name)                                           \
+    ::trace::Scope MUT_TRACE_CONCAT(mut_trace_scope_, __LINE__)(                       \
+        static_cast<int>(lvl) <= MUT_TRACE_LEVEL ? (lvl) : ::trace::Level::Off, category, name)
@@ -0,0 +1,291 @@
+// replay_main.cpp
+//
+// mut_replay: measures what typing feels like – the time from a keystroke
+// until its text is coloured (highlight) and until semantic colouring
+// catches up – by replaying a recorded input trace headlessly.
+//
+//   mut_replay <trace> [--speed F] [--frame-ms N] [--out latency.json]
+//   mut_replay --make <source> <trace> --type TEXT [--cps N] [--at LINE]
+//
+// Traces are recorded by the GUI (MUT_INPUT_TRACE=keys.trace) or made
+// synthetically with --make, which types TEXT into <source> at N
+// keystrokes per second.  The replayer restores the recorded buffer, feeds
+// every event through TextEditor's edit paths at its recorded time (scaled
+// by --speed; 0 replays back to back) and pumps the editor every --frame-ms
+// like the frame loop would.  A keystroke counts as highlighted once a
+// highlight result for its content version (or a later one) is applied,
+// and likewise for semantics.
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "editor/clang_indexer.h"
+#include "editor/input_trace.h"
+#include "editor/syntax_highlighter.h"
+#include "editor/text_editor.h"
+#include "editor/utf8.h"
+#include "platform/trace.h"
+
+namespace fs = std::filesystem;
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+struct Keystroke {
+    uint64_t          version = 0;
+    Clock::time_point at;
+    double            highlight_ms = -1;   // -1: not observed
+    double            semantic_ms = -1;
+};
+
+double msBetween(Clock::time_point a, Clock::time_point b)
+{
+    return std::chrono::duration<double, std::milli>(b - a).count();
+}
+
+// Applies finished jobs and stamps every keystroke whose version is now
+// covered.  Versions only grow, so each list resolves front to back.
+class LatencyTracker {
+public:
+    explicit LatencyTracker(TextEditor& editor) : editor_(editor) {}
+
+    void add(uint64_t version, Clock::time_point at) { keys_.push_back({ version, at }); }
+
+    void pump()
+    {
+        editor_.Update();
+        const auto now = Clock::now();
+        for (; nextHighlight_ < keys_.size() && keys_[nextHighlight_].version <= editor_.HighlightedVersion(); ++nextHighlight_)
+            keys_[nextHighlight_].highlight_ms = msBetween(keys_[nextHighlight_].at, now);
+        for (; nextSemantic_ < keys_.size() && keys_[nextSemantic_].version <= editor_.SemanticVersion(); ++nextSemantic_)
+            keys_[nextSemantic_].semantic_ms = msBetween(keys_[nextSemantic_].at, now);
+    }
+
+    bool done(bool semantics) const
+    {
+        return nextHighlight_ == keys_.size() && (!semantics || nextSemantic_ == keys_.size());
+    }
+
+    const std::vector<Keystroke>& keys() const { return keys_; }
+
+private:
+    TextEditor&            editor_;
+    std::vector<Keystroke> keys_;
+    size_t                 nextHighlight_ = 0;
+    size_t                 nextSemantic_ = 0;
+};
+
+struct Summary {
+    size_t count = 0, missing = 0;
+    double p50 = 0, p90 = 0, p99 = 0, max = 0;
+};
+
+Summary summarize(const std::vector<Keystroke>& keys, double Keystroke::* field)
+{
+    std::vector<double> v;
+    Summary s;
+    for (const auto& k : keys) {
+        if (k.*field < 0) ++s.missing;
+        else v.push_back(k.*field);
+    }
+    s.count = v.size();
+    if (v.empty()) return s;
+    std::sort(v.begin(), v.end());
+    auto at = [&](double p) { return v[std::min(v.size() - 1, static_cast<size_t>(std::ceil(p * v.size())) - 1)]; };
+    s.p50 = at(0.50);
+    s.p90 = at(0.90);
+    s.p99 = at(0.99);
+    s.max = v.back();
+    return s;
+}
+
+void printSummary(const char* label, const Summary& s)
+{
+    if (!s.count) {
+        std::printf("%-18s no results (%zu keystrokes never resolved)\n", label, s.missing);
+        return;
+    }
+    std::printf("%-18s p50 %8.3f ms   p90 %8.3f ms   p99 %8.3f ms   max %8.3f ms", label, s.p50, s.p90, s.p99, s.max);
+    if (s.missing) std::printf("   (%zu unresolved)", s.missing);
+    std::printf("\n");
+}
+
+std::string summaryJson(const Summary& s)
+{
+    char buf[256];
+    std::snprintf(buf, sizeof buf,
+        "{\"count\": %zu, \"unresolved\": %zu, \"p50\": %.3f, \"p90\": %.3f, \"p99\": %.3f, \"max\": %.3f}",
+        s.count, s.missing, s.p50, s.p90, s.p99, s.max);
+    return buf;
+}
+
+bool writeJson(const std::string& path, const std::vector<Keystroke>& keys, const Summary& hl, const Summary& sem)
+{
+    std::string out = "{\n  \"unit\": \"ms\",\n  \"highlight\": " + summaryJson(hl)
+        + ",\n  \"semantic\": " + summaryJson(sem) + ",\n  \"keystrokes\": [";
+    for (size_t i = 0; i < keys.size(); ++i) {
+        char buf[128];
+        std::snprintf(buf, sizeof buf, "%s\n    [%.3f, %.3f]", i ? "," : "", keys[i].highlight_ms, keys[i].semantic_ms);
+        out += buf;
+    }
+    out += "\n  ]\n}\n";
+
+    std::ofstream file(path, std::ios::binary);
+    if (!(file << out)) {
+        std::fprintf(stderr, "[Replay] Cannot write '%s'\n", path.c_str());
+        return false;
+    }
+    return true;
+}
+
+// --make: a trace of TEXT typed at the start of line `line` of `source`.
+int makeTrace(const std::string& source, const std::string& tracePath, const std::string& text, double cps, int line)
+{
+    std::ifstream in(source, std::ios::binary);
+    if (!in) {
+        std::fprintf(stderr, "[Replay] Cannot read '%s'\n", source.c_str());
+        return 1;
+    }
+    InputTrace trace;
+    trace.path = source;
+    trace.content.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+
+    const uint64_t stepUs = static_cast<uint64_t>(1e6 / std::max(0.1, cps));
+    int col = 0;
+    for (size_t i = 0; i < text.size(); i = Utf8NextBoundary(text, i)) {
+        InputEvent e;
+        e.time_us = trace.events.size() * stepUs;
+        e.line = line;
+        e.column = col;
+        if (text[i] == '\n') {
+            e.kind = InputEvent::Kind::Enter;
+            ++line;
+            col = 0;
+        }
+        else {
+            e.kind = InputEvent::Kind::Char;
+            e.codepoint = Utf8Decode(text, i);
+            col += static_cast<int>(Utf8NextBoundary(text, i) - i);
+        }
+        trace.events.push_back(std::move(e));
+    }
+    if (!trace.Save(tracePath)) return 1;
+    std::printf("wrote %zu events to %s\n", trace.events.size(), tracePath.c_str());
+    return 0;
+}
+
+int usage()
+{
+    std::fprintf(stderr,
+        "usage: mut_replay <trace> [--speed F] [--frame-ms N] [--out latency.json]\n"
+        "       mut_replay --make <source> <trace> --type TEXT [--cps N] [--at LINE]\n");
+    return 2;
+}
+
+} // namespace
+
+int main(int argc, char** argv)
+{
+    trace::setThreadName("main");
+
+    std::vector<std::string> positional;
+    std::string outPath, typed;
+    double speed = 1.0, cps = 10.0;
+    int frameMs = 1, atLine = 0;
+    bool make = false;
+    for (int i = 1; i < argc; ++i) {
+        const bool hasValue = i + 1 < argc;
+        if (!std::strcmp(argv[i], "--make"))                      make = true;
+        else if (!std::strcmp(argv[i], "--speed") && hasValue)    speed = std::max(0.0, std::atof(argv[++i]));
+        else if (!std::strcmp(argv[i], "--frame-ms") && hasValue) frameMs = std::max(0, std::atoi(argv[++i]));
+        else if (!std::strcmp(argv[i], "--out") && hasValue)      outPath = argv[++i];
+        else if (!std::strcmp(argv[i], "--type") && hasValue)     typed = argv[++i];
+        else if (!std::strcmp(argv[i], "--cps") && hasValue)      cps = std::atof(argv[++i]);
+        else if (!std::strcmp(argv[i], "--at") && hasValue)       atLine = std::max(0, std::atoi(argv[++i]));
+        else if (argv[i][0] != '-')                               positional.push_back(argv[i]);
+        else return usage();
+    }
+
+    if (make) {
+        if (positional.size() != 2 || typed.empty()) return usage();
+        return makeTrace(positional[0], positional[1], typed, cps, atLine);
+    }
+    if (positional.size() != 1) return usage();
+
+    InputTrace input;
+    if (!InputTrace::Load(positional[0], input)) {
+        std::fprintf(stderr, "[Replay] '%s' is not a readable input trace\n", positional[0].c_str());
+        return 1;
+    }
+
+    // The editor opens files from disk: restore the recorded buffer into a
+    // temporary file with the original extension (it picks the language).
+    const fs::path original(input.path);
+    const fs::path sourcePath = fs::temp_directory_path() / ("mut_replay_" + original.stem().string() + original.extension().string());
+    std::ofstream(sourcePath, std::ios::binary) << input.content;
+
+    const bool isC = original.extension() == ".c";
+    SyntaxHighlighter highlighter(isC ? "c" : "cpp");
+    ClangIndexer      indexer;
+    auto editor = std::make_unique<TextEditor>(sourcePath.string(), highlighter, indexer);
+
+    // Start from a fully coloured buffer, as a user would.
+    editor->Update();
+    while (editor->HasPendingWork()) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        editor->Update();
+    }
+
+    LatencyTracker tracker(*editor);
+    const bool semantics = !editor->IsLargeFile();
+    const auto frame = std::chrono::milliseconds(frameMs);
+    const auto start = Clock::now();
+    for (const auto& event : input.events) {
+        if (speed > 0) {
+            const auto due = start + std::chrono::microseconds(static_cast<int64_t>(event.time_us / speed));
+            while (Clock::now() < due) {
+                tracker.pump();
+                std::this_thread::sleep_until(std::min(due, Clock::now() + frame));
+            }
+        }
+        const auto at = Clock::now();
+        editor->ApplyInput(event);
+        tracker.add(editor->ContentVersion(), at);
+        tracker.pump();
+    }
+
+    // Let the last highlight and the debounced semantic pass land.
+    const auto deadline = Clock::now() + std::chrono::seconds(60);
+    while (!tracker.done(semantics) && Clock::now() < deadline) {
+        std::this_thread::sleep_for(frame);
+        tracker.pump();
+    }
+    const double totalMs = msBetween(start, Clock::now());
+
+    const Summary hl = summarize(tracker.keys(), &Keystroke::highlight_ms);
+    const Summary sem = summarize(tracker.keys(), &Keystroke::semantic_ms);
+    std::printf("trace:             %s (%s)\n", positional[0].c_str(), input.path.c_str());
+    std::printf("keystrokes:        %zu over %.3f ms\n", tracker.keys().size(), totalMs);
+    printSummary("edit -> highlight:", hl);
+    if (semantics) printSummary("edit -> semantic:", sem);
+
+    editor.reset();
+    ClangIndexer::Cleanup();
+    std::error_code ec;
+    fs::remove(sourcePath, ec);
+
+    if (!outPath.empty() && !writeJson(outPath, tracker.keys(), hl, sem))
+        return 1;
+    return 0;
+}